@@ -0,0 +1,51 @@
+#include "AllocationCounter.h"
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace
+{
+    std::atomic<size_t> allocations(0);
+
+    void *Allocate(size_t size)
+    {
+        ++allocations;
+
+        if (void *p = std::malloc(size == 0 ? 1 : size))
+        {
+            return p;
+        }
+
+        throw std::bad_alloc();
+    }
+}
+
+void *operator new(size_t size)
+{
+    return Allocate(size);
+}
+
+void *operator new[](size_t size)
+{
+    return Allocate(size);
+}
+
+void operator delete(void *p) noexcept(true)
+{
+    std::free(p);
+}
+
+void operator delete[](void *p) noexcept(true)
+{
+    std::free(p);
+}
+
+namespace xUnitpp { namespace Benchmarks
+{
+
+size_t Allocations()
+{
+    return allocations;
+}
+
+}}
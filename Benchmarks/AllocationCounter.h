@@ -0,0 +1,15 @@
+#ifndef ALLOCATIONCOUNTER_H_
+#define ALLOCATIONCOUNTER_H_
+
+#include <cstddef>
+
+namespace xUnitpp { namespace Benchmarks
+{
+
+//
+// Every call to the global operator new made by this process, on any thread.
+size_t Allocations();
+
+}}
+
+#endif
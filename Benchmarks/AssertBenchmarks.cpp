@@ -0,0 +1,62 @@
+#include <string>
+#include "xUnit++/TestEvent.h"
+#include "xUnit++/TestEventRecorder.h"
+#include "xUnit++/xUnitAssert.h"
+#include "xUnit++/xUnitCheck.h"
+#include "xUnit++/xUnitLog.h"
+#include "Benchmark.h"
+
+namespace
+{
+    const long long PassingCount = 10000000;
+    const long long FailingCount = 100000;
+
+    void RequireNoAllocations(xUnitpp::Benchmarks::Results &results, xUnitpp::Benchmarks::Result &&result)
+    {
+        if (result.allocations != 0)
+        {
+            results.Fail(result.name + " should not allocate.");
+        }
+
+        results.Add(std::move(result));
+    }
+}
+
+namespace xUnitpp { namespace Benchmarks
+{
+
+void AssertBenchmarks(Results &results)
+{
+    // checks and logs report to a recorder, which has to be tied to something on this thread
+    TestEventRecorder recorder;
+    recorder.Tie([](TestEvent &&) { });
+
+    Check check(recorder);
+    Log log(recorder);
+
+    // longer than any short string buffer, so a copy would show up as an allocation
+    const std::string expected = "a string long enough to live on the heap";
+    const std::string actual = expected;
+
+    RequireNoAllocations(results, Measure("passing Assert.True", PassingCount, [](long long i) { Assert.True(i >= 0); }));
+    RequireNoAllocations(results, Measure("passing Assert.Equal(int)", PassingCount, [](long long i) { Assert.Equal(i, i); }));
+    RequireNoAllocations(results, Measure("passing Assert.Equal(double, precision)", PassingCount, [](long long i) { Assert.Equal(i * 0.5, i * 0.5, 3); }));
+    RequireNoAllocations(results, Measure("passing Assert.Equal(std::string)", PassingCount, [&](long long) { Assert.Equal(expected, actual); }));
+    RequireNoAllocations(results, Measure("passing Assert.Equal(int) << message", PassingCount, [&](long long i) { Assert.Equal(i, i) << "index " << i << " of " << expected; }));
+    RequireNoAllocations(results, Measure("passing Check.Equal(int)", PassingCount, [&](long long i) { check.Equal(i, i); }));
+
+    results.Add(Measure("failing Assert.Equal(int)", FailingCount, [](long long i)
+        {
+            try
+            {
+                Assert.Equal(i, i + 1);
+            }
+            catch (const xUnitAssert &)
+            {
+            }
+        }));
+    results.Add(Measure("failing Check.Equal(int)", FailingCount, [&](long long i) { check.Equal(i, i + 1); }));
+    results.Add(Measure("Log.Info << message", FailingCount, [&](long long i) { log.Info << "index " << i << " of " << expected; }));
+}
+
+}}
@@ -0,0 +1,88 @@
+#include "Benchmark.h"
+#include <iomanip>
+
+namespace
+{
+    double PerUnit(double value, long long count)
+    {
+        return count == 0 ? 0.0 : value / count;
+    }
+
+    std::string JsonString(const std::string &value)
+    {
+        std::string result = "\"";
+
+        for (auto c : value)
+        {
+            if (c == '"' || c == '\\')
+            {
+                result += '\\';
+            }
+
+            result += c;
+        }
+
+        return result + "\"";
+    }
+}
+
+namespace xUnitpp { namespace Benchmarks
+{
+
+Results::Results(std::ostream &progress)
+    : progress(progress)
+{
+}
+
+void Results::Add(Result &&result)
+{
+    progress << std::left << std::setw(48) << result.name << std::right
+        << std::setw(12) << std::fixed << std::setprecision(1) << PerUnit((double)result.time.count(), result.count) << " ns/" << result.unit
+        << std::setw(10) << std::setprecision(2) << PerUnit((double)result.allocations, result.count) << " allocations/" << result.unit
+        << std::endl;
+
+    results.push_back(std::move(result));
+}
+
+void Results::Fail(const std::string &reason)
+{
+    progress << "FAILED: " << reason << std::endl;
+    failures.push_back(reason);
+}
+
+bool Results::Failed() const
+{
+    return !failures.empty();
+}
+
+void Results::WriteJson(std::ostream &output) const
+{
+    output << "{\n    \"benchmarks\": [";
+
+    for (size_t i = 0; i != results.size(); ++i)
+    {
+        const auto &result = results[i];
+        auto seconds = Time::ToSeconds(result.time).count();
+
+        output << (i == 0 ? "\n" : ",\n")
+            << "        { \"name\": " << JsonString(result.name)
+            << ", \"unit\": " << JsonString(result.unit)
+            << ", \"count\": " << result.count
+            << ", \"ns\": " << result.time.count()
+            << ", \"nsPerUnit\": " << PerUnit((double)result.time.count(), result.count)
+            << ", \"unitsPerSecond\": " << (seconds > 0 ? result.count / seconds : 0.0)
+            << ", \"allocationsPerUnit\": " << PerUnit((double)result.allocations, result.count)
+            << " }";
+    }
+
+    output << "\n    ],\n    \"failures\": [";
+
+    for (size_t i = 0; i != failures.size(); ++i)
+    {
+        output << (i == 0 ? " " : ", ") << JsonString(failures[i]);
+    }
+
+    output << " ]\n}\n";
+}
+
+}}
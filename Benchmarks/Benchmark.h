@@ -0,0 +1,86 @@
+#ifndef BENCHMARK_H_
+#define BENCHMARK_H_
+
+#include <ostream>
+#include <string>
+#include <vector>
+#include "xUnit++/xUnitTime.h"
+#include "AllocationCounter.h"
+
+namespace xUnitpp { namespace Benchmarks
+{
+
+struct Result
+{
+    std::string name;
+    std::string unit;       // what was counted: an "op", a "test", an "event"...
+    long long count;
+    Time::Duration time;
+    size_t allocations;
+};
+
+class Results
+{
+public:
+    Results(std::ostream &progress);
+
+    void Add(Result &&result);
+
+    // for a benchmark whose result is wrong, not merely slow
+    void Fail(const std::string &reason);
+    bool Failed() const;
+
+    void WriteJson(std::ostream &output) const;
+
+private:
+    Results &operator =(Results) /* = delete */;
+
+private:
+    std::ostream &progress;
+    std::vector<Result> results;
+    std::vector<std::string> failures;
+};
+
+//
+// Times a single call of fn, which does count units of work.
+template<typename TFunc>
+Result MeasureOnce(const std::string &name, const std::string &unit, long long count, TFunc &&fn)
+{
+    Result result;
+    result.name = name;
+    result.unit = unit;
+    result.count = count;
+
+    auto allocations = Allocations();
+    auto start = Time::Clock::now();
+
+    fn();
+
+    result.time = Time::ToDuration(Time::Clock::now() - start);
+    result.allocations = Allocations() - allocations;
+
+    return result;
+}
+
+//
+// Times count calls of fn, each given its index.
+template<typename TFunc>
+Result Measure(const std::string &name, long long count, TFunc &&fn)
+{
+    return MeasureOnce(name, "op", count, [&]()
+        {
+            for (long long i = 0; i != count; ++i)
+            {
+                fn(i);
+            }
+        });
+}
+
+void AssertBenchmarks(Results &results);
+void RegisterBenchmarks(Results &results);
+void RunnerBenchmarks(Results &results);
+void ReporterBenchmarks(Results &results);
+
+}}
+
+#endif
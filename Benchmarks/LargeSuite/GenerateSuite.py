@@ -0,0 +1,112 @@
+#!/usr/bin/env python
+"""Generates the sources of a synthetic test library, for timing the console against suites of any size.
+
+Every file holds one SUITE. The mix of theories, attributes, skips and failures is drawn from a seeded
+random generator, so the same arguments always produce the same library.
+"""
+
+import argparse
+import os
+import random
+
+DEFAULT_TESTS_PER_FILE = 500
+
+
+def file_count(facts, theories, tests_per_file=DEFAULT_TESTS_PER_FILE):
+    total = facts + theories
+    return max(1, (total + tests_per_file - 1) // tests_per_file)
+
+
+def file_names(facts, theories, tests_per_file=DEFAULT_TESTS_PER_FILE):
+    return ['Suite%05d.cpp' % i for i in range(file_count(facts, theories, tests_per_file))]
+
+
+def _test(rng, kind, index, rows, attributes, skips, failures):
+    lines = []
+
+    # attributes apply to everything in the block that follows them
+    if rng.random() < skips:
+        lines.append('SKIP("generated skip")')
+        lines.append('{')
+    elif rng.random() < attributes:
+        lines.append('ATTRIBUTES(("Category", "%s"), ("Index", "%d"))' % (rng.choice(['Fast', 'Slow', 'Io']), index))
+        lines.append('{')
+
+    block = len(lines) != 0
+
+    body = '    Assert.Fail() << "generated failure";' if rng.random() < failures else '    Assert.Equal(%d, %d);' % (index, index)
+
+    if kind == 'fact':
+        lines.append('FACT("Fact %d")' % index)
+        lines.append('{')
+        lines.append(body)
+        lines.append('}')
+    else:
+        lines.append('THEORY("Theory %d", (int row), %s)' % (index, ', '.join('std::make_tuple(%d)' % r for r in range(rows))))
+        lines.append('{')
+        lines.append('    Assert.True(row >= 0);')
+        lines.append(body)
+        lines.append('}')
+
+    if block:
+        lines.append('}')
+
+    return '\n'.join(lines) + '\n'
+
+
+def generate(directory, facts, theories=0, rows=5, attributes=0.0, skips=0.0, failures=0.0,
+             tests_per_file=DEFAULT_TESTS_PER_FILE, seed=0):
+    """Writes the sources into directory and returns their paths."""
+
+    # the THEORY macro counts its arguments, and can't count very far
+    rows = max(1, min(rows, 60))
+
+    rng = random.Random(seed)
+
+    kinds = ['fact'] * facts + ['theory'] * theories
+    rng.shuffle(kinds)
+
+    if not os.path.isdir(directory):
+        os.makedirs(directory)
+
+    paths = []
+    for i, name in enumerate(file_names(facts, theories, tests_per_file)):
+        tests = kinds[i * tests_per_file:(i + 1) * tests_per_file]
+
+        source = '#include "xUnit++/xUnit++.h"\n\nSUITE("Suite %d")\n{\n\n' % i
+        source += '\n'.join(_test(rng, kind, i * tests_per_file + j, rows, attributes, skips, failures) for j, kind in enumerate(tests))
+        source += '\n}\n'
+
+        path = os.path.join(directory, name)
+
+        # leave unchanged files alone, so only what really changed gets rebuilt
+        if not os.path.exists(path) or open(path).read() != source:
+            with open(path, 'w') as f:
+                f.write(source)
+
+        paths.append(path)
+
+    return paths
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__)
+    parser.add_argument('directory', help='where to write the generated sources')
+    parser.add_argument('--facts', type=int, default=1000, help='number of FACTs')
+    parser.add_argument('--theories', type=int, default=0, help='number of THEORYs')
+    parser.add_argument('--rows', type=int, default=5, help='data rows per THEORY (at most 60)')
+    parser.add_argument('--attributes', type=float, default=0.0, help='fraction of tests with attributes')
+    parser.add_argument('--skips', type=float, default=0.0, help='fraction of tests that are skipped')
+    parser.add_argument('--failures', type=float, default=0.0, help='fraction of tests that fail')
+    parser.add_argument('--tests-per-file', type=int, default=DEFAULT_TESTS_PER_FILE, help='tests in each generated source file')
+    parser.add_argument('--seed', type=int, default=0, help='seed for the random mix of tests')
+    args = parser.parse_args()
+
+    paths = generate(args.directory, args.facts, args.theories, args.rows, args.attributes, args.skips, args.failures,
+                     args.tests_per_file, args.seed)
+
+    print('Wrote %d files to %s' % (len(paths), args.directory))
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,101 @@
+#!/usr/bin/env python
+"""Times xUnit++.console against test libraries, one phase at a time.
+
+Each phase is a separate run of the console, so each is measured from a cold start:
+  discovery  - load the library and list every test (--list)
+  filtering  - list again, with suite, name and attribute filters
+  execution  - run every test with console output thrown away
+  reporting  - run every test again, writing XML as well
+
+Wall time and the peak resident set of each run are printed, and optionally written as JSON.
+Pass several libraries (for instance from `scons largesuite=1000`, `largesuite=10000`...) to see how
+each phase scales.
+"""
+
+import argparse
+import json
+import os
+import re
+import subprocess
+import sys
+import tempfile
+import time
+
+
+def run(command):
+    """Runs command with its output discarded; returns (seconds, peak resident kilobytes, exit status)."""
+
+    with open(os.devnull, 'w') as devnull:
+        start = time.time()
+        process = subprocess.Popen(command, stdout=devnull, stderr=devnull)
+        _, status, usage = os.wait4(process.pid, 0)
+        seconds = time.time() - start
+
+    # ru_maxrss is in kilobytes on Linux and in bytes on OS X
+    rss = usage.ru_maxrss // 1024 if sys.platform == 'darwin' else usage.ru_maxrss
+
+    return seconds, rss, status
+
+
+def count_tests(console, library):
+    output = subprocess.Popen([console, library, '--list', '--no-shadow'], stdout=subprocess.PIPE).communicate()[0]
+    return len(re.findall(b' :: ', output))
+
+
+def phases(console, library, filters, xml):
+    common = [console, library, '--no-shadow', '--no-history']
+
+    return [
+        ('discovery', common + ['--list']),
+        ('filtering', common + ['--list'] + filters),
+        ('execution', common),
+        ('reporting', common + ['--xml', xml]),
+    ]
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument('console', help='path to xUnit++.console')
+    parser.add_argument('libraries', nargs='+', help='test libraries to time')
+    parser.add_argument('--repeat', type=int, default=3, help='runs of each phase; the fastest is kept')
+    parser.add_argument('--filter', nargs='*', default=['--suite', '1', '--name', '[02468]$', '--exclude', 'Category=Slow'],
+                        help='console arguments used for the filtering phase')
+    parser.add_argument('--json', help='also write the results to this file')
+    args = parser.parse_args()
+
+    results = []
+    xml = os.path.join(tempfile.gettempdir(), 'TimeSuite.%d.xml' % os.getpid())
+
+    print('%-40s %10s %-10s %10s %10s %12s' % ('library', 'tests', 'phase', 'seconds', 'peak MB', 'tests/s'))
+
+    try:
+        for library in args.libraries:
+            tests = count_tests(args.console, library)
+
+            for phase, command in phases(args.console, library, args.filter, xml):
+                seconds, rss, status = min(run(command) for _ in range(args.repeat))
+
+                result = {
+                    'library': library,
+                    'tests': tests,
+                    'phase': phase,
+                    'seconds': seconds,
+                    'peakKilobytes': rss,
+                    'testsPerSecond': tests / seconds if seconds > 0 else 0,
+                    'exitStatus': status,
+                }
+                results.append(result)
+
+                print('%-40s %10d %-10s %10.3f %10.1f %12.0f' % (os.path.basename(library), tests, phase, seconds, rss / 1024.0,
+                                                                 result['testsPerSecond']))
+    finally:
+        if os.path.exists(xml):
+            os.remove(xml)
+
+    if args.json:
+        with open(args.json, 'w') as f:
+            json.dump({'results': results}, f, indent=4)
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,125 @@
+#include <memory>
+#include <string>
+#include <tuple>
+#include <vector>
+#include "xUnit++/Attributes.h"
+#include "xUnit++/TestCollection.h"
+#include "xUnit++/TestDescriptor.h"
+#include "xUnit++/TestEventRecorder.h"
+#include "xUnit++/xUnitCheck.h"
+#include "xUnit++/xUnitLog.h"
+#include "xUnit++/xUnitWarn.h"
+#include "Benchmark.h"
+
+namespace
+{
+    const long long FactCount = 100000;
+    const int TheoryRows = 100;
+    const long long TheoryCount = 1000;
+
+    void Fact()
+    {
+    }
+
+    void Theory(int, std::string)
+    {
+    }
+
+    // everything a FACT or THEORY sets up for itself at static initialization, besides the test
+    struct TestEvents
+    {
+        TestEvents()
+        {
+            for (int i = 0; i != 3; ++i)
+            {
+                recorders.push_back(std::make_shared<xUnitpp::TestEventRecorder>());
+            }
+
+            check = std::make_shared<xUnitpp::Check>(*recorders[0]);
+            warn = std::make_shared<xUnitpp::Warn>(*recorders[1]);
+            log = std::make_shared<xUnitpp::Log>(*recorders[2]);
+        }
+
+        std::vector<std::shared_ptr<xUnitpp::TestEventRecorder>> recorders;
+        std::shared_ptr<xUnitpp::Check> check;
+        std::shared_ptr<xUnitpp::Warn> warn;
+        std::shared_ptr<xUnitpp::Log> log;
+    };
+
+    xUnitpp::AttributeCollection Attributes()
+    {
+        xUnitpp::AttributeCollection attributes;
+        attributes.insert(std::make_pair("Category", "Benchmark"));
+        attributes.sort();
+        return attributes;
+    }
+
+    const std::string &Suite()
+    {
+        static std::string suite = "Benchmark Suite";
+        return suite;
+    }
+}
+
+namespace xUnitpp { namespace Benchmarks
+{
+
+void RegisterBenchmarks(Results &results)
+{
+    const std::string suite = "Benchmark Suite";
+
+    {
+        TestCollection collection;
+        std::vector<TestEvents> events(FactCount);
+
+        results.Add(MeasureOnce("TestCollection::Register per FACT", "test", FactCount, [&]()
+            {
+                for (long long i = 0; i != FactCount; ++i)
+                {
+                    events[i] = TestEvents();
+
+                    TestCollection::Register(collection, &Fact, "Fact " + std::to_string(i), suite,
+                        Attributes(), -1, std::string(__FILE__), __LINE__, std::vector<std::shared_ptr<TestEventRecorder>>(events[i].recorders));
+                }
+            }));
+    }
+
+    {
+        const TestDescriptor descriptor = { "Fact", "", &Suite, &Attributes, -1, __FILE__, __LINE__, SharedEventRecorders, &Fact, nullptr };
+        std::vector<const TestDescriptor *> descriptors(FactCount, &descriptor);
+
+        // what a described FACT costs to list: nothing happens at static initialization
+        results.Add(MeasureOnce("TestCollection::Describe and enumerate per FACT", "test", FactCount, [&]()
+            {
+                TestCollection collection;
+                collection.Describe(descriptors.data(), descriptors.data() + descriptors.size());
+
+                size_t count = 0;
+                collection.EnumerateTestDetails([&](const ITestDetails &) { ++count; });
+            }));
+    }
+
+    {
+        TestCollection collection;
+        std::vector<TestEvents> events(TheoryCount);
+
+        std::tuple<int, std::string> rows[TheoryRows];
+        for (int i = 0; i != TheoryRows; ++i)
+        {
+            rows[i] = std::make_tuple(i, "row " + std::to_string(i));
+        }
+
+        results.Add(MeasureOnce("TestCollection::Register per THEORY row", "test", TheoryCount * TheoryRows, [&]()
+            {
+                for (long long i = 0; i != TheoryCount; ++i)
+                {
+                    events[i] = TestEvents();
+
+                    TestCollection::Register(collection, &Theory, TheoryData(TheoryRows, rows), "Theory " + std::to_string(i), suite,
+                        std::string("(int number, std::string text)"), Attributes(), -1, std::string(__FILE__), __LINE__, events[i].recorders);
+                }
+            }));
+    }
+}
+
+}}
@@ -0,0 +1,92 @@
+#include <iostream>
+#include <memory>
+#include <streambuf>
+#include <string>
+#include <utility>
+#include <vector>
+#include "xUnit++/EventLevel.h"
+#include "xUnit++/IOutput.h"
+#include "xUnit++/TestDetails.h"
+#include "xUnit++/TestEvent.h"
+#include "ConsoleReporter.h"
+#include "XmlReporter.h"
+#include "Benchmark.h"
+
+namespace
+{
+    const int TestCount = 5000;
+
+    // the cost of formatting is what's interesting, not the speed of the terminal
+    class NullBuffer : public std::streambuf
+    {
+    protected:
+        virtual int_type overflow(int_type c) override
+        {
+            return traits_type::not_eof(c);
+        }
+
+        virtual std::streamsize xsputn(const char *, std::streamsize count) override
+        {
+            return count;
+        }
+    };
+
+    // each test reports a start, an informational event, a failed check and a finish
+    const long long EventsPerTest = 4;
+
+    void Report(xUnitpp::IOutput &output, const std::vector<xUnitpp::TestDetails> &details)
+    {
+        xUnitpp::TestEvent info(xUnitpp::EventLevel::Info, "some output from the test");
+        xUnitpp::TestEvent failure(xUnitpp::EventLevel::Check, "a failed check", xUnitpp::LineInfo(std::string(__FILE__), __LINE__));
+
+        for (const auto &td : details)
+        {
+            output.ReportStart(td);
+            output.ReportEvent(td, info);
+            output.ReportEvent(td, failure);
+            output.ReportFinish(td, 1000);
+        }
+
+        output.ReportAllTestsComplete(details.size(), 0, details.size(), 1000 * details.size());
+    }
+}
+
+namespace xUnitpp { namespace Benchmarks
+{
+
+void ReporterBenchmarks(Results &results)
+{
+    std::vector<TestDetails> details;
+    for (int i = 0; i != TestCount; ++i)
+    {
+        details.push_back(TestDetails("Test " + std::to_string(i), 0, "", "Suite " + std::to_string(i % 16),
+            AttributeCollection(), Time::Duration::zero(), std::string(__FILE__), __LINE__));
+    }
+
+    NullBuffer nullBuffer;
+
+    {
+        auto cout = std::cout.rdbuf(&nullBuffer);
+
+        auto result = MeasureOnce("ConsoleReporter", "event", TestCount * EventsPerTest, [&]()
+            {
+                ConsoleReporter reporter(false, false, false);
+                Report(reporter, details);
+            });
+
+        std::cout.rdbuf(cout);
+        results.Add(std::move(result));
+    }
+
+    {
+        std::ostream output(&nullBuffer);
+
+        results.Add(MeasureOnce("XmlReporter", "event", TestCount * EventsPerTest, [&]()
+            {
+                Utilities::XmlReporter reporter(output);
+                Report(reporter, details);
+            }));
+    }
+}
+
+}}
@@ -0,0 +1,76 @@
+#include <memory>
+#include <string>
+#include <vector>
+#include "xUnit++/IOutput.h"
+#include "xUnit++/ITestDetails.h"
+#include "xUnit++/TestEventRecorder.h"
+#include "xUnit++/xUnitTest.h"
+#include "xUnit++/xUnitTestRunner.h"
+#include "Benchmark.h"
+
+namespace
+{
+    const int TestCount = 20000;
+
+    class NullOutput : public xUnitpp::IOutput
+    {
+    public:
+        virtual void __stdcall ReportStart(const xUnitpp::ITestDetails &) override
+        {
+        }
+
+        virtual void __stdcall ReportEvent(const xUnitpp::ITestDetails &, const xUnitpp::ITestEvent &) override
+        {
+        }
+
+        virtual void __stdcall ReportSkip(const xUnitpp::ITestDetails &, const char *) override
+        {
+        }
+
+        virtual void __stdcall ReportFinish(const xUnitpp::ITestDetails &, long long) override
+        {
+        }
+
+        virtual void __stdcall ReportAllTestsComplete(size_t, size_t, size_t, long long) override
+        {
+        }
+    };
+
+    bool AllTests(const xUnitpp::ITestDetails &)
+    {
+        return true;
+    }
+}
+
+namespace xUnitpp { namespace Benchmarks
+{
+
+void RunnerBenchmarks(Results &results)
+{
+    std::vector<std::shared_ptr<TestEventRecorder>> recorders;
+    for (int i = 0; i != 3; ++i)
+    {
+        recorders.push_back(std::make_shared<TestEventRecorder>());
+    }
+
+    // a handful of suites, so the scheduler has something to group
+    std::vector<std::shared_ptr<xUnitTest>> tests;
+    for (int i = 0; i != TestCount; ++i)
+    {
+        tests.push_back(std::make_shared<xUnitTest>([]() { }, "Test " + std::to_string(i), 0, "", "Suite " + std::to_string(i % 16),
+            AttributeCollection(), Time::Duration::zero(), std::string(__FILE__), __LINE__, recorders));
+    }
+
+    const size_t threadCounts[] = { 1, 8, 64 };
+    for (auto threads : threadCounts)
+    {
+        NullOutput output;
+
+        results.Add(MeasureOnce("RunTests per empty test, " + std::to_string(threads) + " threads", "test", TestCount, [&]()
+            {
+                RunTests(output, &AllTests, tests, Time::Duration::zero(), threads);
+            }));
+    }
+}
+
+}}
@@ -0,0 +1,44 @@
+#include <fstream>
+#include <iostream>
+#include <string>
+#include "Benchmark.h"
+
+int main(int argc, char **argv)
+{
+    std::string jsonFile;
+
+    for (int i = 1; i != argc; ++i)
+    {
+        if (std::string(argv[i]) == "--json" && i + 1 != argc)
+        {
+            jsonFile = argv[++i];
+        }
+        else
+        {
+            std::cerr << "usage: " << argv[0] << " [--json <file>]\n";
+            return -1;
+        }
+    }
+
+    xUnitpp::Benchmarks::Results results(std::cout);
+
+    xUnitpp::Benchmarks::AssertBenchmarks(results);
+    xUnitpp::Benchmarks::RegisterBenchmarks(results);
+    xUnitpp::Benchmarks::RunnerBenchmarks(results);
+    xUnitpp::Benchmarks::ReporterBenchmarks(results);
+
+    if (!jsonFile.empty())
+    {
+        std::ofstream file(jsonFile, std::ios::binary);
+
+        if (!file)
+        {
+            std::cerr << "Unable to open " << jsonFile << " for writing.\n";
+            return -1;
+        }
+
+        results.WriteJson(file);
+    }
+
+    return results.Failed() ? 1 : 0;
+}
@@ -0,0 +1,26 @@
+#include "DetailsFactory.h"
+#include <utility>
+#include "xUnit++/TestDetails.h"
+
+namespace xUnitpp { namespace Tests {
+
+std::shared_ptr<xUnitpp::TestDetails> Details(const std::string &name, const std::string &suite,
+    const std::multimap<std::string, std::string> &attributes)
+{
+    xUnitpp::AttributeCollection collection;
+    for (const auto &attribute : attributes)
+    {
+        collection.insert(std::make_pair(attribute.first, attribute.second));
+    }
+
+    collection.sort();
+
+    return std::make_shared<xUnitpp::TestDetails>(std::string(name), 0, "", suite, std::move(collection), xUnitpp::Time::Duration::zero(), "file.cpp", 10);
+}
+
+bool AllTests(const xUnitpp::ITestDetails &)
+{
+    return true;
+}
+
+}}
@@ -0,0 +1,25 @@
+#ifndef DETAILSFACTORY_H_
+#define DETAILSFACTORY_H_
+
+#include <map>
+#include <memory>
+#include <string>
+
+namespace xUnitpp
+{
+    struct ITestDetails;
+    struct TestDetails;
+}
+
+namespace xUnitpp { namespace Tests {
+
+// the details of a test that is never run, for code that only ever looks at a test's details
+std::shared_ptr<xUnitpp::TestDetails> Details(const std::string &name, const std::string &suite = "suite",
+    const std::multimap<std::string, std::string> &attributes = std::multimap<std::string, std::string>());
+
+// a filter that selects every test
+bool AllTests(const xUnitpp::ITestDetails &);
+
+}}
+
+#endif
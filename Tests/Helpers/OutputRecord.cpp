@@ -17,6 +17,18 @@ void OutputRecord::ReportEvent(const ITestDetails &testDetails, const ITestEvent
     events.push_back(std::make_pair(static_cast<const TestDetails &>(testDetails), static_cast<const TestEvent &>(evt)));
 }
 
+void OutputRecord::ReportBenchmark(const ITestDetails &testDetails, const IBenchmarkResult &result)
+{
+    std::lock_guard<std::mutex> guard(lock);
+    benchmarks.push_back(std::make_pair(static_cast<const TestDetails &>(testDetails), static_cast<const BenchmarkResult &>(result)));
+}
+
+void OutputRecord::ReportMetrics(const ITestDetails &testDetails, const ITestMetrics &testMetrics)
+{
+    std::lock_guard<std::mutex> guard(lock);
+    metrics.push_back(std::make_pair(static_cast<const TestDetails &>(testDetails), static_cast<const TestMetrics &>(testMetrics)));
+}
+
 void OutputRecord::ReportSkip(const ITestDetails &testDetails, const char *reason)
 {
     std::lock_guard<std::mutex> guard(lock);
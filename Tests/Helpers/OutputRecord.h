@@ -7,6 +7,8 @@
 #include <utility>
 #include <vector>
 #include "xUnit++/IOutput.h"
+#include "xUnit++/TestMetrics.h"
+#include "xUnit++/xUnitBenchmark.h"
 
 namespace xUnitpp
 {
@@ -21,12 +23,16 @@ class OutputRecord : public IOutput
 public:
     virtual void __stdcall ReportStart(const ITestDetails &testDetails) override;
     virtual void __stdcall ReportEvent(const ITestDetails &testDetails, const ITestEvent &evt) override;
+    virtual void __stdcall ReportBenchmark(const ITestDetails &testDetails, const IBenchmarkResult &result) override;
+    virtual void __stdcall ReportMetrics(const ITestDetails &testDetails, const ITestMetrics &metrics) override;
     virtual void __stdcall ReportSkip(const ITestDetails &testDetails, const char *reason) override;
     virtual void __stdcall ReportFinish(const ITestDetails &testDetails, long long nsTaken) override;
     virtual void __stdcall ReportAllTestsComplete(size_t testCount, size_t skipped, size_t failed, long long nsTotal) override;
 
     std::vector<TestDetails> orderedTestList;
     std::vector<std::pair<TestDetails, TestEvent>> events;
+    std::vector<std::pair<TestDetails, BenchmarkResult>> benchmarks;
+    std::vector<std::pair<TestDetails, TestMetrics>> metrics;
     std::vector<std::pair<TestDetails, std::string>> skips;
     std::vector<std::pair<TestDetails, Time::Duration>> finishedTests;
 
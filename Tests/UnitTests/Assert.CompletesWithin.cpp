@@ -0,0 +1,57 @@
+#include <chrono>
+#include <stdexcept>
+#include <thread>
+#include "xUnit++/xUnit++.h"
+
+using xUnitpp::xUnitAssert;
+
+SUITE("AssertCompletesWithin")
+{
+
+FACT("CompletesWithin succeeds for fast code without running every repetition")
+{
+    int calls = 0;
+
+    Assert.CompletesWithin([&]() { ++calls; }, std::chrono::seconds(1), 9);
+
+    // one warm up call, and then a majority of the repetitions
+    Assert.Equal(6, calls);
+}
+
+UNTIMED_FACT("CompletesWithin compares the median, not the slowest run")
+{
+    int calls = 0;
+
+    Assert.CompletesWithin([&]()
+        {
+            if (calls++ == 1)
+            {
+                std::this_thread::sleep_for(std::chrono::milliseconds(50));
+            }
+        }, std::chrono::milliseconds(10), 5);
+}
+
+UNTIMED_FACT("CompletesWithin should assert when the median is over budget")
+{
+    try
+    {
+        Assert.CompletesWithin([]() { std::this_thread::sleep_for(std::chrono::milliseconds(2)); }, std::chrono::microseconds(1), 3) << "custom";
+    }
+    catch (const xUnitAssert &assert)
+    {
+        Assert.Equal("Assert.CompletesWithin", assert.Call());
+        Assert.Contains(assert.Expected(), "median <= 1000 nanoseconds");
+        Assert.Contains(assert.Actual(), "milliseconds, ");
+        Assert.Contains(assert.UserMessage(), "custom");
+        return;
+    }
+
+    Assert.Fail();
+}
+
+FACT("CompletesWithin needs at least one repetition")
+{
+    Assert.Throws<std::invalid_argument>([]() { Assert.CompletesWithin([]() { }, std::chrono::seconds(1), 0); });
+}
+
+}
@@ -0,0 +1,86 @@
+#include <memory>
+#include <string>
+#include <vector>
+#include "xUnit++/xUnit++.h"
+#include "xUnit++/TestCollection.h"
+#include "xUnit++/TestEventRecorder.h"
+#include "xUnit++/xUnitBenchmark.h"
+#include "xUnit++/xUnitTestRunner.h"
+#include "Helpers/OutputRecord.h"
+
+SUITE("Benchmark")
+{
+
+struct Fixture
+{
+    Fixture()
+        : calls(0)
+    {
+        for (int i = 0; i != 3; ++i)
+        {
+            localEventRecorders.push_back(std::make_shared<xUnitpp::TestEventRecorder>());
+        }
+    }
+
+    void Register(std::function<void()> &&body)
+    {
+        auto log = localEventRecorders[2];
+
+        xUnitpp::TestCollection::Register reg(collection, [=]() { xUnitpp::RunBenchmark(body, *log); }, "Name", "Suite",
+            xUnitpp::BenchmarkAttributes(xUnitpp::AttributeCollection()), 0, "file", 0, std::move(localEventRecorders));
+        (void)reg;
+    }
+
+    void Run()
+    {
+        xUnitpp::RunTests(outputRecord, [](const xUnitpp::ITestDetails &) { return true; }, collection.Tests(), xUnitpp::Time::Duration::zero(), 0);
+    }
+
+    long long calls;
+    std::vector<std::shared_ptr<xUnitpp::TestEventRecorder>> localEventRecorders;
+    xUnitpp::TestCollection collection;
+    xUnitpp::Tests::OutputRecord outputRecord;
+};
+
+FACT_FIXTURE("Benchmarks report their timings instead of an event", Fixture)
+{
+    Register([&]() { ++calls; });
+
+    Run();
+
+    Assert.Empty(outputRecord.events);
+    Assert.Equal(1U, outputRecord.benchmarks.size());
+    Assert.Equal(0U, outputRecord.summaryFailed);
+
+    const auto &result = outputRecord.benchmarks[0].second;
+
+    Assert.True(result.GetIterations() > 0);
+    Assert.NotEqual(0U, result.GetSampleCount());
+    Assert.True(calls >= result.GetIterations() * (long long)result.GetSampleCount());
+    Assert.InRange(result.GetMean(), result.GetMin(), result.GetMax() + 1);
+    Assert.True(result.GetStandardDeviation() >= 0);
+}
+
+FACT_FIXTURE("A failing benchmark fails its test", Fixture)
+{
+    Register([&]() { Assert.Fail() << "failed"; });
+
+    Run();
+
+    Assert.Empty(outputRecord.benchmarks);
+    Assert.Equal(1U, outputRecord.summaryFailed);
+}
+
+FACT("Benchmarks are marked with a Benchmark attribute")
+{
+    xUnitpp::AttributeCollection attributes;
+    attributes.insert(xUnitpp::AttributeCollection::Attribute("Cost", "100"));
+
+    attributes = xUnitpp::BenchmarkAttributes(std::move(attributes));
+
+    auto benchmark = attributes.find(xUnitpp::AttributeCollection::Attribute("Benchmark", ""));
+    Assert.True(benchmark.first != benchmark.second);
+    Assert.Equal(2U, attributes.size());
+}
+
+}
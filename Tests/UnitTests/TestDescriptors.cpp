@@ -0,0 +1,156 @@
+#include <atomic>
+#include <memory>
+#include <string>
+#include <tuple>
+#include <vector>
+#include "xUnit++/xUnit++.h"
+#include "xUnit++/TestCollection.h"
+#include "xUnit++/TestDescriptor.h"
+#include "xUnit++/xUnitTestRunner.h"
+#include "Helpers/OutputRecord.h"
+
+SUITE("TestDescriptors")
+{
+
+namespace
+{
+    std::atomic<int> attributeCalls(0);
+    std::atomic<int> factCalls(0);
+
+    const std::string &DescribedSuite()
+    {
+        static std::string suite = "Described";
+        return suite;
+    }
+
+    xUnitpp::AttributeCollection DescribedAttributes()
+    {
+        xUnitpp::AttributeCollection attributes;
+        attributes.insert(std::make_pair("Category", "Described"));
+        attributes.sort();
+        return attributes;
+    }
+
+    xUnitpp::AttributeCollection CountedAttributes()
+    {
+        ++attributeCalls;
+        return DescribedAttributes();
+    }
+
+    void Fact()
+    {
+    }
+
+    void CountedFact()
+    {
+        ++factCalls;
+    }
+
+    void Row(int)
+    {
+    }
+
+    void Rows(const xUnitpp::TestDescriptor &descriptor, std::vector<std::shared_ptr<xUnitpp::xUnitTest>> &tests)
+    {
+        std::tuple<int> rows[] = { std::make_tuple(1), std::make_tuple(2), std::make_tuple(3) };
+        xUnitpp::TestCollection::Register::Theory(tests, &Row, xUnitpp::TheoryData(3, rows), descriptor);
+    }
+
+    const xUnitpp::TestDescriptor first = { "First", "", &DescribedSuite, &DescribedAttributes, -1, "file.cpp", 10, xUnitpp::SharedEventRecorders, &Fact, nullptr };
+    const xUnitpp::TestDescriptor second = { "Second", "", &DescribedSuite, &DescribedAttributes, -1, "file.cpp", 20, xUnitpp::SharedEventRecorders, &Fact, nullptr };
+    const xUnitpp::TestDescriptor theory = { "Theory", "(int row)", &DescribedSuite, &DescribedAttributes, -1, "file.cpp", 30, xUnitpp::SharedEventRecorders, nullptr, &Rows };
+
+    const xUnitpp::TestDescriptor *const descriptors[] = { &first, &second, &theory };
+
+    // only used by one test, so the counts are its own
+    const xUnitpp::TestDescriptor countedFirst = { "First", "", &DescribedSuite, &CountedAttributes, -1, "file.cpp", 10, xUnitpp::SharedEventRecorders, &CountedFact, nullptr };
+    const xUnitpp::TestDescriptor countedSecond = { "Second", "", &DescribedSuite, &CountedAttributes, -1, "file.cpp", 20, xUnitpp::SharedEventRecorders, &CountedFact, nullptr };
+    const xUnitpp::TestDescriptor countedTheory = { "Theory", "(int row)", &DescribedSuite, &CountedAttributes, -1, "file.cpp", 30, xUnitpp::SharedEventRecorders, nullptr, &Rows };
+
+    const xUnitpp::TestDescriptor *const countedDescriptors[] = { &countedFirst, &countedSecond, &countedTheory };
+}
+
+struct Fixture
+{
+    Fixture()
+    {
+        collection.Describe(std::begin(descriptors), std::end(descriptors));
+    }
+
+    std::vector<std::pair<int, std::string>> Enumerate()
+    {
+        std::vector<std::pair<int, std::string>> tests;
+        collection.EnumerateTestDetails([&](const xUnitpp::ITestDetails &td) { tests.push_back(std::make_pair(td.GetId(), std::string(td.GetFullName()))); });
+        return tests;
+    }
+
+    xUnitpp::TestCollection collection;
+    xUnitpp::Tests::OutputRecord outputRecord;
+};
+
+FACT_FIXTURE("Facts are built only when they pass the filter", Fixture)
+{
+    collection.Describe(std::begin(countedDescriptors), std::end(countedDescriptors));
+
+    auto tests = Enumerate();
+
+    Assert.Equal(5U, tests.size());
+    Assert.Equal("First", tests[0].second);
+    Assert.Equal("Second", tests[1].second);
+    Assert.Equal("Theory[0](row: 1)", tests[2].second);
+
+    // once for each fact when described, and once for the theory when its rows were built
+    Assert.Equal(2 + 1, attributeCalls.load());
+
+    auto secondId = tests[1].first;
+    auto filter = [&](const xUnitpp::ITestDetails &td) { return td.GetId() == secondId; };
+    auto filtered = collection.FilteredTests(filter);
+
+    Assert.Equal(2 + 1 + 1, attributeCalls.load());
+
+    xUnitpp::RunTests(outputRecord, filter, filtered, xUnitpp::Time::Duration::zero(), 0);
+
+    Assert.Equal(1, factCalls.load());
+    Assert.Equal(1U, outputRecord.finishedTests.size());
+    Assert.Equal("Second", outputRecord.finishedTests[0].first.Name);
+    Assert.Equal(secondId, outputRecord.finishedTests[0].first.Id);
+    Assert.Equal("file.cpp", outputRecord.finishedTests[0].first.LineInfo.file);
+    Assert.Equal(20, outputRecord.finishedTests[0].first.LineInfo.line);
+}
+
+FACT_FIXTURE("Described tests keep their attributes", Fixture)
+{
+    size_t found = 0;
+
+    collection.EnumerateTestDetails([&](const xUnitpp::ITestDetails &td)
+        {
+            size_t begin, end;
+            td.FindAttributeKey("Category", begin, end);
+
+            if (end - begin == 1 && std::string(td.GetAttributeValue(begin)) == "Described" && std::string(td.GetSuite()) == "Described")
+            {
+                ++found;
+            }
+        });
+
+    Assert.Equal(5U, found);
+}
+
+FACT_FIXTURE("All described tests are built when every test is asked for", Fixture)
+{
+    auto ids = Enumerate();
+
+    const auto &tests = collection.Tests();
+
+    Assert.Equal(5U, tests.size());
+
+    for (size_t i = 0; i != tests.size(); ++i)
+    {
+        Assert.Equal(ids[i].first, tests[i]->TestDetails().Id);
+    }
+
+    // asking again builds nothing more
+    Assert.Same(tests, collection.Tests());
+}
+
+}
@@ -1,4 +1,16 @@
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <numeric>
+#include <set>
+#include <string>
 #include <thread>
+#include "xUnit++/EventLevel.h"
+#include "xUnit++/IAllocationCounter.h"
+#include "xUnit++/IThreadBudget.h"
+#include "xUnit++/TestMetrics.h"
 #include "xUnit++/xUnit++.h"
 #include "xUnit++/xUnitTestRunner.h"
 #include "xUnit++/xUnitTime.h"
@@ -186,7 +198,8 @@ UNTIMED_FACT_FIXTURE("SlowTestsFailLowTimeThreshold", TestRunnerFixture)
     tests.push_back(TestFactory(sleepyTest, testEventRecorders));
     RunTests(output, &Filter::AllTests, tests, Time::ToDuration(Time::ToMilliseconds(1)), 0);
 
-    Assert.Equal(1U, output.events.size());
+    // the time limit failure, and a warning that the test had to be abandoned
+    Assert.Equal(2U, output.events.size());
     Assert.Equal(1U, output.summaryFailed);
 }
 
@@ -195,11 +208,105 @@ UNTIMED_FACT_FIXTURE("SlowTestFailsBecauseOfTimeLimitReportsReason", TestRunnerF
     tests.push_back(TestFactory(SleepyTest(), testEventRecorders));
     RunTests(output, &Filter::AllTests, tests, Time::ToDuration(Time::ToMilliseconds(1)), 0);
 
-    Assert.Equal(1U, output.events.size());
+    Assert.Equal(2U, output.events.size());
     Assert.Contains(to_string(std::get<1>(output.events[0])), "Test failed to complete within");
     Assert.Contains(to_string(std::get<1>(output.events[0])), "1 milliseconds.");
 }
 
+UNTIMED_FACT_FIXTURE("TestStillRunningAtTheEndIsReportedAsAbandoned", TestRunnerFixture)
+{
+    tests.push_back(TestFactory(SleepyTest(), testEventRecorders));
+    RunTests(output, &Filter::AllTests, tests, Time::ToDuration(Time::ToMilliseconds(1)), 0);
+
+    Assert.Equal(2U, output.events.size());
+    Assert.Equal(xUnitpp::EventLevel::Warning, std::get<1>(output.events[1]).GetLevel());
+    Assert.Contains(to_string(std::get<1>(output.events[1])), "still running");
+    Assert.Equal(1U, output.finishedTests.size());
+}
+
+UNTIMED_FACT_FIXTURE("SlowTestIsToldToCancel", TestRunnerFixture)
+{
+    auto cancelled = std::make_shared<std::atomic<bool>>(false);
+
+    tests.push_back(TestFactory([=]()
+        {
+            auto &token = xUnitpp::CancellationToken::Current();
+
+            for (auto stop = Time::Clock::now() + std::chrono::seconds(5); Time::Clock::now() < stop; std::this_thread::yield())
+            {
+                if (token.IsCancellationRequested())
+                {
+                    *cancelled = true;
+                    return;
+                }
+            }
+        }, testEventRecorders));
+
+    RunTests(output, &Filter::AllTests, tests, Time::ToDuration(Time::ToMilliseconds(1)), 0);
+
+    for (auto stop = Time::Clock::now() + std::chrono::seconds(5); !*cancelled && Time::Clock::now() < stop; )
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    Assert.True(*cancelled);
+}
+
+UNTIMED_FACT_FIXTURE("TimedTestsRunOnTheWorkerThreads", TestRunnerFixture)
+{
+    std::mutex lock;
+    std::set<std::thread::id> threads;
+
+    for (int i = 0; i != 8; ++i)
+    {
+        tests.push_back(TestFactory([&]()
+            {
+                std::lock_guard<std::mutex> guard(lock);
+                threads.insert(std::this_thread::get_id());
+            }, testEventRecorders));
+    }
+
+    RunTests(output, &Filter::AllTests, tests, Time::ToDuration(std::chrono::seconds(5)), 1);
+
+    Assert.Equal(8U, output.finishedTests.size());
+    Assert.Equal(1U, threads.size());
+}
+
+UNTIMED_FACT_FIXTURE("TimedOutWorkerIsReplaced", TestRunnerFixture)
+{
+    // with a single worker, the other tests can only run while the stuck test is stuck if its worker is replaced
+    auto lock = std::make_shared<std::mutex>();
+    auto released = std::make_shared<std::condition_variable>();
+    auto othersRun = std::make_shared<int>(0);
+
+    tests.push_back(TestFactory([=]()
+        {
+            std::unique_lock<std::mutex> guard(*lock);
+            released->wait_for(guard, std::chrono::seconds(5), [=]() { return *othersRun == 3; });
+        }, testEventRecorders).Name("stuck").Duration(Time::ToDuration(Time::ToMilliseconds(5))));
+
+    for (int i = 0; i != 3; ++i)
+    {
+        tests.push_back(TestFactory([=]()
+            {
+                std::lock_guard<std::mutex> guard(*lock);
+                ++*othersRun;
+                released->notify_all();
+            }, testEventRecorders).Duration(Time::ToDuration(Time::ToMilliseconds(0))));
+    }
+
+    auto start = Time::Clock::now();
+    RunTests(output, &Filter::AllTests, tests, duration, 1,
+        [](const xUnitpp::ITestDetails &testDetails)
+        {
+            return std::string(testDetails.GetName()) == "stuck" ? 1LL : 0LL;
+        });
+
+    Assert.True(Time::Clock::now() - start < std::chrono::seconds(4));
+    Assert.Equal(4U, output.finishedTests.size());
+    Assert.Equal(1U, output.summaryFailed);
+}
+
 UNTIMED_FACT_FIXTURE("SlowTestWithTimeExemptionPasses", TestRunnerFixture)
 {
     tests.push_back(TestFactory(SleepyTest(), testEventRecorders).Duration(Time::ToDuration(Time::ToMilliseconds(0))));
@@ -223,6 +330,337 @@ FACT_FIXTURE("FilteredTestsDoNotRun", TestRunnerFixture)
     Assert.Equal(0U, output.summaryCount);
 }
 
+FACT_FIXTURE("ConcurrentTestsAreLimitedByMaxConcurrent", TestRunnerFixture)
+{
+    std::atomic<int> running(0);
+    std::atomic<int> mostRunning(0);
+
+    for (int i = 0; i != 8; ++i)
+    {
+        tests.push_back(TestFactory([&]()
+            {
+                int now = ++running;
+
+                for (int most = mostRunning; now > most && !mostRunning.compare_exchange_weak(most, now); )
+                {
+                }
+
+                std::this_thread::sleep_for(std::chrono::milliseconds(5));
+                --running;
+            }, testEventRecorders));
+    }
+
+    RunTests(output, &Filter::AllTests, tests, duration, 2);
+
+    Assert.Equal(8U, output.finishedTests.size());
+    Assert.InRange((int)mostRunning, 1, 3);
+}
+
+FACT_FIXTURE("TestsShareAFixedNumberOfWorkerThreads", TestRunnerFixture)
+{
+    std::mutex lock;
+    std::set<std::thread::id> threads;
+
+    for (int i = 0; i != 32; ++i)
+    {
+        tests.push_back(TestFactory([&]()
+            {
+                std::lock_guard<std::mutex> guard(lock);
+                threads.insert(std::this_thread::get_id());
+            }, testEventRecorders));
+    }
+
+    RunTests(output, &Filter::AllTests, tests, duration, 3);
+
+    Assert.Equal(32U, output.finishedTests.size());
+    Assert.InRange(threads.size(), (size_t)1, (size_t)4);
+}
+
+FACT_FIXTURE("TestsFromOneSuiteRunTogether", TestRunnerFixture)
+{
+    std::vector<std::string> suiteOrder;
+
+    const char *suites[] = { "A", "B", "C" };
+    for (auto suite : suites)
+    {
+        for (int i = 0; i != 4; ++i)
+        {
+            std::string name = suite;
+            tests.push_back(TestFactory([&suiteOrder, name]() { suiteOrder.push_back(name); }, testEventRecorders).Suite(suite));
+        }
+    }
+
+    RunTests(output, &Filter::AllTests, tests, duration, 1);
+
+    Assert.Equal(12U, suiteOrder.size());
+    Assert.Equal(2, std::inner_product(suiteOrder.begin() + 1, suiteOrder.end(), suiteOrder.begin(), 0,
+        std::plus<int>(), [](const std::string &a, const std::string &b) { return a != b ? 1 : 0; }));
+}
+
+FACT_FIXTURE("IdleWorkersStealTestsFromBusyWorkers", TestRunnerFixture)
+{
+    // both tests belong to the same suite, so they are seeded onto the same worker
+    // they can only meet if the other worker steals one of them
+    std::mutex lock;
+    std::condition_variable arrived;
+    int waiting = 0;
+    int met = 0;
+
+    for (int i = 0; i != 2; ++i)
+    {
+        tests.push_back(TestFactory([&]()
+            {
+                std::unique_lock<std::mutex> guard(lock);
+                ++waiting;
+                arrived.notify_all();
+
+                if (arrived.wait_for(guard, std::chrono::seconds(1), [&]() { return waiting == 2; }))
+                {
+                    ++met;
+                }
+            }, testEventRecorders).Suite("same"));
+    }
+
+    RunTests(output, &Filter::AllTests, tests, duration, 2);
+
+    Assert.Equal(2, met);
+}
+
+FACT_FIXTURE("TestsWithTheLongestExpectedDurationRunFirst", TestRunnerFixture)
+{
+    const char *names[] = { "20", "10", "30" };
+    for (auto name : names)
+    {
+        tests.push_back(TestFactory(EmptyTest(), testEventRecorders).Name(name));
+    }
+
+    RunTests(output, &Filter::AllTests, tests, duration, 1,
+        [](const xUnitpp::ITestDetails &testDetails)
+        {
+            return std::stoll(testDetails.GetName());
+        });
+
+    Assert.Equal(3U, output.orderedTestList.size());
+    Assert.Equal("30", output.orderedTestList[0].Name);
+    Assert.Equal("20", output.orderedTestList[1].Name);
+    Assert.Equal("10", output.orderedTestList[2].Name);
+}
+
+FACT_FIXTURE("CostAttributeIsUsedWhenThereIsNoExpectedDuration", TestRunnerFixture)
+{
+    const char *costs[] = { "5", "", "50" };
+    for (auto cost : costs)
+    {
+        xUnitpp::AttributeCollection attributes;
+
+        if (*cost != '\0')
+        {
+            attributes.insert(std::make_pair("Cost", cost));
+        }
+
+        tests.push_back(TestFactory(EmptyTest(), testEventRecorders).Name(std::string("cost ") + cost).Attributes(attributes));
+    }
+
+    RunTests(output, &Filter::AllTests, tests, duration, 1,
+        [](const xUnitpp::ITestDetails &)
+        {
+            return -1LL;
+        });
+
+    Assert.Equal(3U, output.orderedTestList.size());
+    Assert.Equal("cost 50", output.orderedTestList[0].Name);
+    Assert.Equal("cost 5", output.orderedTestList[1].Name);
+    Assert.Equal("cost ", output.orderedTestList[2].Name);
+}
+
+UNTIMED_FACT_FIXTURE("TestsDoNotWaitForTheReporter", TestRunnerFixture)
+{
+    // holds up the first report until every test has run, or gives up after a while
+    struct SlowOutput : Tests::OutputRecord
+    {
+        SlowOutput(const std::atomic<int> &testsRun)
+            : testsRun(testsRun)
+            , first(true)
+        {
+        }
+
+        virtual void __stdcall ReportStart(const xUnitpp::ITestDetails &testDetails) override
+        {
+            if (first)
+            {
+                first = false;
+
+                auto giveUp = Time::Clock::now() + std::chrono::seconds(5);
+                while (testsRun != 8 && Time::Clock::now() < giveUp)
+                {
+                    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                }
+
+                testsRunBeforeFirstReport = testsRun;
+            }
+
+            Tests::OutputRecord::ReportStart(testDetails);
+        }
+
+        const std::atomic<int> &testsRun;
+        bool first;
+        int testsRunBeforeFirstReport;
+    };
+
+    std::atomic<int> testsRun(0);
+
+    for (int i = 0; i != 8; ++i)
+    {
+        tests.push_back(TestFactory([&]() { ++testsRun; }, testEventRecorders));
+    }
+
+    SlowOutput slowOutput(testsRun);
+    RunTests(slowOutput, &Filter::AllTests, tests, duration, 1);
+
+    Assert.Equal(8, slowOutput.testsRunBeforeFirstReport);
+    Assert.Equal(8U, slowOutput.orderedTestList.size());
+    Assert.Equal(8U, slowOutput.finishedTests.size());
+}
+
+UNTIMED_FACT_FIXTURE("A test over its TimeBudget only once is run again and passes", TestRunnerFixture)
+{
+    xUnitpp::AttributeCollection attributes;
+    attributes.insert(std::make_pair("TimeBudget", "10"));
+
+    int runs = 0;
+    tests.push_back(TestFactory([&]()
+        {
+            if (runs++ == 0)
+            {
+                std::this_thread::sleep_for(std::chrono::milliseconds(50));
+            }
+        }, testEventRecorders).Attributes(attributes));
+
+    Assert.Equal(0, RunTests(output, &Filter::AllTests, tests, duration, 0));
+    Assert.Empty(output.events);
+    Assert.Equal(4, runs);
+}
+
+UNTIMED_FACT_FIXTURE("A test that is always over its TimeBudget fails", TestRunnerFixture)
+{
+    xUnitpp::AttributeCollection attributes;
+    attributes.insert(std::make_pair("TimeBudget", "1"));
+
+    tests.push_back(TestFactory(SleepyTest(10), testEventRecorders).Attributes(attributes));
+
+    Assert.Equal(1, RunTests(output, &Filter::AllTests, tests, duration, 0));
+    Assert.Equal(1U, output.events.size());
+
+    const auto &assert = output.events[0].second.GetAssertInterface();
+    Assert.Equal("TimeBudget", assert.GetCall());
+    Assert.Contains(assert.GetExpected(), "median");
+    Assert.Contains(assert.GetActual(), "milliseconds, ");
+}
+
+namespace
+{
+    // stands in for the console's allocator hooks: tests "allocate" by bumping their thread's totals
+    thread_local xUnitpp::AllocationTotals fakeTotals;
+
+    class FakeAllocationCounter : public xUnitpp::IAllocationCounter
+    {
+    public:
+        FakeAllocationCounter()
+            : previous(xUnitpp::TestMetrics::GetAllocationCounter())
+        {
+            xUnitpp::TestMetrics::SetAllocationCounter(this);
+        }
+
+        ~FakeAllocationCounter()
+        {
+            xUnitpp::TestMetrics::SetAllocationCounter(previous);
+        }
+
+        virtual void __stdcall GetThreadTotals(xUnitpp::AllocationTotals &totals) const override
+        {
+            totals = fakeTotals;
+        }
+
+        virtual void __stdcall ResetPeak() override
+        {
+            fakeTotals.peakLiveBytes = fakeTotals.allocatedBytes - fakeTotals.freedBytes;
+        }
+
+    private:
+        xUnitpp::IAllocationCounter *previous;
+    };
+
+    long long FindMetric(const xUnitpp::ITestMetrics &metrics, const std::string &name)
+    {
+        for (size_t i = 0; i != metrics.GetCount(); ++i)
+        {
+            if (metrics.GetName(i) == name)
+            {
+                return metrics.GetValue(i);
+            }
+        }
+
+        return -1;
+    }
+}
+
+FACT_FIXTURE("Tests are charged for the allocations made on their thread", TestRunnerFixture)
+{
+    FakeAllocationCounter counter;
+
+    tests.push_back(TestFactory([]()
+        {
+            fakeTotals.allocations += 3;
+            fakeTotals.allocatedBytes += 96;
+            fakeTotals.peakLiveBytes = std::max(fakeTotals.peakLiveBytes, fakeTotals.allocatedBytes - fakeTotals.freedBytes);
+            fakeTotals.frees += 2;
+            fakeTotals.freedBytes += 64;
+        }, testEventRecorders));
+
+    RunTests(output, &Filter::AllTests, tests, duration, 1);
+
+    Assert.Equal(1U, output.metrics.size());
+
+    const auto &metrics = output.metrics[0].second;
+    Assert.Equal(3, FindMetric(metrics, "Allocations"));
+    Assert.Equal(96, FindMetric(metrics, "AllocatedBytes"));
+    Assert.Equal(2, FindMetric(metrics, "Frees"));
+    Assert.Equal(64, FindMetric(metrics, "FreedBytes"));
+    Assert.Equal(96, FindMetric(metrics, "PeakLiveBytes"));
+    Assert.Equal(32, FindMetric(metrics, "LeakedBytes"));
+}
+
+#if defined(__linux__)
+FACT_FIXTURE("Tests report the CPU time used by their thread", TestRunnerFixture)
+{
+    tests.push_back(TestFactory([]()
+        {
+            auto stop = Time::Clock::now() + std::chrono::milliseconds(5);
+            while (Time::Clock::now() < stop)
+            {
+            }
+        }, testEventRecorders).Name("busy"));
+    tests.push_back(TestFactory(SleepyTest(5), testEventRecorders).Name("sleepy"));
+
+    RunTests(output, &Filter::AllTests, tests, duration, 1);
+
+    Assert.Equal(2U, output.metrics.size());
+
+    long long busy = 0;
+    long long sleepy = 0;
+
+    for (const auto &result : output.metrics)
+    {
+        Assert.True(FindMetric(result.second, "VoluntaryContextSwitches") >= 0);
+        (result.first.Name == "busy" ? busy : sleepy) = FindMetric(result.second, "CpuTimeNs");
+    }
+
+    // other tests may be competing for the CPU, so the busy test is only known to have done more than the sleepy one
+    Assert.True(busy > sleepy) << busy << " vs. " << sleepy;
+    Assert.True(sleepy < std::chrono::nanoseconds(std::chrono::milliseconds(4)).count()) << sleepy;
+}
+#endif
+
 FACT_FIXTURE("Warnings are not failures", TestRunnerFixture)
 {
     tests.push_back(TestFactory([=]() { testWarn->Fail(); }, testEventRecorders));
@@ -232,4 +670,122 @@ FACT_FIXTURE("Warnings are not failures", TestRunnerFixture)
     Assert.Equal(0U, output.summaryFailed);
 }
 
+namespace
+{
+    // counts the most tests holding the budget at once
+    class CountingBudget : public xUnitpp::IThreadBudget
+    {
+    public:
+        CountingBudget(int size)
+            : available(size)
+            , taken(0)
+            , mostTaken(0)
+        {
+        }
+
+        virtual void __stdcall Acquire() override
+        {
+            std::unique_lock<std::mutex> guard(lock);
+            released.wait(guard, [&]() { return available != 0; });
+
+            --available;
+            mostTaken = std::max(mostTaken, ++taken);
+        }
+
+        virtual void __stdcall Release() override
+        {
+            {
+                std::lock_guard<std::mutex> guard(lock);
+                ++available;
+                --taken;
+            }
+
+            released.notify_one();
+        }
+
+        std::mutex lock;
+        std::condition_variable released;
+        int available;
+        int taken;
+        int mostTaken;
+    };
+
+    void CountRunning(std::atomic<int> &running, std::atomic<int> &mostRunning)
+    {
+        int now = ++running;
+
+        for (int most = mostRunning; now > most && !mostRunning.compare_exchange_weak(most, now); )
+        {
+        }
+
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        --running;
+    }
+}
+
+FACT_FIXTURE("Runs sharing a thread budget run no more tests than it allows between them", TestRunnerFixture)
+{
+    std::atomic<int> running(0);
+    std::atomic<int> mostRunning(0);
+
+    std::vector<std::shared_ptr<xUnitTest>> otherTests;
+
+    for (int i = 0; i != 6; ++i)
+    {
+        tests.push_back(TestFactory([&]() { CountRunning(running, mostRunning); }, testEventRecorders));
+        otherTests.push_back(TestFactory([&]() { CountRunning(running, mostRunning); }, testEventRecorders));
+    }
+
+    CountingBudget budget(2);
+    Tests::OutputRecord otherOutput;
+
+    std::thread other([&]() { RunTests(otherOutput, &Filter::AllTests, otherTests, duration, 4, nullptr, &budget); });
+    RunTests(output, &Filter::AllTests, tests, duration, 4, nullptr, &budget);
+    other.join();
+
+    Assert.Equal(6U, output.finishedTests.size());
+    Assert.Equal(6U, otherOutput.finishedTests.size());
+    Assert.InRange((int)mostRunning, 1, 3);
+    Assert.Equal(2, budget.mostTaken);
+    Assert.Equal(2, budget.available);
+}
+
+UNTIMED_FACT_FIXTURE("A timed out test gives back its share of the thread budget", TestRunnerFixture)
+{
+    auto lock = std::make_shared<std::mutex>();
+    auto released = std::make_shared<std::condition_variable>();
+    auto othersRun = std::make_shared<int>(0);
+
+    tests.push_back(TestFactory([=]()
+        {
+            std::unique_lock<std::mutex> guard(*lock);
+            released->wait_for(guard, std::chrono::seconds(5), [=]() { return *othersRun == 3; });
+        }, testEventRecorders).Name("stuck").Duration(Time::ToDuration(Time::ToMilliseconds(5))));
+
+    for (int i = 0; i != 3; ++i)
+    {
+        tests.push_back(TestFactory([=]()
+            {
+                std::lock_guard<std::mutex> guard(*lock);
+                ++*othersRun;
+                released->notify_all();
+            }, testEventRecorders).Duration(Time::ToDuration(Time::ToMilliseconds(0))));
+    }
+
+    // the budget only has room for one test, so the others can only run once the stuck test has given up its share
+    CountingBudget budget(1);
+
+    auto start = Time::Clock::now();
+    RunTests(output, &Filter::AllTests, tests, duration, 2,
+        [](const xUnitpp::ITestDetails &testDetails)
+        {
+            return std::string(testDetails.GetName()) == "stuck" ? 1LL : 0LL;
+        }, &budget);
+
+    Assert.True(Time::Clock::now() - start < std::chrono::seconds(4));
+    Assert.Equal(4U, output.finishedTests.size());
+    Assert.Equal(1U, output.summaryFailed);
+    Assert.Equal(1, budget.available);
+}
+
 }
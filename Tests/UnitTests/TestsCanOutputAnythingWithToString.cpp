@@ -100,4 +100,37 @@ FACT("Testing overloaded << operator")
     Check.True(true) << Point(0, 0);
 }
 
+namespace CountsToString
+{
+    struct Counted
+    {
+        friend std::string to_string(const Counted &)
+        {
+            ++Calls();
+            return "counted";
+        }
+
+        static int &Calls()
+        {
+            static int calls = 0;
+            return calls;
+        }
+    };
+}
+
+FACT("Messages are only formatted for failed asserts")
+{
+    using CountsToString::Counted;
+
+    Counted::Calls() = 0;
+
+    Assert.True(true) << Counted();
+    Check.Equal(0, 0) << "value " << Counted();
+    Assert.Equal(0, Counted::Calls());
+
+    auto result = Assert.Throws<xUnitpp::xUnitAssert>([]() { Assert.True(false) << Counted(); });
+    Check.Equal(1, Counted::Calls());
+    Check.Contains(result.UserMessage(), "counted");
+}
+
 }
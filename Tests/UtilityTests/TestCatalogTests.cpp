@@ -0,0 +1,204 @@
+#include <memory>
+#include <string>
+#include <tuple>
+#include <vector>
+#include "xUnit++/xUnit++.h"
+#include "xUnit++/TestCollection.h"
+#include "xUnit++/TestDescriptor.h"
+#include "CatalogTests.h"
+
+using xUnitpp::Utilities::CatalogBuilder;
+using xUnitpp::Utilities::CatalogTest;
+
+namespace
+{
+    const std::string &CatalogSuite()
+    {
+        static std::string suite = "Catalog";
+        return suite;
+    }
+
+    xUnitpp::AttributeCollection CatalogAttributes()
+    {
+        xUnitpp::AttributeCollection attributes;
+        attributes.insert(std::make_pair("Owner", "bob"));
+        attributes.insert(std::make_pair("Category", "fast"));
+        attributes.insert(std::make_pair("Category", "io"));
+        attributes.sort();
+        return attributes;
+    }
+
+    xUnitpp::AttributeCollection NoAttributes()
+    {
+        return xUnitpp::AttributeCollection();
+    }
+
+    void Fact()
+    {
+    }
+
+    void Row(int)
+    {
+    }
+
+    void Rows(const xUnitpp::TestDescriptor &descriptor, std::vector<std::shared_ptr<xUnitpp::xUnitTest>> &tests)
+    {
+        std::tuple<int> rows[] = { std::make_tuple(1), std::make_tuple(2) };
+        xUnitpp::TestCollection::Register::Theory(tests, &Row, xUnitpp::TheoryData(2, rows), descriptor);
+    }
+
+    const xUnitpp::TestDescriptor first = { "First", "", &CatalogSuite, &CatalogAttributes, -1, "catalog.cpp", 10, xUnitpp::SharedEventRecorders, &Fact, nullptr };
+    const xUnitpp::TestDescriptor second = { "Second", "", &CatalogSuite, &NoAttributes, -1, "catalog.cpp", 20, xUnitpp::SharedEventRecorders, &Fact, nullptr };
+    const xUnitpp::TestDescriptor theory = { "Theory", "(int row)", &CatalogSuite, &CatalogAttributes, -1, "catalog.cpp", 30, xUnitpp::SharedEventRecorders, nullptr, &Rows };
+
+    const xUnitpp::TestDescriptor *const descriptors[] = { &first, &second, &theory };
+
+    struct Details
+    {
+        Details(const xUnitpp::ITestDetails &td)
+            : id(td.GetId())
+            , instance(td.GetTestInstance())
+            , name(td.GetName())
+            , fullName(td.GetFullName())
+            , suite(td.GetSuite())
+            , params(td.GetParams())
+            , file(td.GetFile())
+            , line(td.GetLine())
+        {
+            for (size_t i = 0; i != td.GetAttributeCount(); ++i)
+            {
+                attributes.push_back(std::make_pair(std::string(td.GetAttributeKey(i)), std::string(td.GetAttributeValue(i))));
+            }
+        }
+
+        int id;
+        int instance;
+        std::string name;
+        std::string fullName;
+        std::string suite;
+        std::string params;
+        std::string file;
+        int line;
+        std::vector<std::pair<std::string, std::string>> attributes;
+    };
+}
+
+SUITE("CatalogTests")
+{
+
+struct Fixture
+{
+    Fixture()
+    {
+        collection.Describe(std::begin(descriptors), std::end(descriptors));
+    }
+
+    xUnitpp::TestCollection collection;
+};
+
+FACT_FIXTURE("The catalog has the same tests as enumerating them", Fixture)
+{
+    std::vector<Details> enumerated;
+    collection.EnumerateTestDetails([&](const xUnitpp::ITestDetails &td) { enumerated.push_back(Details(td)); });
+
+    const auto &catalog = collection.Catalog();
+
+    Assert.Equal(4U, enumerated.size());
+    Assert.Equal(enumerated.size(), catalog.testCount);
+
+    for (size_t i = 0; i != catalog.testCount; ++i)
+    {
+        Details catalogued(CatalogTest(catalog, catalog.tests[i]));
+
+        Assert.Equal(enumerated[i].id, catalogued.id);
+        Assert.Equal(enumerated[i].instance, catalogued.instance);
+        Assert.Equal(enumerated[i].name, catalogued.name);
+        Assert.Equal(enumerated[i].fullName, catalogued.fullName);
+        Assert.Equal(enumerated[i].suite, catalogued.suite);
+        Assert.Equal(enumerated[i].params, catalogued.params);
+        Assert.Equal(enumerated[i].file, catalogued.file);
+        Assert.Equal(enumerated[i].line, catalogued.line);
+        Assert.Equal(enumerated[i].attributes, catalogued.attributes);
+    }
+
+    Assert.Equal("Theory[1](row: 2)", std::string(catalog.strings + catalog.tests[3].fullName));
+}
+
+FACT_FIXTURE("A built catalog has the same tests as the library's", Fixture)
+{
+    const auto &catalog = collection.Catalog();
+
+    CatalogBuilder enumerated;
+    collection.EnumerateTestDetails([&](const xUnitpp::ITestDetails &td) { enumerated.Add(td); });
+
+    CatalogBuilder copied;
+    for (size_t i = 0; i != catalog.testCount; ++i)
+    {
+        copied.Add(catalog, catalog.tests[i]);
+    }
+
+    for (const auto &built : { enumerated.Catalog(), copied.Catalog() })
+    {
+        Assert.Equal(catalog.testCount, built.testCount);
+        Assert.Equal(catalog.attributeCount, built.attributeCount);
+
+        for (size_t i = 0; i != catalog.testCount; ++i)
+        {
+            Details expected(CatalogTest(catalog, catalog.tests[i]));
+            Details actual(CatalogTest(built, built.tests[i]));
+
+            Assert.Equal(expected.id, actual.id);
+            Assert.Equal(expected.instance, actual.instance);
+            Assert.Equal(expected.fullName, actual.fullName);
+            Assert.Equal(expected.suite, actual.suite);
+            Assert.Equal(expected.params, actual.params);
+            Assert.Equal(expected.line, actual.line);
+            Assert.Equal(expected.attributes, actual.attributes);
+        }
+
+        Assert.Equal(built.tests[0].suite, built.tests[3].suite);
+    }
+}
+
+FACT_FIXTURE("Catalog strings that repeat are stored once", Fixture)
+{
+    const auto &catalog = collection.Catalog();
+
+    Assert.Equal(4U, catalog.testCount);
+    Assert.Equal(catalog.tests[0].suite, catalog.tests[3].suite);
+    Assert.Equal(catalog.tests[0].file, catalog.tests[3].file);
+    Assert.Equal(catalog.tests[0].name, catalog.tests[0].fullName);
+    Assert.Equal(0U, catalog.tests[1].params);
+    Assert.Equal(0U, catalog.tests[1].attributeCount);
+    Assert.Equal('\0', catalog.strings[0]);
+    Assert.Equal('\0', catalog.strings[catalog.stringsSize - 1]);
+}
+
+FACT_FIXTURE("Catalog tests find their attributes", Fixture)
+{
+    const auto &catalog = collection.Catalog();
+
+    CatalogTest td(catalog, catalog.tests[0]);
+
+    size_t begin, end;
+    td.FindAttributeKey("Category", begin, end);
+    Assert.Equal(0U, begin);
+    Assert.Equal(2U, end);
+
+    td.FindAttributeKey("Owner", begin, end);
+    Assert.Equal(1U, end - begin);
+    Assert.Equal("bob", std::string(td.GetAttributeValue(begin)));
+
+    td.FindAttributeKey("Missing", begin, end);
+    Assert.Equal(begin, end);
+
+    CatalogTest(catalog, catalog.tests[1]).FindAttributeKey("Category", begin, end);
+    Assert.Equal(begin, end);
+}
+
+FACT_FIXTURE("The catalog is only made once", Fixture)
+{
+    Assert.Same(collection.Catalog(), collection.Catalog());
+}
+
+}
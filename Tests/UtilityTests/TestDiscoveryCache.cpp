@@ -0,0 +1,177 @@
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include "xUnit++/xUnit++.h"
+#include "xUnit++/TestDetails.h"
+#include "DiscoveryCache.h"
+#include "Helpers/DetailsFactory.h"
+
+using xUnitpp::Utilities::DiscoveryCache;
+using xUnitpp::Tests::Details;
+
+namespace
+{
+    DiscoveryCache::Stamp MakeStamp(unsigned long long size, long long modified, unsigned long long hash)
+    {
+        DiscoveryCache::Stamp stamp;
+        stamp.size = size;
+        stamp.modified = modified;
+        stamp.hash = hash;
+        return stamp;
+    }
+
+    std::string Saved(const DiscoveryCache::Stamp &stamp)
+    {
+        // a theory's row, so that every field has something to round trip
+        xUnitpp::AttributeCollection attributes;
+        attributes.insert(std::make_pair("Owner", "bob"));
+        attributes.insert(std::make_pair("Category", "fast"));
+        attributes.insert(std::make_pair("Category", "io"));
+        attributes.sort();
+
+        xUnitpp::TestDetails details(std::string("Name"), 7, "(1, 2)", "Suite", std::move(attributes), xUnitpp::Time::Duration::zero(), "file.cpp", 42);
+
+        DiscoveryCache cache;
+        cache.Record(details);
+
+        std::stringstream stream;
+        cache.Save(stream, stamp);
+        return stream.str();
+    }
+}
+
+SUITE("DiscoveryCache")
+{
+
+FACT("DiscoveryCache round trips test details")
+{
+    std::stringstream stream(Saved(MakeStamp(100, 5, 9)));
+
+    DiscoveryCache cache;
+    Assert.True(cache.Load(stream, MakeStamp(100, 5, 9)));
+
+    auto catalog = cache.Catalog();
+    Assert.Equal(1U, catalog.testCount);
+
+    const auto &test = catalog.tests[0];
+    Assert.Equal(7, test.testInstance);
+    Assert.Equal("Name", std::string(catalog.strings + test.name));
+    Assert.Equal("Suite", std::string(catalog.strings + test.suite));
+    Assert.Equal("(1, 2)", std::string(catalog.strings + test.params));
+    Assert.Equal("file.cpp", std::string(catalog.strings + test.file));
+    Assert.Equal(42, test.line);
+    Assert.Equal(3U, test.attributeCount);
+}
+
+FACT("DiscoveryCache rejects a library of a different size")
+{
+    std::stringstream stream(Saved(MakeStamp(100, 5, 9)));
+
+    DiscoveryCache cache;
+    Assert.False(cache.Load(stream, MakeStamp(101, 5, 9)));
+    Assert.Equal(0U, cache.Catalog().testCount);
+}
+
+FACT("DiscoveryCache accepts a touched library with the same content")
+{
+    std::stringstream stream(Saved(MakeStamp(100, 5, 9)));
+
+    DiscoveryCache cache;
+    Assert.True(cache.Load(stream, MakeStamp(100, 6, 9)));
+}
+
+FACT("DiscoveryCache rejects a rebuilt library")
+{
+    std::stringstream stream(Saved(MakeStamp(100, 5, 9)));
+
+    DiscoveryCache cache;
+    Assert.False(cache.Load(stream, MakeStamp(100, 6, 10)));
+}
+
+FACT("DiscoveryCache rejects anything else")
+{
+    std::stringstream stream("not a discovery cache");
+
+    DiscoveryCache cache;
+    Assert.False(cache.Load(stream, MakeStamp(100, 5, 9)));
+}
+
+FACT("DiscoveryCache rejects a damaged string length")
+{
+    // the first test's name length follows the header, id and instance
+    auto saved = Saved(MakeStamp(100, 5, 9));
+    saved.replace(40, 4, 4, '\xff');
+    std::stringstream stream(saved);
+
+    DiscoveryCache cache;
+    Assert.False(cache.Load(stream, MakeStamp(100, 5, 9)));
+}
+
+FACT("Cached tests find their attributes")
+{
+    std::stringstream stream(Saved(MakeStamp(100, 5, 9)));
+
+    DiscoveryCache cache;
+    cache.Load(stream, MakeStamp(100, 5, 9));
+
+    auto catalog = cache.Catalog();
+
+    auto range = xUnitpp::Utilities::FindAttributes(catalog, catalog.tests[0], "Category");
+    Assert.Equal(2, range.second - range.first);
+    Assert.Equal("Category", std::string(catalog.strings + range.first->key));
+
+    range = xUnitpp::Utilities::FindAttributes(catalog, catalog.tests[0], "Missing");
+    Assert.True(range.first == range.second);
+}
+
+FACT("DiscoveryCache files follow their library")
+{
+    std::string library = "discovery-cache-test.bin";
+    std::string file = library + ".xudiscovery";
+
+    {
+        std::ofstream output(library, std::ios::binary);
+        output << "first build";
+    }
+
+    DiscoveryCache saved;
+    saved.Record(*Details("Name", "Suite"));
+    Assert.True(saved.Save(file, library));
+
+    DiscoveryCache loaded;
+    Assert.True(loaded.Load(file, library));
+    Assert.Equal(1U, loaded.Catalog().testCount);
+
+    {
+        std::ofstream output(library, std::ios::binary);
+        output << "first build";
+    }
+
+    // the same content with a new time still loads, and the cache takes on the new time
+    DiscoveryCache touched;
+    Assert.True(touched.Load(file, library));
+
+    DiscoveryCache::Stamp stamp;
+    Assert.True(DiscoveryCache::StampFile(library, stamp, false));
+
+    {
+        std::ifstream input(file, std::ios::binary);
+        DiscoveryCache restamped;
+        Assert.True(restamped.Load(input, MakeStamp(stamp.size, stamp.modified, 0)));
+    }
+
+    {
+        std::ofstream output(library, std::ios::binary);
+        output << "second build";
+    }
+
+    DiscoveryCache stale;
+    Assert.False(stale.Load(file, library));
+
+    std::remove(file.c_str());
+    std::remove(library.c_str());
+}
+
+}
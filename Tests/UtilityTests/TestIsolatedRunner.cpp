@@ -0,0 +1,172 @@
+#if !defined(WIN32)
+
+#include <chrono>
+#include <cstdlib>
+#include <memory>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <vector>
+#include "xUnit++/EventLevel.h"
+#include "xUnit++/IOutput.h"
+#include "xUnit++/ITestDetails.h"
+#include "xUnit++/ITestEvent.h"
+#include "xUnit++/xUnit++.h"
+#include "xUnit++/xUnitTestRunner.h"
+#include "IsolatedRunner.h"
+#include "Helpers/TestFactory.h"
+
+using xUnitpp::Utilities::RunIsolated;
+using xUnitpp::Tests::TestFactory;
+
+namespace
+{
+    //
+    // RunIsolated takes a plain function pointer, just like the one exported from a test library,
+    // so each fact gets its own set of tests to run.
+    template<int Fact>
+    struct LocalTests
+    {
+        static std::vector<std::shared_ptr<xUnitpp::xUnitTest>> &Tests()
+        {
+            static std::vector<std::shared_ptr<xUnitpp::xUnitTest>> tests;
+            return tests;
+        }
+
+        static std::vector<const xUnitpp::ITestDetails *> Details()
+        {
+            std::vector<const xUnitpp::ITestDetails *> details;
+
+            for (const auto &test : Tests())
+            {
+                details.push_back(&test->TestDetails());
+            }
+
+            return details;
+        }
+
+        static int Run(int timeLimit, int threadLimit, xUnitpp::IOutput &output, xUnitpp::TestFilterCallback filter)
+        {
+            // tests named "first" always start first
+            return xUnitpp::RunTests(output, filter, Tests(), xUnitpp::Time::ToDuration(xUnitpp::Time::ToMilliseconds(timeLimit)), threadLimit,
+                [](const xUnitpp::ITestDetails &testDetails)
+                {
+                    return std::string(testDetails.GetName()) == "first" ? 1LL : 0LL;
+                });
+        }
+    };
+
+    // events replayed by the parent aren't xUnitpp::TestEvents, so only the interfaces can be recorded
+    class EventRecord : public xUnitpp::IOutput
+    {
+    public:
+        EventRecord()
+            : summaryCount(0)
+            , summaryFailed(0)
+        {
+        }
+
+        virtual void __stdcall ReportStart(const xUnitpp::ITestDetails &) override
+        {
+        }
+
+        virtual void __stdcall ReportEvent(const xUnitpp::ITestDetails &testDetails, const xUnitpp::ITestEvent &evt) override
+        {
+            events.push_back(std::make_tuple(std::string(testDetails.GetName()), evt.GetLevel(), std::string(evt.GetToString())));
+        }
+
+        virtual void __stdcall ReportSkip(const xUnitpp::ITestDetails &, const char *) override
+        {
+        }
+
+        virtual void __stdcall ReportFinish(const xUnitpp::ITestDetails &testDetails, long long) override
+        {
+            finishedTests.push_back(testDetails.GetName());
+        }
+
+        virtual void __stdcall ReportAllTestsComplete(size_t testCount, size_t, size_t failed, long long) override
+        {
+            summaryCount = testCount;
+            summaryFailed = failed;
+        }
+
+        std::vector<std::tuple<std::string, xUnitpp::EventLevel, std::string>> events;
+        std::vector<std::string> finishedTests;
+        size_t summaryCount;
+        size_t summaryFailed;
+    };
+}
+
+SUITE("IsolatedRunner")
+{
+
+FACT("Events from isolated tests are replayed")
+{
+    typedef LocalTests<0> Local;
+
+    Local::Tests().push_back(TestFactory([]() { }).Name("passes"));
+    Local::Tests().push_back(TestFactory([]() { Assert.Equal(1, 2); }).Name("fails"));
+
+    EventRecord record;
+    auto failures = RunIsolated(&Local::Run, Local::Details(), 0, 2, 1, record);
+
+    Assert.Equal(1, failures);
+    Assert.Equal(2U, record.summaryCount);
+    Assert.Equal(1U, record.summaryFailed);
+    Assert.Equal(2U, record.finishedTests.size());
+    Assert.Equal(1U, record.events.size());
+    Assert.Equal("fails", std::get<0>(record.events[0]));
+    Assert.Equal(xUnitpp::EventLevel::Assert, std::get<1>(record.events[0]));
+    Assert.Contains(std::get<2>(record.events[0]), "Assert.Equal() failure");
+}
+
+FACT("A test that crashes its process fails without stopping its batch")
+{
+    typedef LocalTests<1> Local;
+
+    Local::Tests().push_back(TestFactory([]() { std::abort(); }).Name("crashes"));
+
+    for (int i = 0; i != 3; ++i)
+    {
+        Local::Tests().push_back(TestFactory([]() { }).Name("passes"));
+    }
+
+    EventRecord record;
+    RunIsolated(&Local::Run, Local::Details(), 0, 1, 4, record);
+
+    Assert.Equal(4U, record.summaryCount);
+    Assert.Equal(1U, record.summaryFailed);
+    Assert.Equal(1U, record.events.size());
+    Assert.Equal("crashes", std::get<0>(record.events[0]));
+    Assert.Equal(xUnitpp::EventLevel::Fatal, std::get<1>(record.events[0]));
+    Assert.Contains(std::get<2>(record.events[0]), "signal");
+}
+
+FACT("A test that ignores its time limit has its process killed")
+{
+    typedef LocalTests<2> Local;
+
+    // the slow test is still running on the replacement worker when the process is killed, so it is run again
+    Local::Tests().push_back(TestFactory([]() { std::this_thread::sleep_for(std::chrono::seconds(10)); }).Name("first"));
+    Local::Tests().push_back(TestFactory([]() { std::this_thread::sleep_for(std::chrono::milliseconds(500)); }).Name("slow")
+        .Duration(xUnitpp::Time::Duration::zero()));
+
+    EventRecord record;
+
+    auto start = xUnitpp::Time::Clock::now();
+    RunIsolated(&Local::Run, Local::Details(), 10, 1, 2, record);
+
+    Assert.True(xUnitpp::Time::Clock::now() - start < std::chrono::seconds(5));
+    Assert.Equal(2U, record.summaryCount);
+    Assert.Equal(1U, record.summaryFailed);
+    Assert.Equal(2U, record.finishedTests.size());
+    Assert.Equal(2U, record.events.size());
+    Assert.Equal("first", std::get<0>(record.events[1]));
+    Assert.Equal(xUnitpp::EventLevel::Fatal, std::get<1>(record.events[0]));
+    Assert.Equal(xUnitpp::EventLevel::Warning, std::get<1>(record.events[1]));
+    Assert.Contains(std::get<2>(record.events[1]), "killed");
+}
+
+}
+
+#endif
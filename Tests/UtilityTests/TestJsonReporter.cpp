@@ -0,0 +1,98 @@
+#include <sstream>
+#include <string>
+#include <vector>
+#include "xUnit++/xUnit++.h"
+#include "xUnit++/xUnitTestRunner.h"
+#include "JsonReporter.h"
+#include "Helpers/DetailsFactory.h"
+#include "Helpers/TestFactory.h"
+
+using xUnitpp::Utilities::JsonReporter;
+using xUnitpp::Tests::AllTests;
+using xUnitpp::Tests::TestFactory;
+
+namespace
+{
+    std::vector<std::string> Lines(const std::string &text)
+    {
+        std::vector<std::string> lines;
+
+        std::istringstream stream(text);
+        for (std::string line; std::getline(stream, line); )
+        {
+            // how many metrics there are depends on the platform
+            if (line.find("\"type\":\"metrics\"") == std::string::npos)
+            {
+                lines.push_back(line);
+            }
+        }
+
+        return lines;
+    }
+}
+
+SUITE("JsonReporter")
+{
+
+FACT("JsonReporter writes one object per report")
+{
+    std::vector<std::shared_ptr<xUnitpp::xUnitTest>> tests;
+    tests.push_back(TestFactory([]() { Assert.Fail() << "\"quoted\"\n"; }).Name("Fails"));
+
+    std::stringstream out;
+
+    JsonReporter reporter(out);
+    xUnitpp::RunTests(reporter, &AllTests, tests, xUnitpp::Time::Duration::zero(), 0);
+
+    auto lines = Lines(out.str());
+
+    Assert.Equal(4U, lines.size());
+    Assert.Equal(0U, lines[0].find("{\"type\":\"start\",\"id\":"));
+    Assert.Equal(0U, lines[1].find("{\"type\":\"event\","));
+    Assert.Equal(0U, lines[2].find("{\"type\":\"finish\","));
+    Assert.Equal(0U, lines[3].find("{\"type\":\"summary\",\"tests\":1,\"skipped\":0,\"failures\":1,"));
+
+    Assert.Contains(lines[0], "\"name\":\"Fails\"");
+    Assert.Contains(lines[1], "\"failure\":true");
+    Assert.Contains(lines[1], "\\\"quoted\\\"\\n");
+
+    for (const auto &line : lines)
+    {
+        Assert.Equal('}', line.back());
+    }
+}
+
+FACT("JsonReporter names the library in every object when given one")
+{
+    std::vector<std::shared_ptr<xUnitpp::xUnitTest>> tests;
+    tests.push_back(TestFactory([]() { }).Name("Passes"));
+
+    std::stringstream out;
+
+    JsonReporter reporter(out, "Library.so");
+    xUnitpp::RunTests(reporter, &AllTests, tests, xUnitpp::Time::Duration::zero(), 0);
+
+    auto lines = Lines(out.str());
+
+    Assert.Equal(3U, lines.size());
+
+    for (const auto &line : lines)
+    {
+        Assert.Contains(line, "\"library\":\"Library.so\"");
+    }
+}
+
+FACT("JsonReporter reports skipped tests with their reason")
+{
+    std::shared_ptr<xUnitpp::xUnitTest> test = TestFactory([]() { }).Name("Skipped");
+
+    std::stringstream out;
+
+    JsonReporter reporter(out);
+    reporter.ReportSkip(test->TestDetails(), "not\tyet");
+
+    Assert.Contains(out.str(), "\"type\":\"skip\"");
+    Assert.Contains(out.str(), "\"reason\":\"not\\tyet\"}\n");
+}
+
+}
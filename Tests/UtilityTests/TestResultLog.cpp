@@ -0,0 +1,204 @@
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "xUnit++/xUnit++.h"
+#include "xUnit++/TestEvent.h"
+#include "xUnit++/xUnitTestRunner.h"
+#include "ResultLog.h"
+#include "Helpers/DetailsFactory.h"
+#include "Helpers/TestFactory.h"
+
+using xUnitpp::Utilities::CompareResultLogs;
+using xUnitpp::Utilities::ResultLog;
+using xUnitpp::Utilities::ResultLogWriter;
+using xUnitpp::Tests::AllTests;
+using xUnitpp::Tests::TestFactory;
+
+namespace
+{
+    void Record(const std::vector<std::shared_ptr<xUnitpp::xUnitTest>> &tests, ResultLog &log)
+    {
+        std::stringstream stream;
+
+        {
+            ResultLogWriter writer(stream);
+            xUnitpp::RunTests(writer, &AllTests, tests, xUnitpp::Time::Duration::zero(), 0);
+        }
+
+        log.Load(stream);
+    }
+}
+
+SUITE("ResultLog")
+{
+
+FACT("A result log reads back what was written")
+{
+    std::vector<std::shared_ptr<xUnitpp::xUnitTest>> tests;
+    tests.push_back(TestFactory([]() { }).Name("passes").Suite("Log"));
+    tests.push_back(TestFactory([]() { Assert.Fail() << "broken"; }).Name("fails").Suite("Log"));
+
+    ResultLog log;
+    Record(tests, log);
+
+    Assert.False(log.Truncated());
+    Assert.Equal(2U, log.Tests().size());
+
+    for (const auto &test : log.Tests())
+    {
+        Assert.Equal("Log", test.suite.str());
+
+        if (test.name.str() == "passes")
+        {
+            Assert.Equal(ResultLog::Test::Success, test.result);
+        }
+        else
+        {
+            Assert.Equal("fails", test.name.str());
+            Assert.Equal(ResultLog::Test::Failure, test.result);
+        }
+    }
+
+    Assert.Equal(1U, log.Events().size());
+    Assert.True(log.Events()[0].failure);
+    Assert.Contains(log.Events()[0].message.str(), "broken");
+}
+
+FACT("A result log reads back the runs of several libraries")
+{
+    std::vector<std::shared_ptr<xUnitpp::xUnitTest>> firstTests;
+    firstTests.push_back(TestFactory([]() { }).Name("first").Suite("Library1"));
+
+    std::vector<std::shared_ptr<xUnitpp::xUnitTest>> secondTests;
+    secondTests.push_back(TestFactory([]() { }).Name("second").Suite("Library2"));
+    secondTests.push_back(TestFactory([]() { Assert.Fail(); }).Name("third").Suite("Library2"));
+
+    std::stringstream stream;
+
+    {
+        ResultLogWriter writer(stream);
+        xUnitpp::RunTests(writer, &AllTests, firstTests, xUnitpp::Time::Duration::zero(), 0);
+        xUnitpp::RunTests(writer, &AllTests, secondTests, xUnitpp::Time::Duration::zero(), 0);
+    }
+
+    ResultLog log;
+    Assert.True(log.Load(stream));
+    Assert.Equal(3U, log.Tests().size());
+
+    for (const auto &test : log.Tests())
+    {
+        Assert.Equal(test.name.str() == "third" ? ResultLog::Test::Failure : ResultLog::Test::Success, test.result) << test.name.str();
+    }
+}
+
+FACT("A result log keeps apart the sections of libraries running at the same time")
+{
+    std::shared_ptr<xUnitpp::xUnitTest> test = TestFactory([]() { }).Name("shared").Suite("Log");
+    std::shared_ptr<xUnitpp::xUnitTest> later = TestFactory([]() { }).Name("later").Suite("Log");
+
+    std::stringstream stream;
+
+    {
+        // both libraries report a test with the same id, and one finishes its run while the other is still going
+        ResultLogWriter writer(stream);
+        auto section = writer.AddSection();
+
+        writer.ReportStart(test->TestDetails());
+        section->ReportStart(test->TestDetails());
+        section->ReportEvent(test->TestDetails(), xUnitpp::TestEvent(xUnitpp::EventLevel::Warning, "from the section"));
+        section->ReportSkip(test->TestDetails(), "other library");
+        section->ReportAllTestsComplete(1, 1, 0, 0);
+        writer.ReportStart(later->TestDetails());
+        writer.ReportFinish(test->TestDetails(), 1000);
+        writer.ReportFinish(later->TestDetails(), 2000);
+        writer.ReportAllTestsComplete(2, 0, 0, 3000);
+    }
+
+    ResultLog log;
+    Assert.True(log.Load(stream));
+    Assert.False(log.Truncated());
+    Assert.Equal(3U, log.Tests().size());
+
+    Assert.Equal(ResultLog::Test::Success, log.Tests()[0].result);
+    Assert.Equal(1000, log.Tests()[0].ns);
+    Assert.Equal(ResultLog::Test::Skipped, log.Tests()[1].result);
+    Assert.Equal("other library", log.Tests()[1].skipReason.str());
+    Assert.Equal("later", log.Tests()[2].name.str());
+    Assert.Equal(2000, log.Tests()[2].ns);
+
+    Assert.Equal(1U, log.Events().size());
+    Assert.Equal(1U, log.Events()[0].test);
+    Assert.Equal(xUnitpp::EventLevel::Warning, log.Events()[0].level);
+    Assert.False(log.Events()[0].failure);
+    Assert.Contains(log.Events()[0].message.str(), "from the section");
+}
+
+FACT("A truncated result log keeps the tests before the damage")
+{
+    std::stringstream stream;
+
+    {
+        std::shared_ptr<xUnitpp::xUnitTest> test = TestFactory([]() { }).Name("started");
+
+        ResultLogWriter writer(stream);
+        writer.ReportStart(test->TestDetails());
+        writer.ReportFinish(test->TestDetails(), 1000);
+    }
+
+    auto data = stream.str();
+    std::stringstream truncated(data.substr(0, data.size() - 1));
+
+    ResultLog log;
+    Assert.True(log.Load(truncated));
+    Assert.True(log.Truncated());
+    Assert.Equal(1U, log.Tests().size());
+    Assert.Equal(ResultLog::Test::Unfinished, log.Tests()[0].result);
+}
+
+FACT("A result log that isn't one is rejected")
+{
+    std::stringstream stream("not a result log");
+
+    ResultLog log;
+    Assert.False(log.Load(stream));
+}
+
+FACT("Comparing result logs finds new failures, fixes and duration changes")
+{
+    std::vector<std::shared_ptr<xUnitpp::xUnitTest>> beforeTests;
+    beforeTests.push_back(TestFactory([]() { }).Name("breaks").Suite("Diff"));
+    beforeTests.push_back(TestFactory([]() { Assert.Fail(); }).Name("gets fixed").Suite("Diff"));
+    beforeTests.push_back(TestFactory([]() { }).Name("removed").Suite("Diff"));
+
+    std::vector<std::shared_ptr<xUnitpp::xUnitTest>> afterTests;
+    afterTests.push_back(TestFactory([]() { }).Name("added").Suite("Diff"));
+    afterTests.push_back(TestFactory([]() { }).Name("gets fixed").Suite("Diff"));
+    afterTests.push_back(TestFactory([]() { Assert.Fail(); }).Name("breaks").Suite("Diff"));
+
+    ResultLog before;
+    Record(beforeTests, before);
+
+    ResultLog after;
+    Record(afterTests, after);
+
+    // every matched test that ran is a duration change at a threshold of zero
+    auto diff = CompareResultLogs(before, after, 0);
+
+    Assert.Equal(1U, diff.newFailures.size());
+    Assert.Equal("breaks", after.Tests()[diff.newFailures[0].after].name.str());
+    Assert.Equal("breaks", before.Tests()[diff.newFailures[0].before].name.str());
+
+    Assert.Equal(1U, diff.fixed.size());
+    Assert.Equal("gets fixed", after.Tests()[diff.fixed[0].after].name.str());
+
+    Assert.Equal(1U, diff.added.size());
+    Assert.Equal("added", after.Tests()[diff.added[0]].name.str());
+
+    Assert.Equal(1U, diff.removed.size());
+    Assert.Equal("removed", before.Tests()[diff.removed[0]].name.str());
+
+    Assert.Equal(2U, diff.durationChanges.size());
+}
+
+}
@@ -0,0 +1,159 @@
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <thread>
+#include "xUnit++/xUnit++.h"
+#include "ShadowCopy.h"
+
+#if defined(WIN32)
+#include <Windows.h>
+#else
+#include <dirent.h>
+#include <unistd.h>
+#endif
+
+using xUnitpp::Utilities::ShadowCopy;
+using xUnitpp::Utilities::ShadowCopyCache;
+
+namespace
+{
+    void Write(const std::string &file, const std::string &content)
+    {
+        std::ofstream output(file, std::ios::binary | std::ios::trunc);
+        output << content;
+    }
+
+    std::string Read(const std::string &file)
+    {
+        std::ifstream input(file, std::ios::binary);
+        return std::string(std::istreambuf_iterator<char>(input), std::istreambuf_iterator<char>());
+    }
+
+    // bigger than any single read, so the copy has to loop
+    std::string Content(char seed)
+    {
+        std::string content(200000, '\0');
+
+        for (size_t i = 0; i != content.size(); ++i)
+        {
+            content[i] = (char)(seed + i * 31);
+        }
+
+        return content;
+    }
+
+    void RemoveDirectory(const std::string &directory)
+    {
+#if defined(WIN32)
+        WIN32_FIND_DATA found;
+        auto find = FindFirstFile((directory + "\\*").c_str(), &found);
+
+        if (find != INVALID_HANDLE_VALUE)
+        {
+            do
+            {
+                DeleteFile((directory + "\\" + found.cFileName).c_str());
+            } while (FindNextFile(find, &found));
+
+            FindClose(find);
+        }
+
+        ::RemoveDirectory(directory.c_str());
+#else
+        if (auto dir = opendir(directory.c_str()))
+        {
+            while (auto entry = readdir(dir))
+            {
+                std::remove((directory + "/" + entry->d_name).c_str());
+            }
+
+            closedir(dir);
+        }
+
+        rmdir(directory.c_str());
+#endif
+    }
+}
+
+SUITE("ShadowCopy")
+{
+
+FACT("ShadowCopy copies the whole file")
+{
+    std::string library = "shadow-copy-test.bin";
+    Write(library, Content(1));
+
+    auto copy = ShadowCopy(library, ".");
+
+    Assert.NotEqual(std::string(), copy);
+    Assert.NotEqual(library, copy);
+    Assert.Equal(Content(1), Read(copy));
+
+    std::remove(copy.c_str());
+    std::remove(library.c_str());
+}
+
+FACT("ShadowCopy of a missing file fails")
+{
+    Assert.Equal(std::string(), ShadowCopy("shadow-copy-missing.bin", "."));
+}
+
+FACT("ShadowCopyCache reuses the copy of an unchanged library")
+{
+    std::string directory = "shadow-cache-reuse";
+    std::string library = "shadow-cache-reuse.so";
+    Write(library, Content(2));
+
+    ShadowCopyCache cache(directory);
+
+    auto first = cache.Copy(library);
+    Assert.NotEqual(std::string(), first);
+    Assert.Equal(".so", first.substr(first.size() - 3));
+    Assert.Equal(Content(2), Read(first));
+
+    Assert.Equal(first, cache.Copy(library));
+
+    // touched, but with the same content
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    Write(library, Content(2));
+
+    Assert.Equal(first, cache.Copy(library));
+
+    std::remove(library.c_str());
+    RemoveDirectory(directory);
+}
+
+FACT("ShadowCopyCache copies a rebuilt library and forgets the old copy")
+{
+    std::string directory = "shadow-cache-rebuilt";
+    std::string library = "shadow-cache-rebuilt.so";
+    Write(library, Content(3));
+
+    ShadowCopyCache cache(directory);
+
+    auto first = cache.Copy(library);
+
+    Write(library, Content(4) + "rebuilt");
+
+    auto second = cache.Copy(library);
+    Assert.NotEqual(std::string(), second);
+    Assert.NotEqual(first, second);
+    Assert.Equal(Content(4) + "rebuilt", Read(second));
+    Assert.False((bool)std::ifstream(first, std::ios::binary));
+
+    std::remove(library.c_str());
+    RemoveDirectory(directory);
+}
+
+FACT("ShadowCopyCache of a missing library fails")
+{
+    std::string directory = "shadow-cache-missing";
+
+    Assert.Equal(std::string(), ShadowCopyCache(directory).Copy("shadow-cache-missing.so"));
+
+    RemoveDirectory(directory);
+}
+
+}
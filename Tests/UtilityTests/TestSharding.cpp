@@ -0,0 +1,103 @@
+#include <memory>
+#include <string>
+#include <vector>
+#include "xUnit++/xUnit++.h"
+#include "xUnit++/TestDetails.h"
+#include "CatalogTests.h"
+#include "Sharding.h"
+#include "Helpers/DetailsFactory.h"
+
+using xUnitpp::Tests::Details;
+
+namespace
+{
+    unsigned long long HashOf(const std::string &name, const std::string &suite = "suite")
+    {
+        xUnitpp::Utilities::CatalogBuilder builder;
+        builder.Add(*Details(name, suite));
+
+        auto catalog = builder.Catalog();
+        return xUnitpp::Utilities::StableTestHash(catalog, catalog.tests[0]);
+    }
+
+    struct ShardingFixture
+    {
+        ShardingFixture()
+        {
+            for (int i = 0; i != 40; ++i)
+            {
+                builder.Add(*Details("test " + std::to_string(i)));
+            }
+
+            catalog = builder.Catalog();
+
+            for (size_t i = 0; i != catalog.testCount; ++i)
+            {
+                tests.push_back(&catalog.tests[i]);
+            }
+        }
+
+        xUnitpp::Utilities::CatalogBuilder builder;
+        xUnitpp::TestCatalog catalog;
+        std::vector<const xUnitpp::TestCatalogEntry *> tests;
+    };
+}
+
+SUITE("Sharding")
+{
+
+FACT("Test hashes depend only on suite and name")
+{
+    // pinned: shards must agree between machines, builds and releases
+    Assert.Equal(0xdffeba178976276eULL, HashOf("name", "suite"));
+    Assert.Equal(HashOf("name"), HashOf("name"));
+    Assert.NotEqual(HashOf("bc", "a"), HashOf("c", "ab"));
+}
+
+FACT_FIXTURE("Hash shards cover every test exactly once", ShardingFixture)
+{
+    auto shards = xUnitpp::Utilities::HashShards(catalog, tests, 4);
+
+    Assert.Equal(tests.size(), shards.size());
+
+    std::vector<int> counts(4, 0);
+    for (auto shard : shards)
+    {
+        Assert.InRange(shard, (size_t)0, (size_t)4);
+        ++counts[shard];
+    }
+
+    for (auto count : counts)
+    {
+        Assert.NotEqual(0, count);
+    }
+}
+
+FACT_FIXTURE("Duration shards balance expected time", ShardingFixture)
+{
+    // one very long test, and many short ones
+    auto shards = xUnitpp::Utilities::DurationShards(catalog, tests, 2,
+        [&](const xUnitpp::TestCatalogEntry &entry)
+        {
+            return &entry == tests[0] ? 39LL : 1LL;
+        });
+
+    long long load[2] = { 0, 0 };
+    for (size_t i = 0; i != tests.size(); ++i)
+    {
+        load[shards[i]] += (i == 0 ? 39 : 1);
+    }
+
+    Assert.Equal(39, load[0]);
+    Assert.Equal(39, load[1]);
+}
+
+FACT_FIXTURE("Duration shards fall back to hash shards without estimates", ShardingFixture)
+{
+    auto byHash = xUnitpp::Utilities::HashShards(catalog, tests, 3);
+    auto byDuration = xUnitpp::Utilities::DurationShards(catalog, tests, 3, [](const xUnitpp::TestCatalogEntry &) { return -1LL; });
+
+    Assert.Equal(byHash.begin(), byHash.end(), byDuration.begin(), byDuration.end());
+}
+
+}
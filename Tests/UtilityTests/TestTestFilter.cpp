@@ -0,0 +1,155 @@
+#include <map>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "xUnit++/xUnit++.h"
+#include "xUnit++/TestDetails.h"
+#include "CatalogTests.h"
+#include "TestFilter.h"
+#include "Helpers/DetailsFactory.h"
+
+using xUnitpp::Utilities::TestFilter;
+using xUnitpp::Tests::Details;
+
+namespace
+{
+    std::multimap<std::string, std::string> Attributes(const std::string &key, const std::string &value)
+    {
+        std::multimap<std::string, std::string> attributes;
+        attributes.insert(std::make_pair(key, value));
+        return attributes;
+    }
+
+    // the filter reads tests from a catalog, so each one is checked as a catalog of its own
+    bool Matches(const TestFilter &filter, const xUnitpp::ITestDetails &testDetails)
+    {
+        xUnitpp::Utilities::CatalogBuilder builder;
+        builder.Add(testDetails);
+
+        auto catalog = builder.Catalog();
+        return filter.Matches(catalog, catalog.tests[0]);
+    }
+}
+
+SUITE("TestFilter")
+{
+
+FACT("An empty filter matches every test")
+{
+    TestFilter filter;
+
+    Assert.True(Matches(filter, *Details("name", "suite")));
+}
+
+FACT("Suite and name patterns match any of several patterns")
+{
+    TestFilter filter;
+
+    Assert.Equal("", filter.IncludeSuites(std::vector<std::string> { "^net", "disk$" }));
+    Assert.Equal("", filter.IncludeNames(std::vector<std::string> { "connect", "(a)\\1" }));
+
+    Assert.True(Matches(filter, *Details("Connects", "Network")));
+    Assert.True(Matches(filter, *Details("baa", "RamDisk")));
+    Assert.False(Matches(filter, *Details("Connects", "Storage")));
+    Assert.False(Matches(filter, *Details("Reads", "Network")));
+}
+
+FACT("A bad pattern is reported")
+{
+    TestFilter filter;
+
+    Assert.Contains(filter.IncludeSuites(std::vector<std::string> { "fine", "(broken" }), "(broken");
+}
+
+FACT("Exclusive attributes exclude only tests that have all of them")
+{
+    std::multimap<std::string, std::string> exclusive;
+    exclusive.insert(std::make_pair("Slow", ""));
+    exclusive.insert(std::make_pair("Owner", "net"));
+
+    TestFilter filter;
+    filter.ExcludeAttributes(exclusive);
+
+    std::multimap<std::string, std::string> both = Attributes("Slow", "");
+    both.insert(std::make_pair("Owner", "net"));
+
+    Assert.True(Matches(filter, *Details("plain", "suite")));
+    Assert.True(Matches(filter, *Details("slow", "suite", Attributes("Slow", ""))));
+    Assert.False(Matches(filter, *Details("slow and owned", "suite", both)));
+}
+
+FACT("Inclusive attributes select tests that have any of them")
+{
+    std::multimap<std::string, std::string> inclusive;
+    inclusive.insert(std::make_pair("Owner", "net"));
+    inclusive.insert(std::make_pair("Fast", ""));
+
+    TestFilter filter;
+    filter.IncludeAttributes(inclusive);
+
+    Assert.False(Matches(filter, *Details("plain", "suite")));
+    Assert.False(Matches(filter, *Details("other owner", "suite", Attributes("Owner", "disk"))));
+    Assert.True(Matches(filter, *Details("owned", "suite", Attributes("Owner", "net"))));
+    Assert.True(Matches(filter, *Details("fast", "suite", Attributes("Fast", "yes"))));
+}
+
+FACT("Names from a list match exactly")
+{
+    std::istringstream names("first test\n# a comment\n\nOther :: second test  \r\n");
+
+    TestFilter filter;
+    Assert.Equal("", filter.IncludeNamesFrom(names));
+
+    Assert.True(Matches(filter, *Details("first test", "Any")));
+    Assert.True(Matches(filter, *Details("second test", "Other")));
+    Assert.False(Matches(filter, *Details("second test", "Any")));
+    Assert.False(Matches(filter, *Details("first", "Any")));
+}
+
+FACT("Filter expressions combine suite, name and attribute tests")
+{
+    TestFilter filter;
+    Assert.Equal("", filter.Where("suite ~ ^net && !([Slow] || name ~ \"retry|timeout\") or fullname = \"exact name\""));
+
+    Assert.True(Matches(filter, *Details("connects", "Network")));
+    Assert.False(Matches(filter, *Details("connects", "Network", Attributes("Slow", ""))));
+    Assert.False(Matches(filter, *Details("retries on timeout", "Network")));
+    Assert.False(Matches(filter, *Details("connects", "Disk")));
+    Assert.True(Matches(filter, *Details("exact name", "Disk", Attributes("Slow", ""))));
+}
+
+FACT("Filter expressions match attribute values")
+{
+    TestFilter filter;
+    Assert.Equal("", filter.Where("[Owner = \"net team\"] and not suite = notes"));
+
+    Assert.True(Matches(filter, *Details("a", "suite", Attributes("Owner", "net team"))));
+    Assert.False(Matches(filter, *Details("a", "notes", Attributes("Owner", "net team"))));
+    Assert.False(Matches(filter, *Details("a", "suite", Attributes("Owner", "disk team"))));
+}
+
+DATA_THEORY("Bad filter expressions are reported", (const std::string &expression),
+    ([]() -> std::vector<std::tuple<std::string>>
+    {
+        std::vector<std::tuple<std::string>> expressions;
+
+        expressions.emplace_back("");
+        expressions.emplace_back("suite");
+        expressions.emplace_back("suite ~ \"(unclosed\"");
+        expressions.emplace_back("(name = a");
+        expressions.emplace_back("[Key");
+        expressions.emplace_back("name = a b");
+        expressions.emplace_back("owner = a");
+        expressions.emplace_back("name = \"unterminated");
+
+        return expressions;
+    })
+)
+{
+    TestFilter filter;
+
+    Assert.NotEqual("", filter.Where(expression));
+}
+
+}
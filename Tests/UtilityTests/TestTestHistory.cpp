@@ -0,0 +1,122 @@
+#include <sstream>
+#include "xUnit++/xUnit++.h"
+#include "xUnit++/TestDetails.h"
+#include "TestHistory.h"
+#include "Helpers/DetailsFactory.h"
+
+using xUnitpp::Utilities::TestHistory;
+using xUnitpp::Tests::Details;
+
+namespace
+{
+    xUnitpp::Time::Duration ms(int count)
+    {
+        return xUnitpp::Time::ToDuration(xUnitpp::Time::ToMilliseconds(count));
+    }
+}
+
+SUITE("TestHistory")
+{
+
+FACT("Unknown tests have no statistics")
+{
+    TestHistory history;
+    TestHistory::Statistics stats;
+
+    Assert.False(history.Find(*Details("missing"), stats));
+}
+
+FACT("Statistics summarize recorded samples")
+{
+    TestHistory history;
+    auto details = Details("test");
+
+    for (int i = 1; i <= 10; ++i)
+    {
+        history.Record(*details, ms(i * 10), i == 3);
+    }
+
+    TestHistory::Statistics stats;
+    Assert.True(history.Find(*details, stats));
+
+    Assert.Equal(10U, stats.samples);
+    Assert.Equal(1U, stats.failures);
+    Assert.Equal(55, xUnitpp::Time::ToMilliseconds(stats.mean).count());
+    Assert.Equal(50, xUnitpp::Time::ToMilliseconds(stats.median).count());
+    Assert.Equal(100, xUnitpp::Time::ToMilliseconds(stats.p95).count());
+    Assert.Equal(100, xUnitpp::Time::ToMilliseconds(stats.max).count());
+}
+
+FACT("Only the most recent samples are kept")
+{
+    TestHistory history(3);
+    auto details = Details("test");
+
+    history.Record(*details, ms(1000), true);
+
+    for (int i = 0; i != 3; ++i)
+    {
+        history.Record(*details, ms(10), false);
+    }
+
+    TestHistory::Statistics stats;
+    history.Find(*details, stats);
+
+    Assert.Equal(3U, stats.samples);
+    Assert.Equal(0U, stats.failures);
+    Assert.Equal(10, xUnitpp::Time::ToMilliseconds(stats.max).count());
+}
+
+FACT("Tests are told apart by suite")
+{
+    TestHistory history;
+
+    history.Record(*Details("test", "a"), ms(1), false);
+    history.Record(*Details("test", "b"), ms(2), false);
+
+    Assert.Equal(2U, history.size());
+}
+
+FACT("History survives a save and load")
+{
+    auto details = Details("test");
+
+    TestHistory saved;
+    saved.Record(*details, ms(5), false);
+    saved.Record(*details, ms(7), true);
+
+    std::stringstream stream;
+    Assert.True(saved.Save(stream));
+
+    TestHistory loaded;
+    Assert.True(loaded.Load(stream));
+
+    TestHistory::Statistics stats;
+    Assert.True(loaded.Find(*details, stats));
+    Assert.Equal(2U, stats.samples);
+    Assert.Equal(1U, stats.failures);
+    Assert.Equal(7, xUnitpp::Time::ToMilliseconds(stats.max).count());
+}
+
+FACT("Corrupt history is rejected")
+{
+    std::stringstream stream("not a history file");
+
+    TestHistory history;
+    Assert.False(history.Load(stream));
+    Assert.Equal(0U, history.size());
+}
+
+FACT("History with a damaged string length is rejected")
+{
+    std::string saved("xUH1");
+    saved.append("\x01\0\0\0", 4);
+    saved.append(4, '\xff');
+    std::stringstream stream(saved);
+
+    TestHistory history;
+    Assert.False(history.Load(stream));
+    Assert.Equal(0U, history.size());
+}
+
+}
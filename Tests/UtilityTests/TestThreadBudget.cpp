@@ -0,0 +1,54 @@
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include "xUnit++/xUnit++.h"
+#include "ThreadBudget.h"
+
+using xUnitpp::Utilities::ThreadBudget;
+
+SUITE("ThreadBudget")
+{
+
+FACT("ThreadBudget hands out as many slots as it was given")
+{
+    ThreadBudget budget(2);
+
+    budget.Acquire();
+    budget.Acquire();
+    Assert.Equal(0U, budget.Available());
+
+    budget.Release();
+    budget.Release();
+    Assert.Equal(2U, budget.Available());
+}
+
+FACT("ThreadBudget of zero is sized to the machine")
+{
+    ThreadBudget budget(0);
+
+    Assert.Equal((size_t)std::max(std::thread::hardware_concurrency(), 1U), budget.Available());
+}
+
+UNTIMED_FACT("ThreadBudget waits for a slot to be released")
+{
+    ThreadBudget budget(1);
+    budget.Acquire();
+
+    std::atomic<bool> acquired(false);
+    std::thread waiting([&]()
+        {
+            budget.Acquire();
+            acquired = true;
+        });
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    Assert.False(acquired);
+
+    budget.Release();
+    waiting.join();
+
+    Assert.True(acquired);
+    Assert.Equal(0U, budget.Available());
+}
+
+}
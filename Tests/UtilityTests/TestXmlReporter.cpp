@@ -1,4 +1,8 @@
+#include <map>
+#include <string>
 #include "xUnit++/xUnit++.h"
+#include "xUnit++/TestMetrics.h"
+#include "xUnit++/xUnitBenchmark.h"
 #include "xUnit++/xUnitTestRunner.h"
 #include "XmlReporter.h"
 #include "tinyxml2.h"
@@ -46,6 +50,96 @@ FACT("XmlReporter generates valid xml with no tests")
     Assert.Equal(tinyxml2::XMLError::XML_SUCCESS, tinyxml2::XMLDocument().Parse(out.str().c_str()));
 }
 
+FACT("XmlReporter lists a test's metrics as properties")
+{
+    std::shared_ptr<xUnitpp::xUnitTest> test = TestFactory([]() { }).Name("Measured");
+
+    xUnitpp::TestMetrics metrics;
+    metrics.Add("CpuTimeNs", 1234);
+
+    std::stringstream out;
+
+    XmlReporter reporter(out);
+    reporter.ReportStart(test->TestDetails());
+    reporter.ReportMetrics(test->TestDetails(), metrics);
+    reporter.ReportFinish(test->TestDetails(), 0);
+    reporter.ReportAllTestsComplete(1, 0, 0, 0);
+
+    tinyxml2::XMLDocument doc;
+    Assert.Equal(tinyxml2::XMLError::XML_SUCCESS, doc.Parse(out.str().c_str()));
+
+    auto property = doc.FirstChildElement("testsuites")->FirstChildElement("testsuite")->FirstChildElement("testcase")->FirstChildElement("property");
+    Assert.NotNull(property);
+    Assert.Equal("CpuTimeNs", property->Attribute("name"));
+    Assert.Equal("1234", property->Attribute("value"));
+}
+
+FACT("XmlReporter lists a benchmark's results as properties")
+{
+    std::shared_ptr<xUnitpp::xUnitTest> test = TestFactory([]() { }).Name("Timed");
+
+    std::vector<double> samples;
+    samples.push_back(10.0);
+    samples.push_back(30.0);
+    xUnitpp::BenchmarkResult benchmark(100, std::move(samples));
+
+    std::stringstream out;
+
+    XmlReporter reporter(out);
+    reporter.ReportStart(test->TestDetails());
+    reporter.ReportBenchmark(test->TestDetails(), benchmark);
+    reporter.ReportFinish(test->TestDetails(), 0);
+    reporter.ReportAllTestsComplete(1, 0, 0, 0);
+
+    tinyxml2::XMLDocument doc;
+    Assert.Equal(tinyxml2::XMLError::XML_SUCCESS, doc.Parse(out.str().c_str()));
+
+    std::map<std::string, std::string> properties;
+    for (auto property = doc.FirstChildElement("testsuites")->FirstChildElement("testsuite")->FirstChildElement("testcase")->FirstChildElement("property");
+        property != nullptr; property = property->NextSiblingElement("property"))
+    {
+        properties[property->Attribute("name")] = property->Attribute("value");
+    }
+
+    Assert.Equal("100", properties["BenchmarkIterations"]);
+    Assert.Equal("2", properties["BenchmarkSamples"]);
+    Assert.Equal(20.0, std::stod(properties["BenchmarkMeanNs"]));
+    Assert.Equal(10.0, std::stod(properties["BenchmarkMinNs"]));
+    Assert.Equal(30.0, std::stod(properties["BenchmarkMaxNs"]));
+    Assert.True(properties.find("BenchmarkStdDevNs") != properties.end());
+}
+
+FACT("XmlReporter groups interleaved tests by suite")
+{
+    std::shared_ptr<xUnitpp::xUnitTest> a1 = TestFactory([]() { }).Name("a1").Suite("A");
+    std::shared_ptr<xUnitpp::xUnitTest> b1 = TestFactory([]() { }).Name("b1 <&>").Suite("B");
+    std::shared_ptr<xUnitpp::xUnitTest> a2 = TestFactory([]() { }).Name("a2").Suite("A");
+
+    std::stringstream out;
+
+    XmlReporter reporter(out);
+    reporter.ReportStart(b1->TestDetails());
+    reporter.ReportStart(a1->TestDetails());
+    reporter.ReportFinish(a1->TestDetails(), 0);
+    reporter.ReportSkip(a2->TestDetails(), "\"skipped\"");
+    reporter.ReportFinish(b1->TestDetails(), 0);
+    reporter.ReportAllTestsComplete(3, 1, 0, 0);
+
+    tinyxml2::XMLDocument doc;
+    Assert.Equal(tinyxml2::XMLError::XML_SUCCESS, doc.Parse(out.str().c_str()));
+
+    auto suiteA = doc.FirstChildElement("testsuites")->FirstChildElement("testsuite");
+    Assert.Equal("A", suiteA->Attribute("name"));
+    Assert.Equal(2, suiteA->IntAttribute("tests"));
+    Assert.Equal(1, suiteA->IntAttribute("skipped"));
+    Assert.Equal("\"skipped\"", suiteA->LastChildElement("testcase")->FirstChildElement("skipped")->Attribute("message"));
+
+    auto suiteB = suiteA->NextSiblingElement("testsuite");
+    Assert.Equal("B", suiteB->Attribute("name"));
+    Assert.Equal(1, suiteB->IntAttribute("tests"));
+    Assert.Contains(std::string(suiteB->FirstChildElement("testcase")->Attribute("name")), "b1 <&>");
+}
+
 // G++ doesn't like a tuple consisting of just a std::function<>
 // the extra int is just a dummy parameter to make it compile
 DATA_THEORY("XmlReporter generates valid xml after running tests", (std::function<void ()> test, int),
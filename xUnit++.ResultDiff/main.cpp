@@ -0,0 +1,183 @@
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "ResultLog.h"
+
+using xUnitpp::Utilities::ResultLog;
+using xUnitpp::Utilities::ResultLogDiff;
+
+namespace
+{
+    std::string Usage(const std::string &exe)
+    {
+        return
+            "usage: " + exe + " <before.xulog> <after.xulog> [option]+\n"
+            "\n"
+            "options:\n\n"
+            "  -t --threshold <milliseconds>  : Smallest duration change worth reporting (default 1)\n"
+            "  -n --limit <count>             : Most tests to list in each section (default 20, 0 for all)\n"
+            "\n"
+            "Compares two result logs written by xUnit++.console --result-log, matching tests by suite and name.\n"
+            "Exits with 1 if any test that passed before fails now.\n";
+    }
+
+    std::string TestName(const ResultLog::Test &test)
+    {
+        return test.suite.str() + " :: " + test.name.str();
+    }
+
+    std::string Milliseconds(long long ns)
+    {
+        char buffer[32];
+        std::snprintf(buffer, sizeof(buffer), "%.3f", ns / 1000000.0);
+        return buffer;
+    }
+
+    template<typename TEntries, typename TPrint>
+    void PrintSection(const std::string &title, const TEntries &entries, size_t limit, TPrint print)
+    {
+        if (entries.empty())
+        {
+            return;
+        }
+
+        std::cout << "\n" << title << " (" << entries.size() << "):\n";
+
+        for (size_t i = 0; i != entries.size(); ++i)
+        {
+            if (limit != 0 && i == limit)
+            {
+                std::cout << "    ... and " << (entries.size() - limit) << " more\n";
+                break;
+            }
+
+            print(entries[i]);
+        }
+    }
+}
+
+int main(int argc, char **argv)
+{
+    std::vector<std::string> files;
+    double thresholdMs = 1;
+    size_t limit = 20;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string arg = argv[i];
+
+        if ((arg == "-t" || arg == "--threshold") && i + 1 < argc)
+        {
+            thresholdMs = std::atof(argv[++i]);
+        }
+        else if ((arg == "-n" || arg == "--limit") && i + 1 < argc)
+        {
+            limit = (size_t)std::atoll(argv[++i]);
+        }
+        else if (!arg.empty() && arg[0] != '-')
+        {
+            files.push_back(arg);
+        }
+        else
+        {
+            std::cerr << "Unknown option " << arg << "\n\n" << Usage(argv[0]);
+            return -1;
+        }
+    }
+
+    if (files.size() != 2)
+    {
+        std::cerr << Usage(argv[0]);
+        return -1;
+    }
+
+    ResultLog before;
+    ResultLog after;
+
+    for (auto log : { std::make_pair(&before, files[0]), std::make_pair(&after, files[1]) })
+    {
+        if (!log.first->Load(log.second))
+        {
+            std::cerr << "Unable to read " << log.second << " as a result log.\n";
+            return -1;
+        }
+
+        if (log.first->Truncated())
+        {
+            std::cerr << log.second << " is incomplete; comparing the tests it does have.\n";
+        }
+    }
+
+    auto diff = xUnitpp::Utilities::CompareResultLogs(before, after, (long long)(thresholdMs * 1000000));
+
+    const auto &beforeTests = before.Tests();
+    const auto &afterTests = after.Tests();
+
+    std::cout << files[0] << ": " << beforeTests.size() << " tests\n";
+    std::cout << files[1] << ": " << afterTests.size() << " tests\n";
+
+    // only the first failure of each newly failing test is shown
+    std::unordered_map<size_t, const ResultLog::Event *> firstFailure;
+    for (const auto &change : diff.newFailures)
+    {
+        firstFailure[change.after] = nullptr;
+    }
+
+    for (const auto &event : after.Events())
+    {
+        auto it = firstFailure.find(event.test);
+        if (event.failure && it != firstFailure.end() && it->second == nullptr)
+        {
+            it->second = &event;
+        }
+    }
+
+    PrintSection("New failures", diff.newFailures, limit,
+        [&](const ResultLogDiff::Change &change)
+        {
+            std::cout << "    " << TestName(afterTests[change.after]) << "\n";
+
+            auto event = firstFailure[change.after];
+            if (event != nullptr)
+            {
+                std::cout << "        " << event->message.str() << "\n";
+            }
+            else
+            {
+                std::cout << "        did not finish\n";
+            }
+        });
+
+    PrintSection("Fixed", diff.fixed, limit,
+        [&](const ResultLogDiff::Change &change)
+        {
+            std::cout << "    " << TestName(afterTests[change.after]) << "\n";
+        });
+
+    PrintSection("Added", diff.added, limit,
+        [&](size_t index)
+        {
+            std::cout << "    " << TestName(afterTests[index]) << "\n";
+        });
+
+    PrintSection("Removed", diff.removed, limit,
+        [&](size_t index)
+        {
+            std::cout << "    " << TestName(beforeTests[index]) << "\n";
+        });
+
+    PrintSection("Duration changes of at least " + Milliseconds((long long)(thresholdMs * 1000000)) + " ms", diff.durationChanges, limit,
+        [&](const ResultLogDiff::Change &change)
+        {
+            auto previous = beforeTests[change.before].ns;
+            auto current = afterTests[change.after].ns;
+
+            std::cout << "    " << (current > previous ? "+" : "") << Milliseconds(current - previous) << " ms ("
+                << Milliseconds(previous) << " -> " << Milliseconds(current) << ") " << TestName(afterTests[change.after]) << "\n";
+        });
+
+    return diff.newFailures.empty() ? 0 : 1;
+}
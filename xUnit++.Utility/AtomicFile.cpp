@@ -0,0 +1,88 @@
+#include "AtomicFile.h"
+#include <cstdio>
+#include <fstream>
+
+#if defined(WIN32)
+#include <Windows.h>
+#else
+#include <stdlib.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+    //
+    // Creates an empty file with a name of its own in the same directory as file, so the rename stays on one file system.
+    // Processes saving the same file at once (shards of one library, say) each get their own.
+    bool CreateTempFile(const std::string &file, std::string &temp)
+    {
+        auto separator = file.find_last_of("/\\");
+        auto directory = separator == std::string::npos ? std::string(".") : file.substr(0, separator + 1);
+
+#if defined(WIN32)
+        char tempPath[MAX_PATH] = {0};
+        if (GetTempFileName(directory.c_str(), "xU+", 0, tempPath) == 0)
+        {
+            return false;
+        }
+
+        temp = tempPath;
+        return true;
+#else
+        temp = (separator == std::string::npos ? std::string() : directory) + ".xU+XXXXXX";
+
+        int fd = mkstemp(&temp[0]);
+        if (fd < 0)
+        {
+            return false;
+        }
+
+        // mkstemp makes the file private to us, but it is about to take the place of a file everyone could read
+        fchmod(fd, 0644);
+        close(fd);
+        return true;
+#endif
+    }
+}
+
+namespace xUnitpp { namespace Utilities
+{
+
+bool SaveAtomically(const std::string &file, const std::function<bool(std::ostream &)> &write)
+{
+    std::string temp;
+    if (!CreateTempFile(file, temp))
+    {
+        return false;
+    }
+
+    {
+        std::ofstream output(temp, std::ios::binary | std::ios::trunc);
+        if (!output || !write(output) || !output.flush())
+        {
+            output.close();
+            std::remove(temp.c_str());
+            return false;
+        }
+    }
+
+    if (!RenameReplacing(temp, file))
+    {
+        std::remove(temp.c_str());
+        return false;
+    }
+
+    return true;
+}
+
+bool RenameReplacing(const std::string &from, const std::string &to)
+{
+#if defined(WIN32)
+    return MoveFileEx(from.c_str(), to.c_str(), MOVEFILE_REPLACE_EXISTING) != 0;
+#else
+    return std::rename(from.c_str(), to.c_str()) == 0;
+#endif
+}
+
+}}
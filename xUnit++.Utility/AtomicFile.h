@@ -0,0 +1,22 @@
+#ifndef ATOMICFILE_H_
+#define ATOMICFILE_H_
+
+#include <functional>
+#include <ostream>
+#include <string>
+
+namespace xUnitpp { namespace Utilities
+{
+
+//
+// Saves a file so that an interrupted run never leaves a torn one behind: everything is written out to
+// a temporary file next to it first, which then takes its place in one step.
+// write fills in the file, and returns false if it couldn't; the file is left as it was.
+bool SaveAtomically(const std::string &file, const std::function<bool(std::ostream &)> &write);
+
+// renames from to to, replacing whatever was there
+bool RenameReplacing(const std::string &from, const std::string &to);
+
+}}
+
+#endif
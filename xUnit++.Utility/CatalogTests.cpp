@@ -0,0 +1,212 @@
+#include "CatalogTests.h"
+#include <algorithm>
+#include <cstring>
+
+namespace
+{
+    // orders attributes by key, as offsets into the catalog's strings
+    struct KeyLess
+    {
+        explicit KeyLess(const char *strings)
+            : strings(strings)
+        {
+        }
+
+        bool operator ()(const xUnitpp::TestCatalogAttribute &attribute, const char *key) const
+        {
+            return std::strcmp(strings + attribute.key, key) < 0;
+        }
+
+        bool operator ()(const char *key, const xUnitpp::TestCatalogAttribute &attribute) const
+        {
+            return std::strcmp(key, strings + attribute.key) < 0;
+        }
+
+        const char *strings;
+    };
+}
+
+namespace xUnitpp { namespace Utilities
+{
+
+std::pair<const TestCatalogAttribute *, const TestCatalogAttribute *> FindAttributes(const TestCatalog &catalog, const TestCatalogEntry &entry, const char *key)
+{
+    auto first = catalog.attributes + entry.firstAttribute;
+    return std::equal_range(first, first + entry.attributeCount, key, KeyLess(catalog.strings));
+}
+
+CatalogBuilder::CatalogBuilder()
+    : strings(1, '\0')
+{
+}
+
+CatalogBuilder::~CatalogBuilder()
+{
+}
+
+// the details keep their attributes sorted by key, so the catalog's are as well
+void CatalogBuilder::Add(const ITestDetails &testDetails)
+{
+    TestCatalogEntry entry;
+    entry.id = testDetails.GetId();
+    entry.testInstance = testDetails.GetTestInstance();
+    entry.name = String(testDetails.GetName());
+    entry.fullName = String(testDetails.GetFullName());
+    entry.suite = String(testDetails.GetSuite());
+    entry.params = String(testDetails.GetParams());
+    entry.file = String(testDetails.GetFile());
+    entry.line = testDetails.GetLine();
+
+    for (size_t i = 0; i != testDetails.GetAttributeCount(); ++i)
+    {
+        Attribute(String(testDetails.GetAttributeKey(i)), String(testDetails.GetAttributeValue(i)));
+    }
+
+    Add(entry);
+}
+
+void CatalogBuilder::Add(const TestCatalog &catalog, const TestCatalogEntry &entry)
+{
+    auto copy = entry;
+    copy.name = String(catalog.strings + entry.name);
+    copy.fullName = String(catalog.strings + entry.fullName);
+    copy.suite = String(catalog.strings + entry.suite);
+    copy.params = String(catalog.strings + entry.params);
+    copy.file = String(catalog.strings + entry.file);
+
+    for (size_t i = 0; i != entry.attributeCount; ++i)
+    {
+        const auto &attribute = catalog.attributes[entry.firstAttribute + i];
+        Attribute(String(catalog.strings + attribute.key), String(catalog.strings + attribute.value));
+    }
+
+    Add(copy);
+}
+
+unsigned int CatalogBuilder::String(const char *s)
+{
+    if (s == nullptr || *s == '\0')
+    {
+        return 0;
+    }
+
+    auto it = interned.find(s);
+    if (it != interned.end())
+    {
+        return it->second;
+    }
+
+    auto offset = (unsigned int)strings.size();
+    strings.append(s);
+    strings.push_back('\0');
+
+    interned.insert(std::make_pair(std::string(s), offset));
+    return offset;
+}
+
+void CatalogBuilder::Attribute(unsigned int key, unsigned int value)
+{
+    TestCatalogAttribute attribute;
+    attribute.key = key;
+    attribute.value = value;
+    attributes.push_back(attribute);
+}
+
+void CatalogBuilder::Add(TestCatalogEntry entry)
+{
+    entry.firstAttribute = tests.empty() ? 0 : tests.back().firstAttribute + tests.back().attributeCount;
+    entry.attributeCount = (unsigned int)attributes.size() - entry.firstAttribute;
+    tests.push_back(entry);
+}
+
+void CatalogBuilder::Clear()
+{
+    tests.clear();
+    attributes.clear();
+    strings.assign(1, '\0');
+    interned.clear();
+}
+
+TestCatalog CatalogBuilder::Catalog() const
+{
+    TestCatalog catalog;
+    catalog.tests = tests.data();
+    catalog.testCount = tests.size();
+    catalog.attributes = attributes.data();
+    catalog.attributeCount = attributes.size();
+    catalog.strings = strings.data();
+    catalog.stringsSize = strings.size();
+    return catalog;
+}
+
+CatalogTest::CatalogTest(const TestCatalog &catalog, const TestCatalogEntry &entry)
+    : catalog(&catalog)
+    , entry(&entry)
+{
+}
+
+int __stdcall CatalogTest::GetId() const
+{
+    return entry->id;
+}
+
+const char * __stdcall CatalogTest::GetName() const
+{
+    return catalog->strings + entry->name;
+}
+
+const char * __stdcall CatalogTest::GetFullName() const
+{
+    return catalog->strings + entry->fullName;
+}
+
+const char * __stdcall CatalogTest::GetSuite() const
+{
+    return catalog->strings + entry->suite;
+}
+
+const char * __stdcall CatalogTest::GetParams() const
+{
+    return catalog->strings + entry->params;
+}
+
+int __stdcall CatalogTest::GetTestInstance() const
+{
+    return entry->testInstance;
+}
+
+size_t __stdcall CatalogTest::GetAttributeCount() const
+{
+    return entry->attributeCount;
+}
+
+const char * __stdcall CatalogTest::GetAttributeKey(size_t index) const
+{
+    return catalog->strings + catalog->attributes[entry->firstAttribute + index].key;
+}
+
+const char * __stdcall CatalogTest::GetAttributeValue(size_t index) const
+{
+    return catalog->strings + catalog->attributes[entry->firstAttribute + index].value;
+}
+
+void __stdcall CatalogTest::FindAttributeKey(const char *key, size_t &begin, size_t &end) const
+{
+    auto first = catalog->attributes + entry->firstAttribute;
+    auto range = FindAttributes(*catalog, *entry, key);
+
+    begin = range.first - first;
+    end = range.second - first;
+}
+
+const char * __stdcall CatalogTest::GetFile() const
+{
+    return catalog->strings + entry->file;
+}
+
+int __stdcall CatalogTest::GetLine() const
+{
+    return entry->line;
+}
+
+}}
@@ -0,0 +1,83 @@
+#ifndef CATALOGTESTS_H_
+#define CATALOGTESTS_H_
+
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+#include "xUnit++/ExportApi.h"
+#include "xUnit++/ITestDetails.h"
+
+namespace xUnitpp { namespace Utilities
+{
+
+//
+// The console selects, lists and shards tests straight from the tables of a TestCatalog.
+// Only a test that is handed to a reporter is seen through ITestDetails, as a CatalogTest.
+
+// the attributes of a test with the given key, which are next to each other since a test's attributes are sorted by key
+std::pair<const TestCatalogAttribute *, const TestCatalogAttribute *> FindAttributes(const TestCatalog &catalog, const TestCatalogEntry &entry, const char *key);
+
+//
+// A catalog of tests that don't come as one: those of a discovery cache, or of a library without GetTestCatalog.
+// Strings that repeat are only stored once.
+class CatalogBuilder
+{
+public:
+    CatalogBuilder();
+    ~CatalogBuilder();
+
+    void Add(const ITestDetails &testDetails);
+    void Add(const TestCatalog &catalog, const TestCatalogEntry &entry);
+
+    // for tests read from anywhere else: a test's strings and attributes are added first, then the test
+    // takes every attribute added since the test before it
+    unsigned int String(const char *s);
+    void Attribute(unsigned int key, unsigned int value);
+    void Add(TestCatalogEntry entry);
+
+    void Clear();
+
+    // points into the builder, so it is only good until the next test is added
+    TestCatalog Catalog() const;
+
+private:
+    CatalogBuilder(const CatalogBuilder &) /* = delete */;
+    CatalogBuilder &operator =(CatalogBuilder) /* = delete */;
+
+private:
+    std::vector<TestCatalogEntry> tests;
+    std::vector<TestCatalogAttribute> attributes;
+    std::string strings;
+    std::map<std::string, unsigned int> interned;
+};
+
+//
+// A test of a catalog seen through ITestDetails, for the reporters that need one.
+// It only points into the catalog, which has to outlive it.
+class CatalogTest : public ITestDetails
+{
+public:
+    CatalogTest(const TestCatalog &catalog, const TestCatalogEntry &entry);
+
+    virtual int __stdcall GetId() const override;
+    virtual const char * __stdcall GetName() const override;
+    virtual const char * __stdcall GetFullName() const override;
+    virtual const char * __stdcall GetSuite() const override;
+    virtual const char * __stdcall GetParams() const override;
+    virtual int __stdcall GetTestInstance() const override;
+    virtual size_t __stdcall GetAttributeCount() const override;
+    virtual const char * __stdcall GetAttributeKey(size_t index) const override;
+    virtual const char * __stdcall GetAttributeValue(size_t index) const override;
+    virtual void __stdcall FindAttributeKey(const char *key, size_t &begin, size_t &end) const override;
+    virtual const char * __stdcall GetFile() const override;
+    virtual int __stdcall GetLine() const override;
+
+private:
+    const TestCatalog *catalog;
+    const TestCatalogEntry *entry;
+};
+
+}}
+
+#endif
@@ -0,0 +1,291 @@
+#include "DiscoveryCache.h"
+#include <algorithm>
+#include <cstdint>
+#include <fstream>
+#include <utility>
+#include <vector>
+#include "xUnit++/ITestDetails.h"
+#include "AtomicFile.h"
+#include "Fnv1a.h"
+
+#include <sys/stat.h>
+
+namespace
+{
+    const char Magic[4] = { 'x', 'U', 'D', '1' };
+
+    template<typename T>
+    void WriteValue(std::ostream &output, T value)
+    {
+        output.write(reinterpret_cast<const char *>(&value), sizeof(value));
+    }
+
+    template<typename T>
+    bool ReadValue(std::istream &input, T &value)
+    {
+        return (bool)input.read(reinterpret_cast<char *>(&value), sizeof(value));
+    }
+
+    void WriteString(std::ostream &output, const std::string &value)
+    {
+        WriteValue(output, (uint32_t)value.size());
+        output.write(value.data(), value.size());
+    }
+
+    bool ReadString(std::istream &input, std::string &value)
+    {
+        uint32_t size;
+        if (!ReadValue(input, size))
+        {
+            return false;
+        }
+
+        // the size comes from the file, so a damaged one only gets as much memory as it actually holds
+        value.clear();
+
+        char buffer[4096];
+        while (size != 0)
+        {
+            auto chunk = std::min(size, (uint32_t)sizeof(buffer));
+            if (!input.read(buffer, chunk))
+            {
+                return false;
+            }
+
+            value.append(buffer, chunk);
+            size -= chunk;
+        }
+
+        return true;
+    }
+
+    void SaveTest(std::ostream &output, const xUnitpp::TestCatalog &catalog, const xUnitpp::TestCatalogEntry &entry)
+    {
+        WriteValue(output, (int32_t)entry.id);
+        WriteValue(output, (int32_t)entry.testInstance);
+        WriteString(output, catalog.strings + entry.name);
+        WriteString(output, catalog.strings + entry.fullName);
+        WriteString(output, catalog.strings + entry.suite);
+        WriteString(output, catalog.strings + entry.params);
+        WriteString(output, catalog.strings + entry.file);
+        WriteValue(output, (int32_t)entry.line);
+        WriteValue(output, (uint32_t)entry.attributeCount);
+
+        for (size_t i = 0; i != entry.attributeCount; ++i)
+        {
+            const auto &attribute = catalog.attributes[entry.firstAttribute + i];
+            WriteString(output, catalog.strings + attribute.key);
+            WriteString(output, catalog.strings + attribute.value);
+        }
+    }
+
+    bool LoadTest(std::istream &input, xUnitpp::Utilities::CatalogBuilder &tests)
+    {
+        int32_t id32, instance32, line32;
+        uint32_t attributeCount;
+        std::string name, fullName, suite, params, file;
+
+        if (!ReadValue(input, id32) || !ReadValue(input, instance32) || !ReadString(input, name) || !ReadString(input, fullName) ||
+            !ReadString(input, suite) || !ReadString(input, params) || !ReadString(input, file) || !ReadValue(input, line32) ||
+            !ReadValue(input, attributeCount))
+        {
+            return false;
+        }
+
+        for (uint32_t i = 0; i != attributeCount; ++i)
+        {
+            std::string key, value;
+
+            if (!ReadString(input, key) || !ReadString(input, value))
+            {
+                return false;
+            }
+
+            tests.Attribute(tests.String(key.c_str()), tests.String(value.c_str()));
+        }
+
+        xUnitpp::TestCatalogEntry entry;
+        entry.id = id32;
+        entry.testInstance = instance32;
+        entry.name = tests.String(name.c_str());
+        entry.fullName = tests.String(fullName.c_str());
+        entry.suite = tests.String(suite.c_str());
+        entry.params = tests.String(params.c_str());
+        entry.file = tests.String(file.c_str());
+        entry.line = line32;
+        tests.Add(entry);
+
+        return true;
+    }
+}
+
+namespace xUnitpp { namespace Utilities
+{
+
+DiscoveryCache::DiscoveryCache()
+{
+}
+
+DiscoveryCache::~DiscoveryCache()
+{
+}
+
+bool DiscoveryCache::StampFile(const std::string &library, Stamp &stamp, bool withHash)
+{
+#if defined(WIN32)
+    struct _stat64 info;
+    if (_stat64(library.c_str(), &info) != 0)
+    {
+        return false;
+    }
+
+    stamp.modified = (long long)info.st_mtime * 1000000000LL;
+#else
+    struct stat info;
+    if (stat(library.c_str(), &info) != 0)
+    {
+        return false;
+    }
+
+# if defined(__APPLE__)
+    stamp.modified = (long long)info.st_mtimespec.tv_sec * 1000000000LL + info.st_mtimespec.tv_nsec;
+# else
+    stamp.modified = (long long)info.st_mtim.tv_sec * 1000000000LL + info.st_mtim.tv_nsec;
+# endif
+#endif
+
+    stamp.size = (unsigned long long)info.st_size;
+    stamp.hash = 0;
+
+    if (withHash)
+    {
+        std::ifstream input(library, std::ios::binary);
+        if (!input)
+        {
+            return false;
+        }
+
+        Fnv1a hash;
+
+        std::vector<char> buffer(1 << 16);
+        while (input.read(buffer.data(), buffer.size()) || input.gcount() > 0)
+        {
+            hash.AddBytes(buffer.data(), (size_t)input.gcount());
+        }
+
+        stamp.hash = hash.Value();
+    }
+
+    return true;
+}
+
+bool DiscoveryCache::Load(std::istream &input, const Stamp &stamp)
+{
+    tests.Clear();
+
+    char magic[sizeof(Magic)];
+    Stamp saved;
+    uint32_t count;
+
+    if (!input.read(magic, sizeof(magic)) || !std::equal(magic, magic + sizeof(magic), Magic) ||
+        !ReadValue(input, saved.size) || !ReadValue(input, saved.modified) || !ReadValue(input, saved.hash) || !ReadValue(input, count))
+    {
+        return false;
+    }
+
+    if (saved.size != stamp.size || (saved.modified != stamp.modified && saved.hash != stamp.hash))
+    {
+        return false;
+    }
+
+    for (uint32_t i = 0; i != count; ++i)
+    {
+        if (!LoadTest(input, tests))
+        {
+            tests.Clear();
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool DiscoveryCache::Save(std::ostream &output, const Stamp &stamp) const
+{
+    output.write(Magic, sizeof(Magic));
+    WriteValue(output, stamp.size);
+    WriteValue(output, stamp.modified);
+    WriteValue(output, stamp.hash);
+    auto catalog = tests.Catalog();
+    WriteValue(output, (uint32_t)catalog.testCount);
+
+    for (size_t i = 0; i != catalog.testCount; ++i)
+    {
+        SaveTest(output, catalog, catalog.tests[i]);
+    }
+
+    return (bool)output;
+}
+
+bool DiscoveryCache::Load(const std::string &file, const std::string &library)
+{
+    std::ifstream input(file, std::ios::binary);
+
+    Stamp stamp;
+    if (!input || !StampFile(library, stamp, false))
+    {
+        return false;
+    }
+
+    // the modification time is a shortcut: only if it has changed does the content have to be hashed
+    std::streampos start = input.tellg();
+    if (Load(input, stamp))
+    {
+        return true;
+    }
+
+    input.clear();
+    input.seekg(start);
+
+    if (!StampFile(library, stamp, true) || !Load(input, stamp))
+    {
+        return false;
+    }
+
+    // the library was only touched: saving the new time lets the next load take the shortcut again
+    input.close();
+    Save(file, stamp);
+
+    return true;
+}
+
+bool DiscoveryCache::Save(const std::string &file, const std::string &library) const
+{
+    Stamp stamp;
+    return StampFile(library, stamp, true) && Save(file, stamp);
+}
+
+bool DiscoveryCache::Save(const std::string &file, const Stamp &stamp) const
+{
+    return SaveAtomically(file, [&](std::ostream &output) { return Save(output, stamp); });
+}
+
+void DiscoveryCache::Record(const ITestDetails &testDetails)
+{
+    tests.Add(testDetails);
+}
+
+void DiscoveryCache::Record(const TestCatalog &catalog)
+{
+    for (size_t i = 0; i != catalog.testCount; ++i)
+    {
+        tests.Add(catalog, catalog.tests[i]);
+    }
+}
+
+TestCatalog DiscoveryCache::Catalog() const
+{
+    return tests.Catalog();
+}
+
+}}
@@ -0,0 +1,60 @@
+#ifndef DISCOVERYCACHE_H_
+#define DISCOVERYCACHE_H_
+
+#include <istream>
+#include <ostream>
+#include <string>
+#include "xUnit++/ExportApi.h"
+#include "CatalogTests.h"
+
+namespace xUnitpp { namespace Utilities
+{
+
+//
+// The details of every test in a library, saved next to it so that listing and filtering
+// don't have to load the library and run its static initializers.
+//
+// A cache belongs to the library it was saved for: it is only loaded if the library has the same size and,
+// unless its modification time is also unchanged, the same content hash.
+class DiscoveryCache
+{
+public:
+    struct Stamp
+    {
+        unsigned long long size;
+        long long modified;             // nanoseconds since the epoch, where the file system has them
+        unsigned long long hash;        // FNV-1a of the whole file
+    };
+
+    DiscoveryCache();
+    ~DiscoveryCache();
+
+    // fills in the size and modification time; the hash as well when withHash is set
+    static bool StampFile(const std::string &library, Stamp &stamp, bool withHash);
+
+    // false if the cache is unreadable, or was saved for some other version of the library
+    bool Load(std::istream &input, const Stamp &stamp);
+    bool Save(std::ostream &output, const Stamp &stamp) const;
+
+    bool Load(const std::string &file, const std::string &library);
+    bool Save(const std::string &file, const std::string &library) const;
+
+    void Record(const ITestDetails &testDetails);
+    void Record(const TestCatalog &catalog);
+
+    // in the order they were recorded; good until the next test is recorded or loaded
+    TestCatalog Catalog() const;
+
+private:
+    DiscoveryCache(const DiscoveryCache &) /* = delete */;
+    DiscoveryCache &operator =(DiscoveryCache) /* = delete */;
+
+    bool Save(const std::string &file, const Stamp &stamp) const;
+
+private:
+    CatalogBuilder tests;
+};
+
+}}
+
+#endif
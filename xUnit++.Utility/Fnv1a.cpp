@@ -0,0 +1,48 @@
+#include "Fnv1a.h"
+
+namespace
+{
+    const unsigned long long OffsetBasis = 14695981039346656037ULL;
+    const unsigned long long Prime = 1099511628211ULL;
+}
+
+namespace xUnitpp { namespace Utilities
+{
+
+Fnv1a::Fnv1a()
+    : hash(OffsetBasis)
+{
+}
+
+void Fnv1a::AddBytes(const void *data, size_t size)
+{
+    auto bytes = static_cast<const unsigned char *>(data);
+
+    for (size_t i = 0; i != size; ++i)
+    {
+        hash ^= bytes[i];
+        hash *= Prime;
+    }
+}
+
+void Fnv1a::AddString(const char *s)
+{
+    for (; s != nullptr && *s != '\0'; ++s)
+    {
+        hash ^= (unsigned char)*s;
+        hash *= Prime;
+    }
+}
+
+void Fnv1a::AddByte(unsigned char byte)
+{
+    hash ^= byte;
+    hash *= Prime;
+}
+
+unsigned long long Fnv1a::Value() const
+{
+    return hash;
+}
+
+}}
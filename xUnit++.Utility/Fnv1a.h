@@ -0,0 +1,33 @@
+#ifndef FNV1A_H_
+#define FNV1A_H_
+
+#include <cstddef>
+
+namespace xUnitpp { namespace Utilities
+{
+
+//
+// The 64 bit FNV-1a hash: unlike std::hash, the same on every machine and in every build,
+// so what it gives can be saved, or compared between processes.
+class Fnv1a
+{
+public:
+    Fnv1a();
+
+    void AddBytes(const void *data, size_t size);
+
+    // up to the terminating '\0'; a nullptr adds nothing
+    void AddString(const char *s);
+
+    // a separator between fields keeps ("ab", "c") and ("a", "bc") apart
+    void AddByte(unsigned char byte);
+
+    unsigned long long Value() const;
+
+private:
+    unsigned long long hash;
+};
+
+}}
+
+#endif
@@ -0,0 +1,871 @@
+#include "IsolatedRunner.h"
+
+#if !defined(WIN32)
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+#include <poll.h>
+#include <signal.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include "xUnit++/EventLevel.h"
+#include "xUnit++/IBenchmarkResult.h"
+#include "xUnit++/IOutput.h"
+#include "xUnit++/ITestDetails.h"
+#include "xUnit++/ITestEvent.h"
+#include "xUnit++/ITestMetrics.h"
+#include "xUnit++/xUnitTime.h"
+
+namespace
+{
+    enum class Message : unsigned char
+    {
+        Start,
+        Event,
+        Benchmark,
+        Metrics,
+        Skip,
+        Finish,
+        Complete
+    };
+
+    // a Fatal event on a test that keeps running means the time limit has given up on it:
+    // after this long, the process is killed rather than left to burn CPU until the end of its batch
+    const std::chrono::milliseconds AbandonedTestGracePeriod(250);
+
+    // a test whose process keeps being taken down by other tests is given up on after this many more tries
+    const int MaxBystanderReruns = 3;
+
+    std::string safestr(const char *s)
+    {
+        return s == nullptr ? "" : s;
+    }
+
+    template<typename T>
+    void Append(std::string &buffer, T value)
+    {
+        buffer.append(reinterpret_cast<const char *>(&value), sizeof(value));
+    }
+
+    void Append(std::string &buffer, const std::string &value)
+    {
+        Append(buffer, (uint32_t)value.size());
+        buffer += value;
+    }
+
+    class Reader
+    {
+    public:
+        Reader(const char *begin, const char *end)
+            : pos(begin)
+            , end(end)
+        {
+        }
+
+        template<typename T>
+        bool Read(T &value)
+        {
+            if ((size_t)(end - pos) < sizeof(value))
+            {
+                return false;
+            }
+
+            memcpy(&value, pos, sizeof(value));
+            pos += sizeof(value);
+            return true;
+        }
+
+        bool Read(std::string &value)
+        {
+            uint32_t size;
+            if (!Read(size) || (size_t)(end - pos) < size)
+            {
+                return false;
+            }
+
+            value.assign(pos, size);
+            pos += size;
+            return true;
+        }
+
+    private:
+        const char *pos;
+        const char *end;
+    };
+
+    bool WriteAll(int fd, const std::string &data)
+    {
+        for (size_t written = 0; written != data.size(); )
+        {
+            auto result = write(fd, data.data() + written, data.size() - written);
+
+            if (result < 0)
+            {
+                if (errno == EINTR)
+                {
+                    continue;
+                }
+
+                return false;
+            }
+
+            written += result;
+        }
+
+        return true;
+    }
+
+    //
+    // An event as reported by a child process, or made up by the parent when a child dies.
+    class RemoteEvent : public xUnitpp::ITestEvent, public xUnitpp::ITestAssert
+    {
+    public:
+        RemoteEvent()
+            : isAssert(false)
+            , isFailure(false)
+            , level(xUnitpp::EventLevel::Info)
+            , line(0)
+        {
+        }
+
+        RemoteEvent(xUnitpp::EventLevel level, const std::string &message)
+            : isAssert(false)
+            , isFailure(level > xUnitpp::EventLevel::Warning)
+            , level(level)
+            , message(message)
+            , toString(message)
+            , line(0)
+        {
+        }
+
+        static void Write(std::string &buffer, const xUnitpp::ITestEvent &evt)
+        {
+            Append(buffer, (char)evt.GetIsAssertType());
+            Append(buffer, (char)evt.GetIsFailure());
+            Append(buffer, (int32_t)evt.GetLevel());
+            Append(buffer, safestr(evt.GetMessage()));
+            Append(buffer, safestr(evt.GetToString()));
+            Append(buffer, safestr(evt.GetFile()));
+            Append(buffer, (int32_t)evt.GetLine());
+
+            if (evt.GetIsAssertType())
+            {
+                auto &&assert = evt.GetAssertInterface();
+                Append(buffer, safestr(assert.GetCall()));
+                Append(buffer, safestr(assert.GetUserMessage()));
+                Append(buffer, safestr(assert.GetCustomMessage()));
+                Append(buffer, safestr(assert.GetExpected()));
+                Append(buffer, safestr(assert.GetActual()));
+            }
+        }
+
+        bool Read(Reader &reader)
+        {
+            char assertType, failure;
+            int32_t eventLevel, eventLine;
+
+            if (!reader.Read(assertType) || !reader.Read(failure) || !reader.Read(eventLevel) ||
+                !reader.Read(message) || !reader.Read(toString) || !reader.Read(file) || !reader.Read(eventLine))
+            {
+                return false;
+            }
+
+            isAssert = assertType != 0;
+            isFailure = failure != 0;
+            level = (xUnitpp::EventLevel)eventLevel;
+            line = eventLine;
+
+            return !isAssert ||
+                (reader.Read(call) && reader.Read(userMessage) && reader.Read(customMessage) && reader.Read(expected) && reader.Read(actual));
+        }
+
+        // ITestEvent implementation
+        virtual bool __stdcall GetIsAssertType() const override { return isAssert; }
+        virtual bool __stdcall GetIsFailure() const override { return isFailure; }
+        virtual xUnitpp::EventLevel __stdcall GetLevel() const override { return level; }
+        virtual const char * __stdcall GetMessage() const override { return message.c_str(); }
+        virtual const char * __stdcall GetToString() const override { return toString.c_str(); }
+        virtual const char * __stdcall GetFile() const override { return file.c_str(); }
+        virtual int __stdcall GetLine() const override { return line; }
+        virtual const xUnitpp::ITestAssert & __stdcall GetAssertInterface() const override { return *this; }
+
+        // ITestAssert implementation
+        virtual const char * __stdcall GetCall() const override { return call.c_str(); }
+        virtual const char * __stdcall GetUserMessage() const override { return userMessage.c_str(); }
+        virtual const char * __stdcall GetCustomMessage() const override { return customMessage.c_str(); }
+        virtual const char * __stdcall GetExpected() const override { return expected.c_str(); }
+        virtual const char * __stdcall GetActual() const override { return actual.c_str(); }
+
+    private:
+        bool isAssert;
+        bool isFailure;
+        xUnitpp::EventLevel level;
+        std::string message;
+        std::string toString;
+        std::string file;
+        int line;
+        std::string call;
+        std::string userMessage;
+        std::string customMessage;
+        std::string expected;
+        std::string actual;
+    };
+
+    //
+    // A benchmark result as reported by a child process.
+    class RemoteBenchmark : public xUnitpp::IBenchmarkResult
+    {
+    public:
+        RemoteBenchmark()
+            : iterations(0)
+            , mean(0)
+            , standardDeviation(0)
+            , min(0)
+            , max(0)
+        {
+        }
+
+        static void Write(std::string &buffer, const xUnitpp::IBenchmarkResult &result)
+        {
+            Append(buffer, (int64_t)result.GetIterations());
+            Append(buffer, result.GetMean());
+            Append(buffer, result.GetStandardDeviation());
+            Append(buffer, result.GetMin());
+            Append(buffer, result.GetMax());
+            Append(buffer, (uint32_t)result.GetSampleCount());
+
+            for (size_t i = 0; i != result.GetSampleCount(); ++i)
+            {
+                Append(buffer, result.GetSample(i));
+            }
+        }
+
+        bool Read(Reader &reader)
+        {
+            int64_t calls;
+            uint32_t sampleCount;
+
+            if (!reader.Read(calls) || !reader.Read(mean) || !reader.Read(standardDeviation) ||
+                !reader.Read(min) || !reader.Read(max) || !reader.Read(sampleCount))
+            {
+                return false;
+            }
+
+            iterations = calls;
+
+            for (uint32_t i = 0; i != sampleCount; ++i)
+            {
+                double sample;
+                if (!reader.Read(sample))
+                {
+                    return false;
+                }
+
+                samples.push_back(sample);
+            }
+
+            return true;
+        }
+
+        // IBenchmarkResult implementation
+        virtual long long __stdcall GetIterations() const override { return iterations; }
+        virtual size_t __stdcall GetSampleCount() const override { return samples.size(); }
+        virtual double __stdcall GetSample(size_t index) const override { return samples[index]; }
+        virtual double __stdcall GetMean() const override { return mean; }
+        virtual double __stdcall GetStandardDeviation() const override { return standardDeviation; }
+        virtual double __stdcall GetMin() const override { return min; }
+        virtual double __stdcall GetMax() const override { return max; }
+
+    private:
+        long long iterations;
+        std::vector<double> samples;
+        double mean;
+        double standardDeviation;
+        double min;
+        double max;
+    };
+
+    //
+    // Test metrics as reported by a child process.
+    class RemoteMetrics : public xUnitpp::ITestMetrics
+    {
+    public:
+        static void Write(std::string &buffer, const xUnitpp::ITestMetrics &metrics)
+        {
+            Append(buffer, (uint32_t)metrics.GetCount());
+
+            for (size_t i = 0; i != metrics.GetCount(); ++i)
+            {
+                Append(buffer, safestr(metrics.GetName(i)));
+                Append(buffer, (int64_t)metrics.GetValue(i));
+            }
+        }
+
+        bool Read(Reader &reader)
+        {
+            uint32_t count;
+            if (!reader.Read(count))
+            {
+                return false;
+            }
+
+            for (uint32_t i = 0; i != count; ++i)
+            {
+                std::string name;
+                int64_t value;
+
+                if (!reader.Read(name) || !reader.Read(value))
+                {
+                    return false;
+                }
+
+                metrics.push_back(std::make_pair(name, (long long)value));
+            }
+
+            return true;
+        }
+
+        // ITestMetrics implementation
+        virtual size_t __stdcall GetCount() const override { return metrics.size(); }
+        virtual const char * __stdcall GetName(size_t index) const override { return metrics[index].first.c_str(); }
+        virtual long long __stdcall GetValue(size_t index) const override { return metrics[index].second; }
+
+    private:
+        std::vector<std::pair<std::string, long long>> metrics;
+    };
+
+    //
+    // Lives in the child process: every report becomes a message on the pipe back to the parent.
+    // Calls are already serialized by RunTests, so there is no locking here.
+    class PipeOutput : public xUnitpp::IOutput
+    {
+    public:
+        PipeOutput(int fd)
+            : fd(fd)
+        {
+        }
+
+        virtual void __stdcall ReportStart(const xUnitpp::ITestDetails &testDetails) override
+        {
+            Send(Message::Start, testDetails.GetId(), std::string());
+        }
+
+        virtual void __stdcall ReportEvent(const xUnitpp::ITestDetails &testDetails, const xUnitpp::ITestEvent &evt) override
+        {
+            std::string payload;
+            RemoteEvent::Write(payload, evt);
+            Send(Message::Event, testDetails.GetId(), payload);
+        }
+
+        virtual void __stdcall ReportBenchmark(const xUnitpp::ITestDetails &testDetails, const xUnitpp::IBenchmarkResult &result) override
+        {
+            std::string payload;
+            RemoteBenchmark::Write(payload, result);
+            Send(Message::Benchmark, testDetails.GetId(), payload);
+        }
+
+        virtual void __stdcall ReportMetrics(const xUnitpp::ITestDetails &testDetails, const xUnitpp::ITestMetrics &metrics) override
+        {
+            std::string payload;
+            RemoteMetrics::Write(payload, metrics);
+            Send(Message::Metrics, testDetails.GetId(), payload);
+        }
+
+        virtual void __stdcall ReportSkip(const xUnitpp::ITestDetails &testDetails, const char *reason) override
+        {
+            std::string payload;
+            Append(payload, safestr(reason));
+            Send(Message::Skip, testDetails.GetId(), payload);
+        }
+
+        virtual void __stdcall ReportFinish(const xUnitpp::ITestDetails &testDetails, long long ns) override
+        {
+            std::string payload;
+            Append(payload, (int64_t)ns);
+            Send(Message::Finish, testDetails.GetId(), payload);
+        }
+
+        virtual void __stdcall ReportAllTestsComplete(size_t, size_t, size_t, long long) override
+        {
+            // the parent keeps its own totals: this only tells it the batch ended normally
+            Send(Message::Complete, 0, std::string());
+        }
+
+    private:
+        void Send(Message type, int id, const std::string &payload)
+        {
+            std::string message;
+            Append(message, type);
+            Append(message, (int32_t)id);
+            Append(message, payload);
+
+            // if the parent has gone away, there is nobody left to tell
+            WriteAll(fd, message);
+        }
+
+    private:
+        int fd;
+    };
+
+    struct RunningTest
+    {
+        RunningTest()
+            : started(xUnitpp::Time::Clock::now())
+            , failed(false)
+            , abandoned(false)
+        {
+        }
+
+        xUnitpp::Time::TimeStamp started;
+        xUnitpp::Time::TimeStamp fatal;
+        std::vector<std::shared_ptr<RemoteEvent>> events;
+        std::vector<std::shared_ptr<RemoteBenchmark>> benchmarks;
+        std::shared_ptr<RemoteMetrics> metrics;
+        bool failed;
+        bool abandoned;
+    };
+
+    struct Child
+    {
+        Child(std::vector<int> &&batch)
+            : pid(-1)
+            , fd(-1)
+            , batch(std::move(batch))
+            , exited(false)
+            , complete(false)
+            , killed(false)
+        {
+        }
+
+        pid_t pid;
+        int fd;
+        std::vector<int> batch;
+        std::string buffer;
+        std::map<int, RunningTest> running;
+        std::set<int> done;
+        bool exited;
+        bool complete;
+        bool killed;
+    };
+
+    bool Spawn(Child &child, xUnitpp::FilteredTestsRunner runner, int timeLimit)
+    {
+        int fds[2];
+        if (pipe(fds) != 0)
+        {
+            return false;
+        }
+
+        // anything still buffered would otherwise be written once by each child as well
+        std::cout.flush();
+        std::cerr.flush();
+
+        child.pid = fork();
+
+        if (child.pid < 0)
+        {
+            close(fds[0]);
+            close(fds[1]);
+            return false;
+        }
+
+        if (child.pid == 0)
+        {
+            close(fds[0]);
+
+            int exitCode = 0;
+
+            try
+            {
+                PipeOutput output(fds[1]);
+                const auto &batch = child.batch;
+
+                // one test at a time, so that a crash can be pinned on the test that caused it
+                runner(timeLimit, 1, output,
+                    [&](const xUnitpp::ITestDetails &testDetails)
+                    {
+                        return std::binary_search(batch.begin(), batch.end(), testDetails.GetId());
+                    });
+            }
+            catch (...)
+            {
+                exitCode = 1;
+            }
+
+            // skip static destructors and atexit handlers: they belong to the parent
+            _exit(exitCode);
+        }
+
+        close(fds[1]);
+        child.fd = fds[0];
+        return true;
+    }
+
+    std::string DescribeExit(int status)
+    {
+        if (WIFSIGNALED(status))
+        {
+            auto name = strsignal(WTERMSIG(status));
+            return "Test crashed its process with signal " + std::to_string(WTERMSIG(status)) + (name == nullptr ? std::string() : " (" + std::string(name) + ")") + ".";
+        }
+
+        return "Test process exited with code " + std::to_string(WEXITSTATUS(status)) + " while the test was running.";
+    }
+}
+
+namespace xUnitpp { namespace Utilities
+{
+
+int RunIsolated(xUnitpp::FilteredTestsRunner runner, const std::vector<const ITestDetails *> &tests,
+                int timeLimit, int processLimit, size_t batchSize, IOutput &output)
+{
+    auto timeStart = Time::Clock::now();
+
+    std::map<int, const ITestDetails *> details;
+    std::vector<int> ids;
+
+    for (auto test : tests)
+    {
+        details[test->GetId()] = test;
+        ids.push_back(test->GetId());
+    }
+
+    std::random_shuffle(ids.begin(), ids.end());
+
+    batchSize = std::max(batchSize, (size_t)1);
+    std::deque<std::vector<int>> batches;
+
+    for (size_t i = 0; i < ids.size(); i += batchSize)
+    {
+        batches.emplace_back(ids.begin() + i, ids.begin() + std::min(i + batchSize, ids.size()));
+        std::sort(batches.back().begin(), batches.back().end());
+    }
+
+    if (processLimit <= 0)
+    {
+        processLimit = (int)std::max(std::thread::hardware_concurrency(), 1U);
+    }
+
+    size_t testCount = 0;
+    size_t skippedTests = 0;
+    size_t failedTests = 0;
+
+    auto finish = [&](int id, const RunningTest &test, Time::Duration time)
+        {
+            const auto &testDetails = *details[id];
+
+            output.ReportStart(testDetails);
+
+            for (const auto &evt : test.events)
+            {
+                output.ReportEvent(testDetails, *evt);
+            }
+
+            for (const auto &benchmark : test.benchmarks)
+            {
+                output.ReportBenchmark(testDetails, *benchmark);
+            }
+
+            if (test.metrics)
+            {
+                output.ReportMetrics(testDetails, *test.metrics);
+            }
+
+            output.ReportFinish(testDetails, time.count());
+
+            ++testCount;
+
+            if (test.failed)
+            {
+                ++failedTests;
+            }
+        };
+
+    auto addEvent = [](RunningTest &test, const std::shared_ptr<RemoteEvent> &evt)
+        {
+            if (evt->GetIsFailure())
+            {
+                test.failed = true;
+            }
+
+            if (evt->GetLevel() == EventLevel::Fatal && !test.abandoned)
+            {
+                test.abandoned = true;
+                test.fatal = Time::Clock::now();
+            }
+
+            test.events.push_back(evt);
+        };
+
+    auto dispatch = [&](Child &child)
+        {
+            const size_t headerSize = sizeof(Message) + sizeof(int32_t) + sizeof(uint32_t);
+            size_t pos = 0;
+
+            while (child.buffer.size() - pos >= headerSize)
+            {
+                Message type;
+                int32_t id;
+                uint32_t size;
+
+                Reader header(child.buffer.data() + pos, child.buffer.data() + pos + headerSize);
+                header.Read(type);
+                header.Read(id);
+                header.Read(size);
+
+                if (child.buffer.size() - pos - headerSize < size)
+                {
+                    break;
+                }
+
+                Reader payload(child.buffer.data() + pos + headerSize, child.buffer.data() + pos + headerSize + size);
+                pos += headerSize + size;
+
+                if (type == Message::Complete)
+                {
+                    child.complete = true;
+                }
+                else if (details.find(id) == details.end())
+                {
+                    // not one of ours: a child can only report on the tests it was given
+                }
+                else if (type == Message::Start)
+                {
+                    child.running[id] = RunningTest();
+                }
+                else if (type == Message::Event)
+                {
+                    auto evt = std::make_shared<RemoteEvent>();
+                    if (evt->Read(payload))
+                    {
+                        addEvent(child.running[id], evt);
+                    }
+                }
+                else if (type == Message::Benchmark)
+                {
+                    auto benchmark = std::make_shared<RemoteBenchmark>();
+                    if (benchmark->Read(payload))
+                    {
+                        child.running[id].benchmarks.push_back(benchmark);
+                    }
+                }
+                else if (type == Message::Metrics)
+                {
+                    auto metrics = std::make_shared<RemoteMetrics>();
+                    if (metrics->Read(payload))
+                    {
+                        child.running[id].metrics = metrics;
+                    }
+                }
+                else if (type == Message::Skip)
+                {
+                    std::string reason;
+                    payload.Read(reason);
+
+                    output.ReportSkip(*details[id], reason.c_str());
+                    ++skippedTests;
+                    child.done.insert(id);
+                }
+                else if (type == Message::Finish)
+                {
+                    int64_t ns = 0;
+                    payload.Read(ns);
+
+                    finish(id, child.running[id], Time::Duration(ns));
+                    child.running.erase(id);
+                    child.done.insert(id);
+                }
+            }
+
+            child.buffer.erase(0, pos);
+        };
+
+    // how many times each test has been given another go after some other test took its process down
+    std::map<int, int> reruns;
+
+    auto reap = [&](Child &child)
+        {
+            close(child.fd);
+
+            int status = 0;
+            while (waitpid(child.pid, &status, 0) < 0 && errno == EINTR)
+            {
+            }
+
+            // reports are delivered from a thread of their own, so a process that dies can take the last few
+            // with it: which of the unfinished tests was running at the time is only certain when there is one of them
+            std::vector<int> unfinished;
+            bool anyAbandoned = false;
+            bool anyStarted = false;
+
+            for (auto id : child.batch)
+            {
+                if (child.done.find(id) == child.done.end())
+                {
+                    unfinished.push_back(id);
+
+                    auto it = child.running.find(id);
+                    anyStarted = anyStarted || it != child.running.end();
+                    anyAbandoned = anyAbandoned || (it != child.running.end() && it->second.abandoned);
+                }
+            }
+
+            bool crashed = !child.complete && !child.killed;
+            bool lone = crashed && !anyAbandoned && unfinished.size() == 1;
+            std::vector<int> rerun;
+
+            for (auto id : unfinished)
+            {
+                auto it = child.running.find(id);
+                bool started = it != child.running.end();
+                auto test = started ? it->second : RunningTest();
+
+                if (test.abandoned)
+                {
+                    if (child.killed)
+                    {
+                        addEvent(test, std::make_shared<RemoteEvent>(EventLevel::Warning, "Test was still running after it failed, so its test process was killed."));
+                    }
+                    else
+                    {
+                        addEvent(test, std::make_shared<RemoteEvent>(EventLevel::Fatal, DescribeExit(status)));
+                    }
+                }
+                else if (lone)
+                {
+                    addEvent(test, std::make_shared<RemoteEvent>(EventLevel::Fatal, DescribeExit(status)));
+                }
+                else if (crashed && !anyAbandoned && (started || !anyStarted))
+                {
+                    // a suspect: it gets a process of its own, where there can be no doubt;
+                    // when no test was heard to start, any of them could have lost its report with the process
+                    batches.push_front(std::vector<int>(1, id));
+                    continue;
+                }
+                else if (++reruns[id] > MaxBystanderReruns)
+                {
+                    addEvent(test, std::make_shared<RemoteEvent>(EventLevel::Fatal,
+                        "Test did not get to finish: its test process was taken down by other tests " + std::to_string(MaxBystanderReruns + 1) + " times."));
+                }
+                else
+                {
+                    // an innocent bystander, or a test that never started: they get another go together in a fresh process
+                    rerun.push_back(id);
+                    continue;
+                }
+
+                finish(id, test, Time::ToDuration(Time::Clock::now() - test.started));
+                child.done.insert(id);
+            }
+
+            if (!rerun.empty())
+            {
+                batches.push_front(std::move(rerun));
+            }
+        };
+
+    std::vector<std::unique_ptr<Child>> children;
+
+    while (!batches.empty() || !children.empty())
+    {
+        while (!batches.empty() && children.size() < (size_t)processLimit)
+        {
+            std::unique_ptr<Child> child(new Child(std::move(batches.front())));
+            batches.pop_front();
+
+            if (Spawn(*child, runner, timeLimit))
+            {
+                children.push_back(std::move(child));
+            }
+            else
+            {
+                for (auto id : child->batch)
+                {
+                    RunningTest test;
+                    addEvent(test, std::make_shared<RemoteEvent>(EventLevel::Fatal, "Unable to start a test process: " + std::string(strerror(errno))));
+                    finish(id, test, Time::Duration::zero());
+                }
+            }
+        }
+
+        std::vector<pollfd> fds(children.size());
+        for (size_t i = 0; i != children.size(); ++i)
+        {
+            fds[i].fd = children[i]->fd;
+            fds[i].events = POLLIN;
+            fds[i].revents = 0;
+        }
+
+        // wake up every so often even when nothing is said, to look for abandoned tests
+        poll(fds.data(), fds.size(), 50);
+
+        auto now = Time::Clock::now();
+
+        for (size_t i = 0; i != children.size(); ++i)
+        {
+            auto &child = *children[i];
+
+            if (fds[i].revents != 0)
+            {
+                char data[4096];
+                auto bytes = read(child.fd, data, sizeof(data));
+
+                if (bytes > 0)
+                {
+                    child.buffer.append(data, bytes);
+                    dispatch(child);
+                }
+                else if (bytes == 0 || (errno != EINTR && errno != EAGAIN))
+                {
+                    child.exited = true;
+                }
+            }
+
+            if (!child.killed)
+            {
+                for (const auto &it : child.running)
+                {
+                    if (it.second.abandoned && now - it.second.fatal > AbandonedTestGracePeriod)
+                    {
+                        kill(child.pid, SIGKILL);
+                        child.killed = true;
+                        break;
+                    }
+                }
+            }
+        }
+
+        for (auto it = children.begin(); it != children.end(); )
+        {
+            if ((*it)->exited)
+            {
+                reap(**it);
+                it = children.erase(it);
+            }
+            else
+            {
+                ++it;
+            }
+        }
+    }
+
+    output.ReportAllTestsComplete(testCount, skippedTests, failedTests, Time::ToDuration(Time::Clock::now() - timeStart).count());
+
+    return (int)failedTests;
+}
+
+}}
+
+#endif
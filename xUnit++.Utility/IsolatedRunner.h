@@ -0,0 +1,31 @@
+#ifndef ISOLATEDRUNNER_H_
+#define ISOLATEDRUNNER_H_
+
+#if !defined(WIN32)
+
+#include <vector>
+#include "xUnit++/ExportApi.h"
+
+namespace xUnitpp
+{
+    struct IOutput;
+    struct ITestDetails;
+}
+
+namespace xUnitpp { namespace Utilities
+{
+
+//
+// Runs tests in forked copies of the current process, batchSize tests to a process and at most processLimit processes
+// at once (0 means one per core). Reports are streamed back over a pipe and replayed into output as each test finishes,
+// so a test that crashes its process becomes a Fatal event rather than the end of the run.
+//
+// Tests are matched up with what the children report by id, so the details must outlive the call.
+int RunIsolated(xUnitpp::FilteredTestsRunner runner, const std::vector<const ITestDetails *> &tests,
+                int timeLimit, int processLimit, size_t batchSize, IOutput &output);
+
+}}
+
+#endif
+
+#endif
@@ -0,0 +1,238 @@
+#include "JsonReporter.h"
+#include <cmath>
+#include <cstdio>
+#include "xUnit++/EventLevel.h"
+#include "xUnit++/IBenchmarkResult.h"
+#include "xUnit++/ITestDetails.h"
+#include "xUnit++/ITestEvent.h"
+#include "xUnit++/ITestMetrics.h"
+
+namespace
+{
+    void JsonString(std::string &json, const char *value)
+    {
+        static const char hex[] = "0123456789abcdef";
+
+        json += '\"';
+
+        for (; value != nullptr && *value != '\0'; ++value)
+        {
+            auto c = (unsigned char)*value;
+
+            switch (c)
+            {
+            case '\"':
+                json += "\\\"";
+                break;
+            case '\\':
+                json += "\\\\";
+                break;
+            case '\n':
+                json += "\\n";
+                break;
+            case '\r':
+                json += "\\r";
+                break;
+            case '\t':
+                json += "\\t";
+                break;
+            default:
+                if (c < 0x20)
+                {
+                    json += "\\u00";
+                    json += hex[c >> 4];
+                    json += hex[c & 0xf];
+                }
+                else
+                {
+                    json += (char)c;
+                }
+                break;
+            }
+        }
+
+        json += '\"';
+    }
+
+    void JsonKey(std::string &json, const char *key)
+    {
+        json += ",\"";
+        json += key;
+        json += "\":";
+    }
+
+    void JsonMember(std::string &json, const char *key, const char *value)
+    {
+        JsonKey(json, key);
+        JsonString(json, value);
+    }
+
+    void JsonNumber(std::string &json, long long value)
+    {
+        char buffer[32];
+        auto length = std::snprintf(buffer, sizeof(buffer), "%lld", value);
+
+        json.append(buffer, length);
+    }
+
+    void JsonMember(std::string &json, const char *key, long long value)
+    {
+        JsonKey(json, key);
+        JsonNumber(json, value);
+    }
+
+    void JsonMember(std::string &json, const char *key, double value)
+    {
+        // JSON has no spelling for nan or infinity
+        if (!std::isfinite(value))
+        {
+            JsonKey(json, key);
+            json += "null";
+            return;
+        }
+
+        char buffer[32];
+        auto length = std::snprintf(buffer, sizeof(buffer), "%.9g", value);
+
+        JsonKey(json, key);
+        json.append(buffer, length);
+    }
+
+    void JsonMember(std::string &json, const char *key, bool value)
+    {
+        JsonKey(json, key);
+        json += value ? "true" : "false";
+    }
+}
+
+namespace xUnitpp { namespace Utilities
+{
+
+JsonReporter::JsonReporter(std::ostream &output)
+    : output(output)
+{
+    line.reserve(1024);
+}
+
+JsonReporter::JsonReporter(std::ostream &output, const std::string &library)
+    : output(output)
+    , library(library)
+{
+    line.reserve(1024);
+}
+
+JsonReporter::~JsonReporter() noexcept(true)
+{
+}
+
+void JsonReporter::BeginLine(const char *type)
+{
+    line.clear();
+    line += "{\"type\":\"";
+    line += type;
+    line += '\"';
+
+    if (!library.empty())
+    {
+        JsonMember(line, "library", library.c_str());
+    }
+}
+
+void JsonReporter::BeginTestLine(const char *type, const ITestDetails &testDetails, bool withNames)
+{
+    BeginLine(type);
+    JsonMember(line, "id", (long long)testDetails.GetId());
+
+    if (withNames)
+    {
+        JsonMember(line, "suite", testDetails.GetSuite());
+        JsonMember(line, "name", testDetails.GetFullName());
+    }
+}
+
+void JsonReporter::EndLine()
+{
+    line += "}\n";
+
+    output.write(line.data(), line.size());
+    output.flush();
+}
+
+void JsonReporter::ReportStart(const ITestDetails &testDetails)
+{
+    BeginTestLine("start", testDetails, true);
+    JsonMember(line, "file", testDetails.GetFile());
+    JsonMember(line, "line", (long long)testDetails.GetLine());
+    EndLine();
+}
+
+void JsonReporter::ReportEvent(const ITestDetails &testDetails, const ITestEvent &evt)
+{
+    BeginTestLine("event", testDetails, false);
+    JsonMember(line, "level", to_string(evt.GetLevel()).c_str());
+    JsonMember(line, "failure", evt.GetIsFailure());
+    JsonMember(line, "file", evt.GetFile());
+    JsonMember(line, "line", (long long)evt.GetLine());
+    JsonMember(line, "message", evt.GetToString());
+    EndLine();
+}
+
+void JsonReporter::ReportSkip(const ITestDetails &testDetails, const char *reason)
+{
+    BeginTestLine("skip", testDetails, true);
+    JsonMember(line, "reason", reason);
+    EndLine();
+}
+
+void JsonReporter::ReportBenchmark(const ITestDetails &testDetails, const IBenchmarkResult &benchmark)
+{
+    BeginTestLine("benchmark", testDetails, false);
+    JsonMember(line, "iterations", benchmark.GetIterations());
+    JsonMember(line, "samples", (long long)benchmark.GetSampleCount());
+    JsonMember(line, "mean", benchmark.GetMean());
+    JsonMember(line, "stddev", benchmark.GetStandardDeviation());
+    JsonMember(line, "min", benchmark.GetMin());
+    JsonMember(line, "max", benchmark.GetMax());
+    EndLine();
+}
+
+void JsonReporter::ReportMetrics(const ITestDetails &testDetails, const ITestMetrics &metrics)
+{
+    BeginTestLine("metrics", testDetails, false);
+    JsonKey(line, "metrics");
+
+    line += '{';
+    for (size_t i = 0; i != metrics.GetCount(); ++i)
+    {
+        if (i != 0)
+        {
+            line += ',';
+        }
+
+        JsonString(line, metrics.GetName(i));
+        line += ':';
+        JsonNumber(line, metrics.GetValue(i));
+    }
+    line += '}';
+
+    EndLine();
+}
+
+void JsonReporter::ReportFinish(const ITestDetails &testDetails, long long nsTaken)
+{
+    BeginTestLine("finish", testDetails, false);
+    JsonMember(line, "ns", nsTaken);
+    EndLine();
+}
+
+void JsonReporter::ReportAllTestsComplete(size_t testCount, size_t skipped, size_t failureCount, long long nsTotal)
+{
+    BeginLine("summary");
+    JsonMember(line, "tests", (long long)testCount);
+    JsonMember(line, "skipped", (long long)skipped);
+    JsonMember(line, "failures", (long long)failureCount);
+    JsonMember(line, "ns", nsTotal);
+    EndLine();
+}
+
+}}
@@ -0,0 +1,56 @@
+#ifndef JSONREPORTER_H_
+#define JSONREPORTER_H_
+
+#if defined(_MSC_VER)
+# if !defined(_ALLOW_KEYWORD_MACROS)
+#  define _ALLOW_KEYWORD_MACROS
+# endif
+#define noexcept(x)
+#endif
+
+#include <ostream>
+#include <string>
+#include "xUnit++/IOutput.h"
+
+namespace xUnitpp { namespace Utilities
+{
+
+//
+// Writes one compact JSON object per line (NDJSON) for every report, as it happens, and flushes after each one
+// so the results can be followed while the run is still going. Every object has a "type" of start, event, skip,
+// benchmark, metrics, finish or summary; the per-test objects also carry the test's "id".
+// Test ids are only unique within one library, so when several libraries report into the same output, each
+// gets a reporter of its own that adds its "library" to every object.
+class JsonReporter : public IOutput
+{
+public:
+    JsonReporter(std::ostream &output);
+    JsonReporter(std::ostream &output, const std::string &library);
+    virtual ~JsonReporter() noexcept(true);
+
+    virtual void __stdcall ReportStart(const ITestDetails &testDetails) override;
+    virtual void __stdcall ReportEvent(const ITestDetails &testDetails, const ITestEvent &evt) override;
+    virtual void __stdcall ReportSkip(const ITestDetails &testDetails, const char *reason) override;
+    virtual void __stdcall ReportFinish(const ITestDetails &testDetails, long long nsTaken) override;
+    virtual void __stdcall ReportAllTestsComplete(size_t testCount, size_t skipped, size_t failureCount, long long nsTotal) override;
+    virtual void __stdcall ReportBenchmark(const ITestDetails &testDetails, const IBenchmarkResult &benchmark) override;
+    virtual void __stdcall ReportMetrics(const ITestDetails &testDetails, const ITestMetrics &metrics) override;
+
+private:
+    JsonReporter &operator =(JsonReporter) /* = delete; */;
+
+    void BeginLine(const char *type);
+    void BeginTestLine(const char *type, const ITestDetails &testDetails, bool withNames);
+    void EndLine();
+
+private:
+    std::ostream &output;
+    std::string library;
+
+    // reports arrive one at a time, so every line is built in the same buffer
+    std::string line;
+};
+
+}}
+
+#endif
@@ -0,0 +1,100 @@
+#include "MultiReporter.h"
+
+namespace xUnitpp { namespace Utilities
+{
+
+MultiReporter::MultiReporter()
+    : lock(nullptr)
+{
+}
+
+MultiReporter::MultiReporter(std::mutex &lock)
+    : lock(&lock)
+{
+}
+
+MultiReporter::~MultiReporter() noexcept(true)
+{
+}
+
+void MultiReporter::Add(IOutput &reporter)
+{
+    reporters.push_back(&reporter);
+}
+
+void MultiReporter::ReportStart(const ITestDetails &testDetails)
+{
+    auto guard = Hold();
+
+    for (auto reporter : reporters)
+    {
+        reporter->ReportStart(testDetails);
+    }
+}
+
+void MultiReporter::ReportEvent(const ITestDetails &testDetails, const ITestEvent &evt)
+{
+    auto guard = Hold();
+
+    for (auto reporter : reporters)
+    {
+        reporter->ReportEvent(testDetails, evt);
+    }
+}
+
+void MultiReporter::ReportSkip(const ITestDetails &testDetails, const char *reason)
+{
+    auto guard = Hold();
+
+    for (auto reporter : reporters)
+    {
+        reporter->ReportSkip(testDetails, reason);
+    }
+}
+
+void MultiReporter::ReportFinish(const ITestDetails &testDetails, long long nsTaken)
+{
+    auto guard = Hold();
+
+    for (auto reporter : reporters)
+    {
+        reporter->ReportFinish(testDetails, nsTaken);
+    }
+}
+
+void MultiReporter::ReportAllTestsComplete(size_t testCount, size_t skipped, size_t failureCount, long long nsTotal)
+{
+    auto guard = Hold();
+
+    for (auto reporter : reporters)
+    {
+        reporter->ReportAllTestsComplete(testCount, skipped, failureCount, nsTotal);
+    }
+}
+
+void MultiReporter::ReportBenchmark(const ITestDetails &testDetails, const IBenchmarkResult &benchmark)
+{
+    auto guard = Hold();
+
+    for (auto reporter : reporters)
+    {
+        reporter->ReportBenchmark(testDetails, benchmark);
+    }
+}
+
+void MultiReporter::ReportMetrics(const ITestDetails &testDetails, const ITestMetrics &metrics)
+{
+    auto guard = Hold();
+
+    for (auto reporter : reporters)
+    {
+        reporter->ReportMetrics(testDetails, metrics);
+    }
+}
+
+std::unique_lock<std::mutex> MultiReporter::Hold()
+{
+    return lock != nullptr ? std::unique_lock<std::mutex>(*lock) : std::unique_lock<std::mutex>();
+}
+
+}}
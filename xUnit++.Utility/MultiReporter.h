@@ -0,0 +1,48 @@
+#ifndef MULTIREPORTER_H_
+#define MULTIREPORTER_H_
+
+#if defined(_MSC_VER)
+# if !defined(_ALLOW_KEYWORD_MACROS)
+#  define _ALLOW_KEYWORD_MACROS
+# endif
+#define noexcept(x)
+#endif
+
+#include <mutex>
+#include <vector>
+#include "xUnit++/IOutput.h"
+
+namespace xUnitpp { namespace Utilities
+{
+
+//
+// Forwards every report, in order, to each attached reporter.
+// Given a lock, each report is forwarded while holding it, so reporters shared by several runs at once see one report at a time.
+class MultiReporter : public IOutput
+{
+public:
+    MultiReporter();
+    explicit MultiReporter(std::mutex &lock);
+    virtual ~MultiReporter() noexcept(true);
+
+    void Add(IOutput &reporter);
+
+    virtual void __stdcall ReportStart(const ITestDetails &testDetails) override;
+    virtual void __stdcall ReportEvent(const ITestDetails &testDetails, const ITestEvent &evt) override;
+    virtual void __stdcall ReportSkip(const ITestDetails &testDetails, const char *reason) override;
+    virtual void __stdcall ReportFinish(const ITestDetails &testDetails, long long nsTaken) override;
+    virtual void __stdcall ReportAllTestsComplete(size_t testCount, size_t skipped, size_t failureCount, long long nsTotal) override;
+    virtual void __stdcall ReportBenchmark(const ITestDetails &testDetails, const IBenchmarkResult &benchmark) override;
+    virtual void __stdcall ReportMetrics(const ITestDetails &testDetails, const ITestMetrics &metrics) override;
+
+private:
+    std::unique_lock<std::mutex> Hold();
+
+private:
+    std::vector<IOutput *> reporters;
+    std::mutex *lock;
+};
+
+}}
+
+#endif
@@ -0,0 +1,638 @@
+#include "ResultLog.h"
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include "xUnit++/ITestDetails.h"
+#include "xUnit++/ITestEvent.h"
+#include "Fnv1a.h"
+
+#if !defined(WIN32)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+    const char *safestr(const char *str)
+    {
+        return str == nullptr ? "" : str;
+    }
+
+    //
+    // Reads records out of the mapped log. Running off the end of the data
+    // sets failed, and every read after that returns zeroes.
+    class Cursor
+    {
+    public:
+        Cursor(const unsigned char *begin, const unsigned char *end)
+            : pos(begin)
+            , end(end)
+            , failed(false)
+        {
+        }
+
+        bool AtEnd() const
+        {
+            return pos == end;
+        }
+
+        bool Failed() const
+        {
+            return failed;
+        }
+
+        unsigned char Byte()
+        {
+            if (pos == end)
+            {
+                failed = true;
+                return 0;
+            }
+
+            return *pos++;
+        }
+
+        unsigned long long Varint()
+        {
+            unsigned long long value = 0;
+
+            for (int shift = 0; shift < 64; shift += 7)
+            {
+                auto byte = Byte();
+                value |= (unsigned long long)(byte & 0x7f) << shift;
+
+                if ((byte & 0x80) == 0)
+                {
+                    return value;
+                }
+            }
+
+            failed = true;
+            return 0;
+        }
+
+        xUnitpp::Utilities::ResultLog::StringRef String()
+        {
+            xUnitpp::Utilities::ResultLog::StringRef str = { "", 0 };
+
+            auto length = Varint();
+            if (failed || length > (unsigned long long)(end - pos))
+            {
+                failed = true;
+                return str;
+            }
+
+            str.data = (const char *)pos;
+            str.size = (size_t)length;
+            pos += length;
+
+            return str;
+        }
+
+    private:
+        const unsigned char *pos;
+        const unsigned char *end;
+        bool failed;
+    };
+
+    struct TestKey
+    {
+        xUnitpp::Utilities::ResultLog::StringRef suite;
+        xUnitpp::Utilities::ResultLog::StringRef name;
+
+        bool operator ==(const TestKey &other) const
+        {
+            return suite == other.suite && name == other.name;
+        }
+    };
+
+    struct TestKeyHash
+    {
+        size_t operator ()(const TestKey &key) const
+        {
+            xUnitpp::Utilities::Fnv1a hash;
+
+            hash.AddBytes(key.suite.data, key.suite.size);
+            hash.AddByte(0xff);
+            hash.AddBytes(key.name.data, key.name.size);
+
+            return (size_t)hash.Value();
+        }
+    };
+
+    bool Failed(const xUnitpp::Utilities::ResultLog::Test &test)
+    {
+        return test.result == xUnitpp::Utilities::ResultLog::Test::Failure || test.result == xUnitpp::Utilities::ResultLog::Test::Unfinished;
+    }
+
+    bool Ran(const xUnitpp::Utilities::ResultLog::Test &test)
+    {
+        return test.result == xUnitpp::Utilities::ResultLog::Test::Success || test.result == xUnitpp::Utilities::ResultLog::Test::Failure;
+    }
+}
+
+namespace xUnitpp { namespace Utilities
+{
+
+ResultLogWriter::ResultLogWriter(std::ostream &output)
+    : log(*this)
+    , output(output)
+    , currentSection(0)
+    , nextSection(1)
+    , section(0)
+    , nextTest(0)
+{
+    buffer.reserve(4096);
+    buffer.append(ResultLogFormat::Magic, sizeof(ResultLogFormat::Magic));
+    Flush();
+}
+
+ResultLogWriter::ResultLogWriter(ResultLogWriter &log, unsigned long long section)
+    : log(log)
+    , output(log.output)
+    , currentSection(0)
+    , nextSection(0)
+    , section(section)
+    , nextTest(0)
+{
+}
+
+ResultLogWriter::~ResultLogWriter() noexcept(true)
+{
+}
+
+std::unique_ptr<ResultLogWriter> ResultLogWriter::AddSection()
+{
+    return std::unique_ptr<ResultLogWriter>(new ResultLogWriter(log, log.nextSection++));
+}
+
+void ResultLogWriter::Record(ResultLogFormat::Tag tag)
+{
+    if (log.currentSection != section)
+    {
+        log.buffer += (char)ResultLogFormat::Library;
+        Varint(section);
+        log.currentSection = section;
+    }
+
+    log.buffer += (char)tag;
+}
+
+void ResultLogWriter::Varint(unsigned long long value)
+{
+    while (value >= 0x80)
+    {
+        log.buffer += (char)((value & 0x7f) | 0x80);
+        value >>= 7;
+    }
+
+    log.buffer += (char)value;
+}
+
+void ResultLogWriter::String(const char *value)
+{
+    value = safestr(value);
+
+    auto length = std::strlen(value);
+    Varint(length);
+    log.buffer.append(value, length);
+}
+
+unsigned long long ResultLogWriter::Intern(const char *value)
+{
+    // strings are shared by every section
+    auto it = log.strings.find(safestr(value));
+
+    if (it != log.strings.end())
+    {
+        return it->second;
+    }
+
+    auto index = (unsigned long long)log.strings.size();
+    log.strings.insert(std::make_pair(std::string(safestr(value)), index));
+
+    log.buffer += (char)ResultLogFormat::String;
+    String(value);
+
+    return index;
+}
+
+unsigned long long ResultLogWriter::TestNumber(const ITestDetails &testDetails)
+{
+    auto it = tests.find(testDetails.GetId());
+
+    if (it != tests.end())
+    {
+        return it->second;
+    }
+
+    // the strings have to be interned before the record that uses them is started
+    auto suite = Intern(testDetails.GetSuite());
+    auto file = Intern(testDetails.GetFile());
+
+    std::vector<std::pair<unsigned long long, unsigned long long>> attributes;
+    for (size_t i = 0; i != testDetails.GetAttributeCount(); ++i)
+    {
+        auto key = Intern(testDetails.GetAttributeKey(i));
+        attributes.push_back(std::make_pair(key, Intern(testDetails.GetAttributeValue(i))));
+    }
+
+    Record(ResultLogFormat::Test);
+    Varint(suite);
+    String(testDetails.GetFullName());
+    Varint(file);
+    Varint((unsigned long long)testDetails.GetLine());
+    Varint(attributes.size());
+
+    for (const auto &attribute : attributes)
+    {
+        Varint(attribute.first);
+        Varint(attribute.second);
+    }
+
+    auto number = nextTest++;
+    tests.insert(std::make_pair(testDetails.GetId(), number));
+
+    return number;
+}
+
+void ResultLogWriter::Flush()
+{
+    output.write(log.buffer.data(), log.buffer.size());
+    log.buffer.clear();
+}
+
+void ResultLogWriter::ReportStart(const ITestDetails &testDetails)
+{
+    TestNumber(testDetails);
+    Flush();
+}
+
+void ResultLogWriter::ReportEvent(const ITestDetails &testDetails, const ITestEvent &evt)
+{
+    auto test = TestNumber(testDetails);
+    auto file = Intern(evt.GetFile());
+
+    Record(ResultLogFormat::Event);
+    Varint(test);
+    log.buffer += (char)evt.GetLevel();
+    log.buffer += (char)(evt.GetIsFailure() ? 1 : 0);
+    Varint(file);
+    Varint((unsigned long long)std::max(evt.GetLine(), 0));
+    String(evt.GetToString());
+    Flush();
+}
+
+void ResultLogWriter::ReportSkip(const ITestDetails &testDetails, const char *reason)
+{
+    auto test = TestNumber(testDetails);
+
+    Record(ResultLogFormat::Skip);
+    Varint(test);
+    String(reason);
+    Flush();
+
+    tests.erase(testDetails.GetId());
+}
+
+void ResultLogWriter::ReportFinish(const ITestDetails &testDetails, long long nsTaken)
+{
+    auto test = TestNumber(testDetails);
+
+    Record(ResultLogFormat::Finish);
+    Varint(test);
+    Varint((unsigned long long)std::max(nsTaken, 0LL));
+    Flush();
+
+    tests.erase(testDetails.GetId());
+}
+
+void ResultLogWriter::ReportAllTestsComplete(size_t testCount, size_t skipped, size_t failureCount, long long nsTotal)
+{
+    Record(ResultLogFormat::Summary);
+    Varint(testCount);
+    Varint(skipped);
+    Varint(failureCount);
+    Varint((unsigned long long)std::max(nsTotal, 0LL));
+    Flush();
+
+    output.flush();
+
+    // a reader numbers the section's tests after each summary from zero again, as the next library's run begins
+    tests.clear();
+    nextTest = 0;
+}
+
+std::string ResultLog::StringRef::str() const
+{
+    return std::string(data, size);
+}
+
+bool ResultLog::StringRef::operator ==(const StringRef &other) const
+{
+    return size == other.size && std::memcmp(data, other.data, size) == 0;
+}
+
+ResultLog::ResultLog()
+    : data(nullptr)
+    , size(0)
+    , mapped(false)
+    , truncated(false)
+{
+}
+
+ResultLog::~ResultLog()
+{
+#if !defined(WIN32)
+    if (mapped)
+    {
+        munmap((void *)data, size);
+    }
+#endif
+}
+
+bool ResultLog::Load(std::istream &input)
+{
+    fallback.assign(std::istreambuf_iterator<char>(input), std::istreambuf_iterator<char>());
+    data = (const unsigned char *)fallback.data();
+    size = fallback.size();
+
+    return Parse();
+}
+
+bool ResultLog::Load(const std::string &file)
+{
+#if !defined(WIN32)
+    int fd = open(file.c_str(), O_RDONLY);
+    if (fd < 0)
+    {
+        return false;
+    }
+
+    struct stat info;
+    if (fstat(fd, &info) == 0 && info.st_size > 0)
+    {
+        void *mapping = mmap(nullptr, (size_t)info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+
+        if (mapping != MAP_FAILED)
+        {
+            data = (const unsigned char *)mapping;
+            size = (size_t)info.st_size;
+            mapped = true;
+        }
+    }
+
+    close(fd);
+
+    if (mapped)
+    {
+        return Parse();
+    }
+#endif
+
+    std::ifstream input(file, std::ios::binary);
+    return input && Load(input);
+}
+
+bool ResultLog::Parse()
+{
+    if (size < sizeof(ResultLogFormat::Magic) || std::memcmp(data, ResultLogFormat::Magic, sizeof(ResultLogFormat::Magic)) != 0)
+    {
+        return false;
+    }
+
+    Cursor cursor(data + sizeof(ResultLogFormat::Magic), data + size);
+
+    std::vector<StringRef> strings;
+
+    // the tests each section has numbered since its last summary, by number
+    std::unordered_map<unsigned long long, std::vector<size_t>> sections;
+    auto section = &sections[0];
+
+    auto string = [&]() -> StringRef
+        {
+            auto index = cursor.Varint();
+            if (index >= strings.size())
+            {
+                StringRef empty = { "", 0 };
+                return empty;
+            }
+
+            return strings[(size_t)index];
+        };
+
+    auto testIndex = [&]() -> size_t
+        {
+            auto number = cursor.Varint();
+            return number < section->size() ? (*section)[(size_t)number] : tests.size();
+        };
+
+    auto test = [&]() -> Test *
+        {
+            auto index = testIndex();
+            return index < tests.size() ? &tests[index] : nullptr;
+        };
+
+    while (!cursor.AtEnd() && !cursor.Failed())
+    {
+        switch (cursor.Byte())
+        {
+        case ResultLogFormat::String:
+            strings.push_back(cursor.String());
+            break;
+
+        case ResultLogFormat::Test:
+            {
+                Test record;
+                record.suite = string();
+                record.name = cursor.String();
+                record.file = string();
+                record.line = (int)cursor.Varint();
+                record.result = Test::Unfinished;
+                record.ns = 0;
+                record.skipReason.data = "";
+                record.skipReason.size = 0;
+                record.firstAttribute = attributes.size();
+                record.attributeCount = (size_t)cursor.Varint();
+
+                for (size_t i = 0; i != record.attributeCount && !cursor.Failed(); ++i)
+                {
+                    auto key = string();
+                    attributes.push_back(std::make_pair(key, string()));
+                }
+
+                if (!cursor.Failed())
+                {
+                    section->push_back(tests.size());
+                    tests.push_back(record);
+                }
+            }
+            break;
+
+        case ResultLogFormat::Event:
+            {
+                Event event;
+                event.test = testIndex();
+                event.level = (EventLevel)cursor.Byte();
+                event.failure = cursor.Byte() != 0;
+                event.file = string();
+                event.line = (int)cursor.Varint();
+                event.message = cursor.String();
+
+                if (!cursor.Failed() && event.test < tests.size())
+                {
+                    events.push_back(event);
+
+                    if (event.failure)
+                    {
+                        tests[event.test].result = Test::Failure;
+                    }
+                }
+            }
+            break;
+
+        case ResultLogFormat::Skip:
+            {
+                auto record = test();
+                auto reason = cursor.String();
+
+                if (!cursor.Failed() && record != nullptr)
+                {
+                    record->result = Test::Skipped;
+                    record->skipReason = reason;
+                }
+            }
+            break;
+
+        case ResultLogFormat::Finish:
+            {
+                auto record = test();
+                auto ns = (long long)cursor.Varint();
+
+                if (!cursor.Failed() && record != nullptr)
+                {
+                    record->ns = ns;
+
+                    if (record->result == Test::Unfinished)
+                    {
+                        record->result = Test::Success;
+                    }
+                }
+            }
+            break;
+
+        case ResultLogFormat::Summary:
+            for (int i = 0; i != 4; ++i)
+            {
+                cursor.Varint();
+            }
+
+            section->clear();
+            break;
+
+        case ResultLogFormat::Library:
+            section = &sections[cursor.Varint()];
+            break;
+
+        default:
+            // an unknown record can't be skipped over, so the rest of the log is lost
+            truncated = true;
+            return true;
+        }
+    }
+
+    truncated = cursor.Failed();
+    return true;
+}
+
+const std::vector<ResultLog::Test> &ResultLog::Tests() const
+{
+    return tests;
+}
+
+const std::vector<ResultLog::Event> &ResultLog::Events() const
+{
+    return events;
+}
+
+const std::vector<std::pair<ResultLog::StringRef, ResultLog::StringRef>> &ResultLog::Attributes() const
+{
+    return attributes;
+}
+
+bool ResultLog::Truncated() const
+{
+    return truncated;
+}
+
+ResultLogDiff CompareResultLogs(const ResultLog &before, const ResultLog &after, long long threshold)
+{
+    ResultLogDiff diff;
+
+    const auto &beforeTests = before.Tests();
+    const auto &afterTests = after.Tests();
+
+    std::unordered_map<TestKey, size_t, TestKeyHash> beforeIndex(beforeTests.size());
+    for (size_t i = 0; i != beforeTests.size(); ++i)
+    {
+        TestKey key = { beforeTests[i].suite, beforeTests[i].name };
+        beforeIndex[key] = i;
+    }
+
+    std::vector<bool> matched(beforeTests.size());
+
+    for (size_t i = 0; i != afterTests.size(); ++i)
+    {
+        const auto &test = afterTests[i];
+
+        TestKey key = { test.suite, test.name };
+        auto it = beforeIndex.find(key);
+
+        if (it == beforeIndex.end())
+        {
+            diff.added.push_back(i);
+            continue;
+        }
+
+        matched[it->second] = true;
+
+        const auto &previous = beforeTests[it->second];
+        ResultLogDiff::Change change = { it->second, i };
+
+        if (Failed(test) && !Failed(previous))
+        {
+            diff.newFailures.push_back(change);
+        }
+        else if (!Failed(test) && Failed(previous) && test.result != ResultLog::Test::Skipped)
+        {
+            diff.fixed.push_back(change);
+        }
+
+        if (Ran(test) && Ran(previous) && std::abs(test.ns - previous.ns) >= threshold)
+        {
+            diff.durationChanges.push_back(change);
+        }
+    }
+
+    for (size_t i = 0; i != beforeTests.size(); ++i)
+    {
+        if (!matched[i])
+        {
+            diff.removed.push_back(i);
+        }
+    }
+
+    std::sort(diff.durationChanges.begin(), diff.durationChanges.end(),
+        [&](const ResultLogDiff::Change &a, const ResultLogDiff::Change &b)
+        {
+            return std::abs(afterTests[a.after].ns - beforeTests[a.before].ns) > std::abs(afterTests[b.after].ns - beforeTests[b.before].ns);
+        });
+
+    return diff;
+}
+
+}}
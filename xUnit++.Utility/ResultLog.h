@@ -0,0 +1,197 @@
+#ifndef RESULTLOG_H_
+#define RESULTLOG_H_
+
+#if defined(_MSC_VER)
+# if !defined(_ALLOW_KEYWORD_MACROS)
+#  define _ALLOW_KEYWORD_MACROS
+# endif
+#define noexcept(x)
+#endif
+
+#include <istream>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "xUnit++/EventLevel.h"
+#include "xUnit++/IOutput.h"
+
+namespace xUnitpp { namespace Utilities
+{
+
+//
+// A compact binary record of a test run, meant to be archived for every build and compared later.
+//
+// The log is the 8 byte magic "xUlog\0\0" + version, followed by records. Each record is a tag byte and
+// LEB128 varints; strings are a varint length and their bytes. Strings that repeat (suites, files, attribute
+// keys and values) are interned: the first use writes a String record, and every use refers to it by number.
+// Tests are numbered in the order their Test record appears, and that number is what later records refer to.
+// Test names and messages are rarely repeated, so they are written inline.
+// Libraries that run at the same time write into the same log as sections of their own: each section numbers
+// its own tests, and a Library record marks every switch from one to another. A log without any is all section 0.
+namespace ResultLogFormat
+{
+    static const char Magic[8] = { 'x', 'U', 'l', 'o', 'g', '\0', '\0', '\1' };
+
+    enum Tag
+    {
+        String = 1,     // length, bytes
+        Test,           // suite, name (inline), file, line, attribute count, (key, value)*
+        Event,          // test, level, failure, file, line, message (inline)
+        Skip,           // test, reason (inline)
+        Finish,         // test, nanoseconds
+        Summary,        // tests, skipped, failures, nanoseconds; the section's test numbers restart after each summary
+        Library,        // section
+    };
+}
+
+//
+// Writes a result log as the run happens, so a crashed run still leaves a usable (if incomplete) log behind.
+class ResultLogWriter : public IOutput
+{
+public:
+    ResultLogWriter(std::ostream &output);
+    virtual ~ResultLogWriter() noexcept(true);
+
+    // a writer for another library's run into the same log, in a section of its own, so that it can run at the
+    // same time as the others; reports to all of the log's writers still have to be serialized
+    std::unique_ptr<ResultLogWriter> AddSection();
+
+    virtual void __stdcall ReportStart(const ITestDetails &testDetails) override;
+    virtual void __stdcall ReportEvent(const ITestDetails &testDetails, const ITestEvent &evt) override;
+    virtual void __stdcall ReportSkip(const ITestDetails &testDetails, const char *reason) override;
+    virtual void __stdcall ReportFinish(const ITestDetails &testDetails, long long nsTaken) override;
+    virtual void __stdcall ReportAllTestsComplete(size_t testCount, size_t skipped, size_t failureCount, long long nsTotal) override;
+
+private:
+    ResultLogWriter(ResultLogWriter &log, unsigned long long section);
+    ResultLogWriter &operator =(ResultLogWriter) /* = delete; */;
+
+    void Record(ResultLogFormat::Tag tag);
+    unsigned long long Intern(const char *value);
+    unsigned long long TestNumber(const ITestDetails &testDetails);
+
+    void Varint(unsigned long long value);
+    void String(const char *value);
+    void Flush();
+
+private:
+    // the writer that owns the log; the output, buffer and strings are only ever used from that one
+    ResultLogWriter &log;
+    std::ostream &output;
+    std::string buffer;
+
+    std::unordered_map<std::string, unsigned long long> strings;
+    unsigned long long currentSection;
+    unsigned long long nextSection;
+
+    const unsigned long long section;
+
+    // only tests that are still running; ids are only unique within one library, so they are forgotten at every summary
+    std::unordered_map<int, unsigned long long> tests;
+    unsigned long long nextTest;
+};
+
+//
+// A result log, read straight out of a memory mapping of the file.
+// Strings point into the mapping, so they are only valid while the ResultLog is.
+class ResultLog
+{
+public:
+    struct StringRef
+    {
+        const char *data;
+        size_t size;
+
+        std::string str() const;
+        bool operator ==(const StringRef &other) const;
+    };
+
+    struct Event
+    {
+        size_t test;
+        EventLevel level;
+        bool failure;
+        StringRef file;
+        int line;
+        StringRef message;
+    };
+
+    struct Test
+    {
+        enum Result
+        {
+            Success,
+            Failure,
+            Skipped,
+            Unfinished
+        };
+
+        StringRef suite;
+        StringRef name;
+        StringRef file;
+        int line;
+        Result result;
+        long long ns;
+        StringRef skipReason;
+
+        // attributes are [firstAttribute, firstAttribute + attributeCount) of Attributes()
+        size_t firstAttribute;
+        size_t attributeCount;
+    };
+
+    ResultLog();
+    ~ResultLog();
+
+    // a truncated log (from a run that died part way through) loads everything before the damage
+    bool Load(std::istream &input);
+    bool Load(const std::string &file);
+
+    const std::vector<Test> &Tests() const;
+    const std::vector<Event> &Events() const;
+    const std::vector<std::pair<StringRef, StringRef>> &Attributes() const;
+    bool Truncated() const;
+
+private:
+    ResultLog(const ResultLog &) /* = delete */;
+    ResultLog &operator =(ResultLog) /* = delete */;
+
+    bool Parse();
+
+private:
+    const unsigned char *data;
+    size_t size;
+    std::vector<char> fallback;
+    bool mapped;
+    bool truncated;
+
+    std::vector<Test> tests;
+    std::vector<Event> events;
+    std::vector<std::pair<StringRef, StringRef>> attributes;
+};
+
+//
+// What changed between two runs, with tests matched up by suite and full name.
+// Every entry is an index into the before and/or after log's Tests().
+struct ResultLogDiff
+{
+    struct Change
+    {
+        size_t before;
+        size_t after;
+    };
+
+    std::vector<Change> newFailures;
+    std::vector<Change> fixed;
+    std::vector<Change> durationChanges;    // largest change first
+    std::vector<size_t> added;
+    std::vector<size_t> removed;
+};
+
+// a test's duration has changed when the difference is at least threshold nanoseconds
+ResultLogDiff CompareResultLogs(const ResultLog &before, const ResultLog &after, long long threshold);
+
+}}
+
+#endif
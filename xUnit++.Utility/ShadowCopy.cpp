@@ -0,0 +1,323 @@
+#include "ShadowCopy.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include "AtomicFile.h"
+#include "DiscoveryCache.h"
+#include "Fnv1a.h"
+
+#if defined(WIN32)
+#include <direct.h>
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+# if defined(__linux__)
+#include <linux/fs.h>
+#include <sys/ioctl.h>
+# endif
+#endif
+
+namespace
+{
+    const char Magic[4] = { 'x', 'U', 'S', '1' };
+
+#if !defined(WIN32)
+    bool WriteAll(int dest, const char *buffer, size_t size)
+    {
+        while (size != 0)
+        {
+            auto written = write(dest, buffer, size);
+
+            if (written < 0)
+            {
+                if (errno == EINTR)
+                {
+                    continue;
+                }
+
+                return false;
+            }
+
+            buffer += written;
+            size -= (size_t)written;
+        }
+
+        return true;
+    }
+
+    bool CopyContents(int source, int dest)
+    {
+# if defined(__linux__)
+#  if defined(FICLONE)
+        // on a copy-on-write file system (btrfs, xfs), the copy shares the library's blocks, and costs next to nothing
+        if (ioctl(dest, FICLONE, source) == 0)
+        {
+            return true;
+        }
+#  endif
+
+#  if defined(__GLIBC__) && (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 27))
+        // otherwise the kernel can still do the copy without bringing every byte into user space
+        bool copied = false;
+
+        for (;;)
+        {
+            auto size = copy_file_range(source, nullptr, dest, nullptr, 1 << 30, 0);
+
+            if (size > 0)
+            {
+                copied = true;
+                continue;
+            }
+
+            if (size == 0)
+            {
+                return true;
+            }
+
+            if (errno == EINTR)
+            {
+                continue;
+            }
+
+            // not supported between these files: fall back to reading and writing, unless part of it is already copied
+            if (copied || (errno != ENOSYS && errno != EXDEV && errno != EINVAL && errno != EOPNOTSUPP))
+            {
+                return false;
+            }
+
+            break;
+        }
+#  endif
+# endif
+
+        char buffer[1 << 16];
+
+        for (;;)
+        {
+            auto size = read(source, buffer, sizeof(buffer));
+
+            if (size == 0)
+            {
+                return true;
+            }
+
+            if (size < 0)
+            {
+                if (errno == EINTR)
+                {
+                    continue;
+                }
+
+                return false;
+            }
+
+            if (!WriteAll(dest, buffer, (size_t)size))
+            {
+                return false;
+            }
+        }
+    }
+#endif
+
+    std::string Hex(unsigned long long value)
+    {
+        static const char digits[] = "0123456789abcdef";
+
+        std::string hex(16, '0');
+        for (int i = 15; i >= 0; --i, value >>= 4)
+        {
+            hex[i] = digits[value & 0xf];
+        }
+
+        return hex;
+    }
+
+    std::string Extension(const std::string &file)
+    {
+        auto dot = file.find_last_of('.');
+        auto separator = file.find_last_of("/\\");
+
+        if (dot == std::string::npos || (separator != std::string::npos && dot < separator))
+        {
+            return "";
+        }
+
+        return file.substr(dot);
+    }
+
+    bool Exists(const std::string &file)
+    {
+        return (bool)std::ifstream(file, std::ios::binary);
+    }
+
+    bool MakeDirectory(const std::string &directory)
+    {
+#if defined(WIN32)
+        return _mkdir(directory.c_str()) == 0 || errno == EEXIST;
+#else
+        return mkdir(directory.c_str(), 0777) == 0 || errno == EEXIST;
+#endif
+    }
+
+    bool ReadStamp(const std::string &file, xUnitpp::Utilities::DiscoveryCache::Stamp &stamp)
+    {
+        std::ifstream input(file, std::ios::binary);
+
+        char magic[sizeof(Magic)];
+        return input.read(magic, sizeof(magic)) && std::equal(magic, magic + sizeof(magic), Magic) &&
+            input.read(reinterpret_cast<char *>(&stamp.size), sizeof(stamp.size)) &&
+            input.read(reinterpret_cast<char *>(&stamp.modified), sizeof(stamp.modified)) &&
+            input.read(reinterpret_cast<char *>(&stamp.hash), sizeof(stamp.hash));
+    }
+
+    void WriteStamp(const std::string &file, const xUnitpp::Utilities::DiscoveryCache::Stamp &stamp)
+    {
+        xUnitpp::Utilities::SaveAtomically(file, [&](std::ostream &output)
+            {
+                output.write(Magic, sizeof(Magic));
+                output.write(reinterpret_cast<const char *>(&stamp.size), sizeof(stamp.size));
+                output.write(reinterpret_cast<const char *>(&stamp.modified), sizeof(stamp.modified));
+                output.write(reinterpret_cast<const char *>(&stamp.hash), sizeof(stamp.hash));
+
+                return (bool)output;
+            });
+    }
+}
+
+namespace xUnitpp { namespace Utilities
+{
+
+#if defined(WIN32)
+std::string ShadowCopy(const std::string &file, const std::string &directory)
+{
+    char tempPath[MAX_PATH] = {0};
+    if (!directory.empty() || GetTempPath(MAX_PATH, tempPath) > 0)
+    {
+        if (GetTempFileName(directory.empty() ? tempPath : directory.c_str(), "xU+", 0, tempPath) != 0)
+        {
+            if (::CopyFile(file.c_str(), tempPath, FALSE))
+            {
+                return tempPath;
+            }
+
+            DeleteFile(tempPath);
+        }
+    }
+
+    return "";
+}
+#else
+std::string ShadowCopy(const std::string &file, const std::string &directory)
+{
+    std::string result;
+
+    auto pattern = (directory.empty() ? std::string("/tmp") : directory) + "/xU+XXXXXX";
+
+    int source = open(file.c_str(), O_RDONLY, 0);
+
+    if (source >= 0)
+    {
+        int dest = mkstemp(&pattern[0]);
+
+        if (dest >= 0)
+        {
+            bool copied = CopyContents(source, dest);
+
+            if (close(dest) == 0 && copied)
+            {
+                result = pattern;
+            }
+            else
+            {
+                std::remove(pattern.c_str());
+            }
+        }
+
+        close(source);
+    }
+
+    return result;
+}
+#endif
+
+ShadowCopyCache::ShadowCopyCache(const std::string &directory)
+    : directory(directory)
+{
+}
+
+std::string ShadowCopyCache::Copy(const std::string &library)
+{
+    if (!MakeDirectory(directory))
+    {
+        return "";
+    }
+
+    Fnv1a name;
+    name.AddBytes(library.data(), library.size());
+
+    auto stampFile = directory + "/" + Hex(name.Value()) + ".xushadow";
+
+    DiscoveryCache::Stamp stamp, saved;
+    if (!DiscoveryCache::StampFile(library, stamp, false))
+    {
+        return "";
+    }
+
+    bool hasSaved = ReadStamp(stampFile, saved);
+
+    // unchanged since the last run: the copy made then can be loaded without even reading the library
+    if (hasSaved && saved.size == stamp.size && saved.modified == stamp.modified)
+    {
+        auto cached = directory + "/" + Hex(saved.hash) + Extension(library);
+
+        if (Exists(cached))
+        {
+            return cached;
+        }
+    }
+
+    if (!DiscoveryCache::StampFile(library, stamp, true))
+    {
+        return "";
+    }
+
+    auto cached = directory + "/" + Hex(stamp.hash) + Extension(library);
+
+    if (!Exists(cached))
+    {
+        auto copy = ShadowCopy(library, directory);
+
+        if (copy.empty())
+        {
+            return "";
+        }
+
+        // another run may have got there first, with the same content
+        if (!RenameReplacing(copy, cached))
+        {
+            std::remove(copy.c_str());
+
+            if (!Exists(cached))
+            {
+                return "";
+            }
+        }
+    }
+
+    WriteStamp(stampFile, stamp);
+
+    // the copy of this library's previous content won't be wanted again
+    if (hasSaved && saved.hash != stamp.hash)
+    {
+        std::remove((directory + "/" + Hex(saved.hash) + Extension(library)).c_str());
+    }
+
+    return cached;
+}
+
+}}
@@ -0,0 +1,34 @@
+#ifndef SHADOWCOPY_H_
+#define SHADOWCOPY_H_
+
+#include <string>
+
+namespace xUnitpp { namespace Utilities
+{
+
+// Copies file to a new, uniquely named file in directory (the system's temporary directory when empty),
+// cloning it where the file system allows. Returns the name of the copy, or an empty string if it failed.
+std::string ShadowCopy(const std::string &file, const std::string &directory = std::string());
+
+//
+// Copies of test libraries kept between runs, named by the hash of their content,
+// so a library that hasn't changed since the last run is loaded from the copy already made.
+//
+// Next to the copies, a stamp for each library remembers its size, modification time and content hash:
+// as with the discovery cache, the library is only hashed again once its size or modification time change.
+// The copies are never changed once made, so they can be shared by runs going on at the same time.
+class ShadowCopyCache
+{
+public:
+    explicit ShadowCopyCache(const std::string &directory);
+
+    // the name of a copy of library, made if there isn't one with the same content already; an empty string if that failed
+    std::string Copy(const std::string &library);
+
+private:
+    std::string directory;
+};
+
+}}
+
+#endif
@@ -0,0 +1,73 @@
+#include "Sharding.h"
+#include <algorithm>
+#include <string>
+#include <utility>
+#include "Fnv1a.h"
+
+namespace xUnitpp { namespace Utilities
+{
+
+unsigned long long StableTestHash(const TestCatalog &catalog, const TestCatalogEntry &entry)
+{
+    Fnv1a hash;
+
+    hash.AddString(catalog.strings + entry.suite);
+    hash.AddByte('\0');
+    hash.AddString(catalog.strings + entry.fullName);
+
+    return hash.Value();
+}
+
+std::vector<size_t> HashShards(const TestCatalog &catalog, const std::vector<const TestCatalogEntry *> &tests, size_t shardCount)
+{
+    std::vector<size_t> shards;
+    shards.reserve(tests.size());
+
+    for (auto test : tests)
+    {
+        shards.push_back((size_t)(StableTestHash(catalog, *test) % std::max(shardCount, (size_t)1)));
+    }
+
+    return shards;
+}
+
+std::vector<size_t> DurationShards(const TestCatalog &catalog, const std::vector<const TestCatalogEntry *> &tests, size_t shardCount,
+    CatalogDurationCallback expectedDuration)
+{
+    shardCount = std::max(shardCount, (size_t)1);
+
+    auto shards = HashShards(catalog, tests, shardCount);
+
+    // (expected, hash, index): ties are broken by hash rather than by enumeration order
+    std::vector<std::pair<std::pair<long long, unsigned long long>, size_t>> timed;
+
+    for (size_t i = 0; i != tests.size(); ++i)
+    {
+        auto expected = expectedDuration(*tests[i]);
+
+        if (expected >= 0)
+        {
+            timed.push_back(std::make_pair(std::make_pair(expected, StableTestHash(catalog, *tests[i])), i));
+        }
+    }
+
+    std::sort(timed.begin(), timed.end(),
+        [](const std::pair<std::pair<long long, unsigned long long>, size_t> &a, const std::pair<std::pair<long long, unsigned long long>, size_t> &b)
+        {
+            return a.first > b.first;
+        });
+
+    std::vector<long long> load(shardCount, 0);
+
+    for (const auto &test : timed)
+    {
+        auto shard = (size_t)(std::min_element(load.begin(), load.end()) - load.begin());
+
+        shards[test.second] = shard;
+        load[shard] += test.first.first;
+    }
+
+    return shards;
+}
+
+}}
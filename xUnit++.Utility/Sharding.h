@@ -0,0 +1,31 @@
+#ifndef SHARDING_H_
+#define SHARDING_H_
+
+#include <functional>
+#include <vector>
+#include "xUnit++/ExportApi.h"
+
+namespace xUnitpp { namespace Utilities
+{
+
+//
+// Splits a library's tests between several runner processes, so that every process
+// given the same tests (and the same history) agrees on which shard each test belongs to.
+// Tests are entries of the library's TestCatalog.
+
+typedef std::function<long long(const TestCatalogEntry &)> CatalogDurationCallback;
+
+// FNV-1a of suite and full name: unlike std::hash, the same on every machine and in every build
+unsigned long long StableTestHash(const TestCatalog &catalog, const TestCatalogEntry &entry);
+
+// the shard of each test, in the same order as tests
+std::vector<size_t> HashShards(const TestCatalog &catalog, const std::vector<const TestCatalogEntry *> &tests, size_t shardCount);
+
+// longest expected duration first, each onto the shard with the least expected time so far
+// tests without an estimate (a negative expected duration) are spread by hash instead
+std::vector<size_t> DurationShards(const TestCatalog &catalog, const std::vector<const TestCatalogEntry *> &tests, size_t shardCount,
+    CatalogDurationCallback expectedDuration);
+
+}}
+
+#endif
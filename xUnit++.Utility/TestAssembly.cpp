@@ -1,75 +1,37 @@
 #include "TestAssembly.h"
+#include "ShadowCopy.h"
 
 #if !defined(WIN32)
 #include <cstdio>
 #include <dlfcn.h>
-#include <fcntl.h>
-#include <unistd.h>
 #endif
 
 namespace
 {
-#if defined(WIN32)
-    std::string CopyFile(const std::string &file)
+    std::string LoadedFile(const std::string &file, bool shadowCopy, const std::string &shadowCache)
     {
-        char tempPath[MAX_PATH] = {0};
-        if (GetTempPath(MAX_PATH, tempPath) > 0)
+        if (!shadowCopy)
         {
-            if (GetTempFileName(tempPath, "xU+", 0, tempPath) != 0)
-            {
-                if (::CopyFile(file.c_str(), tempPath, FALSE))
-                {
-                    return tempPath;
-                }
-            }
+            return file;
         }
 
-        return "";
+        return shadowCache.empty() ? xUnitpp::Utilities::ShadowCopy(file) : xUnitpp::Utilities::ShadowCopyCache(shadowCache).Copy(file);
     }
-#else
-    std::string CopyFile(const std::string &file)
-    {
-        std::string result;
-
-        char buf[BUFSIZ];
-        size_t size;
-
-        char tempFile[] = "/tmp/xU+XXXXXX";
-
-        int source = open(file.c_str(), O_RDONLY, 0);
-        int dest = mkstemp(tempFile);
-
-        if (source > 0)
-        {
-            if (dest > 0)
-            {
-                while ((size = read(source, buf, BUFSIZ)) > 0)
-                {
-                    write(dest, buf, size);
-                }
-
-                result = tempFile;
-
-                close(dest);
-            }
-
-            close(source);
-        }
-
-        return result;
-    }
-#endif
 }
 
 namespace xUnitpp { namespace Utilities
 {
 
-TestAssembly::TestAssembly(const std::string &file, bool shadowCopy)
+TestAssembly::TestAssembly(const std::string &file, bool shadowCopy, const std::string &shadowCache)
     : EnumerateTestDetails(nullptr)
     , FilteredTestsRunner(nullptr)
+    , OrderedTestsRunner(nullptr)
+    , SetAllocationCounter(nullptr)
+    , GetTestCatalog(nullptr)
+    , SetThreadBudget(nullptr)
     , module(nullptr)
-    , tempFile(shadowCopy ? CopyFile(file) : file)
-    , shadowCopied(shadowCopy)
+    , tempFile(LoadedFile(file, shadowCopy, shadowCache))
+    , shadowCopied(shadowCopy && shadowCache.empty())
 {
     if (!tempFile.empty())
     {
@@ -78,6 +40,10 @@ TestAssembly::TestAssembly(const std::string &file, bool shadowCopy)
         {
             EnumerateTestDetails = (xUnitpp::EnumerateTestDetails)GetProcAddress(module, "EnumerateTestDetails");
             FilteredTestsRunner = (xUnitpp::FilteredTestsRunner)GetProcAddress(module, "FilteredTestsRunner");
+            OrderedTestsRunner = (xUnitpp::OrderedTestsRunner)GetProcAddress(module, "OrderedTestsRunner");
+            SetAllocationCounter = (xUnitpp::SetAllocationCounter)GetProcAddress(module, "SetAllocationCounter");
+            GetTestCatalog = (xUnitpp::GetTestCatalog)GetProcAddress(module, "GetTestCatalog");
+            SetThreadBudget = (xUnitpp::SetThreadBudget)GetProcAddress(module, "SetThreadBudget");
         }
 #else
         if ((module = dlopen(tempFile.c_str(), RTLD_LAZY)) != nullptr)
@@ -87,6 +53,10 @@ TestAssembly::TestAssembly(const std::string &file, bool shadowCopy)
             // this weird syntax works around that
             *(void **)(&EnumerateTestDetails) = dlsym(module, "EnumerateTestDetails");
             *(void **)(&FilteredTestsRunner) = dlsym(module, "FilteredTestsRunner");
+            *(void **)(&OrderedTestsRunner) = dlsym(module, "OrderedTestsRunner");
+            *(void **)(&SetAllocationCounter) = dlsym(module, "SetAllocationCounter");
+            *(void **)(&GetTestCatalog) = dlsym(module, "GetTestCatalog");
+            *(void **)(&SetThreadBudget) = dlsym(module, "SetThreadBudget");
         }
 #endif
     }
@@ -26,7 +26,8 @@ private:
 #endif
 
 public:
-    TestAssembly(const std::string &file, bool shadowCopy);
+    // with a shadowCache directory, the shadow copy is kept there for the next run rather than deleted
+    TestAssembly(const std::string &file, bool shadowCopy, const std::string &shadowCache = std::string());
     ~TestAssembly();
 
     // !!!VS enable this when Visual Studio supports it
@@ -40,6 +41,12 @@ public:
     xUnitpp::EnumerateTestDetails EnumerateTestDetails;
     xUnitpp::FilteredTestsRunner FilteredTestsRunner;
 
+    // optional: older test libraries do not export these
+    xUnitpp::OrderedTestsRunner OrderedTestsRunner;
+    xUnitpp::SetAllocationCounter SetAllocationCounter;
+    xUnitpp::GetTestCatalog GetTestCatalog;
+    xUnitpp::SetThreadBudget SetThreadBudget;
+
 private:
     HMODULE module;
     std::string tempFile;
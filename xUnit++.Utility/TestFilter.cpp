@@ -0,0 +1,633 @@
+#include "TestFilter.h"
+#include <cctype>
+#include <cstring>
+#include <regex>
+#include <unordered_set>
+#include "CatalogTests.h"
+
+namespace xUnitpp { namespace Utilities
+{
+
+class TestFilter::Node
+{
+public:
+    virtual ~Node()
+    {
+    }
+
+    virtual bool Matches(const TestCatalog &catalog, const TestCatalogEntry &entry) const = 0;
+};
+
+}}
+
+namespace
+{
+    using xUnitpp::TestCatalog;
+    using xUnitpp::TestCatalogEntry;
+    using xUnitpp::Utilities::TestFilter;
+
+    typedef std::unique_ptr<TestFilter::Node> NodePtr;
+
+    enum class Field
+    {
+        Suite,
+        Name,
+        FullName
+    };
+
+    const char *GetField(const TestCatalog &catalog, const TestCatalogEntry &entry, Field field)
+    {
+        switch (field)
+        {
+        case Field::Suite:
+            return catalog.strings + entry.suite;
+        case Field::Name:
+            return catalog.strings + entry.name;
+        default:
+            return catalog.strings + entry.fullName;
+        }
+    }
+
+    class RegexNode : public TestFilter::Node
+    {
+    public:
+        RegexNode(Field field, const std::string &pattern)
+            : field(field)
+            , regex(pattern, std::regex_constants::icase | std::regex_constants::optimize)
+        {
+        }
+
+        virtual bool Matches(const TestCatalog &catalog, const TestCatalogEntry &entry) const override
+        {
+            return std::regex_search(GetField(catalog, entry, field), regex);
+        }
+
+    private:
+        Field field;
+        std::regex regex;
+    };
+
+    class ExactNode : public TestFilter::Node
+    {
+    public:
+        ExactNode(Field field, const std::string &value)
+            : field(field)
+            , value(value)
+        {
+        }
+
+        virtual bool Matches(const TestCatalog &catalog, const TestCatalogEntry &entry) const override
+        {
+            return value == GetField(catalog, entry, field);
+        }
+
+    private:
+        Field field;
+        std::string value;
+    };
+
+    class NameSetNode : public TestFilter::Node
+    {
+    public:
+        virtual bool Matches(const TestCatalog &catalog, const TestCatalogEntry &entry) const override
+        {
+            std::string fullName = catalog.strings + entry.fullName;
+
+            return fullNames.find(fullName) != fullNames.end() ||
+                (!qualifiedNames.empty() && qualifiedNames.find(catalog.strings + entry.suite + std::string(" :: ") + fullName) != qualifiedNames.end());
+        }
+
+        std::unordered_set<std::string> fullNames;
+        std::unordered_set<std::string> qualifiedNames;
+    };
+
+    class AttributeNode : public TestFilter::Node
+    {
+    public:
+        AttributeNode(const std::string &key, const std::string &value)
+            : key(key)
+            , value(value)
+        {
+        }
+
+        virtual bool Matches(const TestCatalog &catalog, const TestCatalogEntry &entry) const override
+        {
+            // most tests have no attributes at all
+            if (entry.attributeCount == 0)
+            {
+                return false;
+            }
+
+            auto range = xUnitpp::Utilities::FindAttributes(catalog, entry, key.c_str());
+
+            if (range.first == range.second || value.empty())
+            {
+                return range.first != range.second;
+            }
+
+            for (auto it = range.first; it != range.second; ++it)
+            {
+                if (value == catalog.strings + it->value)
+                {
+                    return true;
+                }
+            }
+
+            return false;
+        }
+
+    private:
+        std::string key;
+        std::string value;
+    };
+
+    class NotNode : public TestFilter::Node
+    {
+    public:
+        NotNode(NodePtr &&operand)
+            : operand(std::move(operand))
+        {
+        }
+
+        virtual bool Matches(const TestCatalog &catalog, const TestCatalogEntry &entry) const override
+        {
+            return !operand->Matches(catalog, entry);
+        }
+
+    private:
+        NodePtr operand;
+    };
+
+    class AllNode : public TestFilter::Node
+    {
+    public:
+        virtual bool Matches(const TestCatalog &catalog, const TestCatalogEntry &entry) const override
+        {
+            for (const auto &operand : operands)
+            {
+                if (!operand->Matches(catalog, entry))
+                {
+                    return false;
+                }
+            }
+
+            return true;
+        }
+
+        std::vector<NodePtr> operands;
+    };
+
+    class AnyNode : public TestFilter::Node
+    {
+    public:
+        virtual bool Matches(const TestCatalog &catalog, const TestCatalogEntry &entry) const override
+        {
+            for (const auto &operand : operands)
+            {
+                if (operand->Matches(catalog, entry))
+                {
+                    return true;
+                }
+            }
+
+            return false;
+        }
+
+        std::vector<NodePtr> operands;
+    };
+
+    // every pattern is checked on its own, so a bad one can be named, and then they are searched for all at once
+    NodePtr AnyPattern(Field field, const std::vector<std::string> &patterns, std::string &error)
+    {
+        std::string combined;
+        bool combinable = true;
+
+        for (const auto &pattern : patterns)
+        {
+            try
+            {
+                std::regex regex(pattern, std::regex_constants::icase);
+            }
+            catch (const std::regex_error &)
+            {
+                error = pattern + " is not a valid regular expression.";
+                return nullptr;
+            }
+
+            // backreferences would be renumbered by the combined pattern
+            for (size_t i = 0; i + 1 < pattern.size(); ++i)
+            {
+                if (pattern[i] == '\\' && std::isdigit((unsigned char)pattern[i + 1]))
+                {
+                    combinable = false;
+                }
+            }
+
+            if (!combined.empty())
+            {
+                combined += '|';
+            }
+
+            combined += "(?:" + pattern + ")";
+        }
+
+        if (combinable)
+        {
+            return NodePtr(new RegexNode(field, combined));
+        }
+
+        std::unique_ptr<AnyNode> any(new AnyNode());
+        for (const auto &pattern : patterns)
+        {
+            any->operands.push_back(NodePtr(new RegexNode(field, pattern)));
+        }
+
+        return NodePtr(std::move(any));
+    }
+
+    //
+    // Recursive descent over the Where() grammar. Errors stop the parse and are reported with the offset they were found at.
+    class ExpressionParser
+    {
+    public:
+        ExpressionParser(const std::string &expression)
+            : text(expression)
+            , pos(0)
+        {
+        }
+
+        NodePtr Parse(std::string &error)
+        {
+            auto node = Or();
+
+            SkipSpace();
+            if (this->error.empty() && pos != text.size())
+            {
+                Fail("unexpected \"" + text.substr(pos) + "\"");
+            }
+
+            error = this->error;
+            return error.empty() ? std::move(node) : nullptr;
+        }
+
+    private:
+        NodePtr Or()
+        {
+            auto left = And();
+
+            while (error.empty() && (Take("||") || TakeWord("or")))
+            {
+                std::unique_ptr<AnyNode> any(new AnyNode());
+                any->operands.push_back(std::move(left));
+                any->operands.push_back(And());
+                left = std::move(any);
+            }
+
+            return left;
+        }
+
+        NodePtr And()
+        {
+            auto left = Not();
+
+            while (error.empty() && (Take("&&") || TakeWord("and")))
+            {
+                std::unique_ptr<AllNode> all(new AllNode());
+                all->operands.push_back(std::move(left));
+                all->operands.push_back(Not());
+                left = std::move(all);
+            }
+
+            return left;
+        }
+
+        NodePtr Not()
+        {
+            if (Take("!") || TakeWord("not"))
+            {
+                return NodePtr(new NotNode(Not()));
+            }
+
+            return Primary();
+        }
+
+        NodePtr Primary()
+        {
+            if (!error.empty())
+            {
+                return nullptr;
+            }
+
+            if (Take("("))
+            {
+                auto node = Or();
+
+                if (error.empty() && !Take(")"))
+                {
+                    Fail("expected \")\"");
+                }
+
+                return node;
+            }
+
+            if (Take("["))
+            {
+                auto key = Value();
+                std::string value;
+
+                if (error.empty() && Take("="))
+                {
+                    value = Value();
+                }
+
+                if (error.empty() && !Take("]"))
+                {
+                    Fail("expected \"]\"");
+                }
+
+                return NodePtr(new AttributeNode(key, value));
+            }
+
+            Field field;
+            if (TakeWord("suite"))
+            {
+                field = Field::Suite;
+            }
+            else if (TakeWord("name"))
+            {
+                field = Field::Name;
+            }
+            else if (TakeWord("fullname"))
+            {
+                field = Field::FullName;
+            }
+            else
+            {
+                Fail("expected suite, name, fullname, [attribute] or \"(\"");
+                return nullptr;
+            }
+
+            if (Take("~"))
+            {
+                auto start = pos;
+                auto pattern = Value();
+
+                if (error.empty())
+                {
+                    try
+                    {
+                        return NodePtr(new RegexNode(field, pattern));
+                    }
+                    catch (const std::regex_error &)
+                    {
+                        pos = start;
+                        Fail(pattern + " is not a valid regular expression");
+                    }
+                }
+
+                return nullptr;
+            }
+
+            if (Take("==") || Take("="))
+            {
+                return NodePtr(new ExactNode(field, Value()));
+            }
+
+            Fail("expected \"~\" or \"=\"");
+            return nullptr;
+        }
+
+        std::string Value()
+        {
+            SkipSpace();
+
+            std::string value;
+
+            if (pos != text.size() && text[pos] == '\"')
+            {
+                for (++pos; pos != text.size() && text[pos] != '\"'; ++pos)
+                {
+                    if (text[pos] == '\\' && pos + 1 != text.size() && (text[pos + 1] == '\"' || text[pos + 1] == '\\'))
+                    {
+                        ++pos;
+                    }
+
+                    value += text[pos];
+                }
+
+                if (pos == text.size())
+                {
+                    Fail("unterminated string");
+                }
+                else
+                {
+                    ++pos;
+                }
+
+                return value;
+            }
+
+            while (pos != text.size() && !std::isspace((unsigned char)text[pos]) && std::strchr("()[]!~=&|\"", text[pos]) == nullptr)
+            {
+                value += text[pos++];
+            }
+
+            if (value.empty())
+            {
+                Fail("expected a value");
+            }
+
+            return value;
+        }
+
+        void SkipSpace()
+        {
+            while (pos != text.size() && std::isspace((unsigned char)text[pos]))
+            {
+                ++pos;
+            }
+        }
+
+        bool Take(const char *token)
+        {
+            SkipSpace();
+
+            auto length = std::strlen(token);
+            if (text.compare(pos, length, token) == 0)
+            {
+                pos += length;
+                return true;
+            }
+
+            return false;
+        }
+
+        // keywords only count as whole words, so that "suite = notes" is not read as "suite = not es"
+        bool TakeWord(const char *word)
+        {
+            SkipSpace();
+
+            auto length = std::strlen(word);
+            if (text.compare(pos, length, word) == 0 &&
+                (pos + length == text.size() || !(std::isalnum((unsigned char)text[pos + length]) || text[pos + length] == '_')))
+            {
+                pos += length;
+                return true;
+            }
+
+            return false;
+        }
+
+        void Fail(const std::string &message)
+        {
+            if (error.empty())
+            {
+                error = message + " at offset " + std::to_string(pos) + " of \"" + text + "\".";
+            }
+        }
+
+    private:
+        ExpressionParser &operator =(ExpressionParser) /* = delete */;
+
+    private:
+        const std::string &text;
+        size_t pos;
+        std::string error;
+    };
+}
+
+namespace xUnitpp { namespace Utilities
+{
+
+TestFilter::TestFilter()
+{
+}
+
+TestFilter::~TestFilter()
+{
+}
+
+std::string TestFilter::IncludeSuites(const std::vector<std::string> &patterns)
+{
+    std::string error;
+
+    if (!patterns.empty())
+    {
+        auto node = AnyPattern(Field::Suite, patterns, error);
+
+        if (node != nullptr)
+        {
+            criteria.push_back(std::move(node));
+        }
+    }
+
+    return error;
+}
+
+std::string TestFilter::IncludeNames(const std::vector<std::string> &patterns)
+{
+    std::string error;
+
+    if (!patterns.empty())
+    {
+        auto node = AnyPattern(Field::Name, patterns, error);
+
+        if (node != nullptr)
+        {
+            criteria.push_back(std::move(node));
+        }
+    }
+
+    return error;
+}
+
+std::string TestFilter::IncludeNamesFrom(std::istream &names)
+{
+    if (!names)
+    {
+        return "Unable to read test names.";
+    }
+
+    std::unique_ptr<NameSetNode> node(new NameSetNode());
+
+    for (std::string line; std::getline(names, line); )
+    {
+        while (!line.empty() && std::isspace((unsigned char)line.back()))
+        {
+            line.pop_back();
+        }
+
+        if (line.empty() || line[0] == '#')
+        {
+            continue;
+        }
+
+        if (line.find(" :: ") != std::string::npos)
+        {
+            node->qualifiedNames.insert(line);
+        }
+        else
+        {
+            node->fullNames.insert(line);
+        }
+    }
+
+    criteria.push_back(std::move(node));
+    return "";
+}
+
+std::string TestFilter::Where(const std::string &expression)
+{
+    std::string error;
+    auto node = ExpressionParser(expression).Parse(error);
+
+    if (error.empty())
+    {
+        criteria.push_back(std::move(node));
+    }
+
+    return error;
+}
+
+void TestFilter::IncludeAttributes(const std::multimap<std::string, std::string> &attributes)
+{
+    if (!attributes.empty())
+    {
+        std::unique_ptr<AnyNode> any(new AnyNode());
+        for (const auto &attribute : attributes)
+        {
+            any->operands.push_back(NodePtr(new AttributeNode(attribute.first, attribute.second)));
+        }
+
+        criteria.push_back(std::move(any));
+    }
+}
+
+void TestFilter::ExcludeAttributes(const std::multimap<std::string, std::string> &attributes)
+{
+    if (!attributes.empty())
+    {
+        std::unique_ptr<AllNode> all(new AllNode());
+        for (const auto &attribute : attributes)
+        {
+            all->operands.push_back(NodePtr(new AttributeNode(attribute.first, attribute.second)));
+        }
+
+        criteria.push_back(NodePtr(new NotNode(std::move(all))));
+    }
+}
+
+bool TestFilter::Matches(const TestCatalog &catalog, const TestCatalogEntry &entry) const
+{
+    for (const auto &criterion : criteria)
+    {
+        if (!criterion->Matches(catalog, entry))
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+}}
@@ -0,0 +1,61 @@
+#ifndef TESTFILTER_H_
+#define TESTFILTER_H_
+
+#include <istream>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+#include "xUnit++/ExportApi.h"
+
+namespace xUnitpp { namespace Utilities
+{
+
+//
+// Everything the console selects tests by, compiled once up front so that checking a test is cheap.
+// A test has to pass every criterion that has been added; a filter with no criteria matches every test.
+//
+// Where() takes a boolean expression over a test's suite, name and attributes:
+//     suite ~ "regex"    name ~ "regex"    fullname ~ "regex"    (case insensitive search, like --suite and --name)
+//     suite = "text"     name = "text"     fullname = "text"     (exact match)
+//     [Key]              [Key = Value]                           (has the attribute, with that value)
+// combined with not (!), and (&&), or (||) and parentheses. Values without spaces or punctuation need no quotes.
+//
+// Tests are matched as entries of a TestCatalog, reading its tables rather than calling through ITestDetails.
+class TestFilter
+{
+public:
+    class Node;
+
+    TestFilter();
+    ~TestFilter();
+
+    // these return an empty string, or what was wrong with their argument
+
+    // regex searches: a test is selected if any pattern matches
+    std::string IncludeSuites(const std::vector<std::string> &patterns);
+    std::string IncludeNames(const std::vector<std::string> &patterns);
+
+    // exact names, one per line: either a test's full name or "suite :: full name", as --list prints it
+    std::string IncludeNamesFrom(std::istream &names);
+
+    std::string Where(const std::string &expression);
+
+    // a test is selected if it has any of the inclusive attributes, and excluded if it has all of the exclusive ones
+    // an empty value matches any value
+    void IncludeAttributes(const std::multimap<std::string, std::string> &attributes);
+    void ExcludeAttributes(const std::multimap<std::string, std::string> &attributes);
+
+    bool Matches(const TestCatalog &catalog, const TestCatalogEntry &entry) const;
+
+private:
+    TestFilter(const TestFilter &) /* = delete */;
+    TestFilter &operator =(TestFilter) /* = delete */;
+
+private:
+    std::vector<std::unique_ptr<Node>> criteria;
+};
+
+}}
+
+#endif
@@ -0,0 +1,290 @@
+#include "TestHistory.h"
+#include <algorithm>
+#include <cstdint>
+#include <fstream>
+#include <vector>
+#include "xUnit++/ITestDetails.h"
+#include "xUnit++/ITestEvent.h"
+#include "AtomicFile.h"
+
+namespace
+{
+    const char Magic[4] = { 'x', 'U', 'H', '1' };
+
+    template<typename T>
+    void WriteValue(std::ostream &output, T value)
+    {
+        output.write(reinterpret_cast<const char *>(&value), sizeof(value));
+    }
+
+    template<typename T>
+    bool ReadValue(std::istream &input, T &value)
+    {
+        return (bool)input.read(reinterpret_cast<char *>(&value), sizeof(value));
+    }
+
+    void WriteString(std::ostream &output, const std::string &value)
+    {
+        WriteValue(output, (uint32_t)value.size());
+        output.write(value.data(), value.size());
+    }
+
+    bool ReadString(std::istream &input, std::string &value)
+    {
+        uint32_t size;
+        if (!ReadValue(input, size))
+        {
+            return false;
+        }
+
+        // the size comes from the file, so a damaged one only gets as much memory as it actually holds
+        value.clear();
+
+        char buffer[4096];
+        while (size != 0)
+        {
+            auto chunk = std::min(size, (uint32_t)sizeof(buffer));
+            if (!input.read(buffer, chunk))
+            {
+                return false;
+            }
+
+            value.append(buffer, chunk);
+            size -= chunk;
+        }
+
+        return true;
+    }
+
+    std::string safestr(const char *s)
+    {
+        return s == nullptr ? "" : s;
+    }
+
+    xUnitpp::Time::Duration Percentile(const std::vector<long long> &sorted, size_t percent)
+    {
+        // nearest-rank percentile
+        auto rank = (sorted.size() * percent + 99) / 100;
+        return xUnitpp::Time::Duration(sorted[rank == 0 ? 0 : rank - 1]);
+    }
+}
+
+namespace xUnitpp { namespace Utilities
+{
+
+TestHistory::TestHistory(size_t window)
+    : window(std::max(window, (size_t)1))
+{
+}
+
+std::string TestHistory::Key(const std::string &suite, const std::string &fullName, const std::string &file, int line)
+{
+    return suite + '\0' + fullName + '\0' + file + '\0' + std::to_string(line);
+}
+
+bool TestHistory::Load(std::istream &input)
+{
+    entries.clear();
+
+    char magic[sizeof(Magic)];
+    uint32_t count;
+
+    if (!input.read(magic, sizeof(magic)) || !std::equal(magic, magic + sizeof(magic), Magic) || !ReadValue(input, count))
+    {
+        return false;
+    }
+
+    for (uint32_t i = 0; i != count; ++i)
+    {
+        Entry entry;
+        int32_t line;
+        uint32_t sampleCount;
+
+        if (!ReadString(input, entry.suite) || !ReadString(input, entry.fullName) || !ReadString(input, entry.file) ||
+            !ReadValue(input, line) || !ReadValue(input, sampleCount))
+        {
+            entries.clear();
+            return false;
+        }
+
+        entry.line = line;
+
+        for (uint32_t s = 0; s != sampleCount; ++s)
+        {
+            int64_t ns;
+            uint8_t failed;
+
+            if (!ReadValue(input, ns) || !ReadValue(input, failed))
+            {
+                entries.clear();
+                return false;
+            }
+
+            Sample sample = { ns, failed != 0 };
+            entry.samples.push_back(sample);
+        }
+
+        while (entry.samples.size() > window)
+        {
+            entry.samples.pop_front();
+        }
+
+        auto key = Key(entry.suite, entry.fullName, entry.file, entry.line);
+        entries[key] = std::move(entry);
+    }
+
+    return true;
+}
+
+bool TestHistory::Save(std::ostream &output) const
+{
+    output.write(Magic, sizeof(Magic));
+    WriteValue(output, (uint32_t)entries.size());
+
+    for (const auto &it : entries)
+    {
+        const auto &entry = it.second;
+
+        WriteString(output, entry.suite);
+        WriteString(output, entry.fullName);
+        WriteString(output, entry.file);
+        WriteValue(output, (int32_t)entry.line);
+        WriteValue(output, (uint32_t)entry.samples.size());
+
+        for (const auto &sample : entry.samples)
+        {
+            WriteValue(output, (int64_t)sample.ns);
+            WriteValue(output, (uint8_t)(sample.failed ? 1 : 0));
+        }
+    }
+
+    return (bool)output;
+}
+
+bool TestHistory::Load(const std::string &file)
+{
+    std::ifstream input(file, std::ios::binary);
+    return input && Load(input);
+}
+
+bool TestHistory::Save(const std::string &file) const
+{
+    return SaveAtomically(file, [&](std::ostream &output) { return Save(output); });
+}
+
+void TestHistory::Record(const ITestDetails &testDetails, Time::Duration duration, bool failed)
+{
+    auto suite = safestr(testDetails.GetSuite());
+    auto fullName = safestr(testDetails.GetFullName());
+    auto file = safestr(testDetails.GetFile());
+
+    auto &entry = entries[Key(suite, fullName, file, testDetails.GetLine())];
+
+    if (entry.samples.empty())
+    {
+        entry.suite = std::move(suite);
+        entry.fullName = std::move(fullName);
+        entry.file = std::move(file);
+        entry.line = testDetails.GetLine();
+    }
+
+    Sample sample = { duration.count(), failed };
+    entry.samples.push_back(sample);
+
+    while (entry.samples.size() > window)
+    {
+        entry.samples.pop_front();
+    }
+}
+
+bool TestHistory::Find(const ITestDetails &testDetails, Statistics &statistics) const
+{
+    return Find(safestr(testDetails.GetSuite()), safestr(testDetails.GetFullName()), safestr(testDetails.GetFile()), testDetails.GetLine(), statistics);
+}
+
+bool TestHistory::Find(const std::string &suite, const std::string &fullName, const std::string &file, int line, Statistics &statistics) const
+{
+    auto it = entries.find(Key(suite, fullName, file, line));
+    if (it == entries.end() || it->second.samples.empty())
+    {
+        return false;
+    }
+
+    const auto &samples = it->second.samples;
+
+    std::vector<long long> sorted;
+    sorted.reserve(samples.size());
+
+    long long total = 0;
+    statistics.failures = 0;
+
+    for (const auto &sample : samples)
+    {
+        sorted.push_back(sample.ns);
+        total += sample.ns;
+
+        if (sample.failed)
+        {
+            ++statistics.failures;
+        }
+    }
+
+    std::sort(sorted.begin(), sorted.end());
+
+    statistics.samples = samples.size();
+    statistics.mean = Time::Duration(total / (long long)samples.size());
+    statistics.median = Percentile(sorted, 50);
+    statistics.p95 = Percentile(sorted, 95);
+    statistics.max = Time::Duration(sorted.back());
+
+    return true;
+}
+
+size_t TestHistory::size() const
+{
+    return entries.size();
+}
+
+HistoryReporter::HistoryReporter(TestHistory &history)
+    : history(history)
+{
+}
+
+HistoryReporter::~HistoryReporter() noexcept(true)
+{
+}
+
+void HistoryReporter::ReportStart(const ITestDetails &)
+{
+}
+
+void HistoryReporter::ReportEvent(const ITestDetails &testDetails, const ITestEvent &evt)
+{
+    if (evt.GetIsFailure())
+    {
+        failed[testDetails.GetId()] = true;
+    }
+}
+
+void HistoryReporter::ReportSkip(const ITestDetails &, const char *)
+{
+}
+
+void HistoryReporter::ReportFinish(const ITestDetails &testDetails, long long nsTaken)
+{
+    auto it = failed.find(testDetails.GetId());
+    bool testFailed = it != failed.end();
+
+    if (testFailed)
+    {
+        failed.erase(it);
+    }
+
+    history.Record(testDetails, Time::Duration(nsTaken), testFailed);
+}
+
+void HistoryReporter::ReportAllTestsComplete(size_t, size_t, size_t, long long)
+{
+}
+
+}}
@@ -0,0 +1,107 @@
+#ifndef TESTHISTORY_H_
+#define TESTHISTORY_H_
+
+#if defined(_MSC_VER)
+# if !defined(_ALLOW_KEYWORD_MACROS)
+#  define _ALLOW_KEYWORD_MACROS
+# endif
+#define noexcept(x)
+#endif
+
+#include <deque>
+#include <istream>
+#include <ostream>
+#include <string>
+#include <unordered_map>
+#include "xUnit++/IOutput.h"
+#include "xUnit++/xUnitTime.h"
+
+namespace xUnitpp
+{
+    struct ITestDetails;
+}
+
+namespace xUnitpp { namespace Utilities
+{
+
+//
+// Per-test timing samples that survive between runs.
+// Each test keeps a rolling window of its most recent durations and outcomes,
+// keyed by suite, full name, file and line.
+class TestHistory
+{
+public:
+    static const size_t DefaultWindow = 20;
+
+    struct Sample
+    {
+        long long ns;
+        bool failed;
+    };
+
+    struct Statistics
+    {
+        size_t samples;
+        size_t failures;
+        Time::Duration mean;
+        Time::Duration median;
+        Time::Duration p95;
+        Time::Duration max;
+    };
+
+    TestHistory(size_t window = DefaultWindow);
+
+    bool Load(std::istream &input);
+    bool Save(std::ostream &output) const;
+
+    bool Load(const std::string &file);
+    bool Save(const std::string &file) const;
+
+    void Record(const ITestDetails &testDetails, Time::Duration duration, bool failed);
+    bool Find(const ITestDetails &testDetails, Statistics &statistics) const;
+    bool Find(const std::string &suite, const std::string &fullName, const std::string &file, int line, Statistics &statistics) const;
+
+    size_t size() const;
+
+private:
+    struct Entry
+    {
+        std::string suite;
+        std::string fullName;
+        std::string file;
+        int line;
+        std::deque<Sample> samples;
+    };
+
+    static std::string Key(const std::string &suite, const std::string &fullName, const std::string &file, int line);
+
+    size_t window;
+    std::unordered_map<std::string, Entry> entries;
+};
+
+//
+// Records every finished test into a TestHistory.
+// Pair it with a real reporter through a MultiReporter.
+class HistoryReporter : public IOutput
+{
+public:
+    HistoryReporter(TestHistory &history);
+    virtual ~HistoryReporter() noexcept(true);
+
+    virtual void __stdcall ReportStart(const ITestDetails &testDetails) override;
+    virtual void __stdcall ReportEvent(const ITestDetails &testDetails, const ITestEvent &evt) override;
+    virtual void __stdcall ReportSkip(const ITestDetails &testDetails, const char *reason) override;
+    virtual void __stdcall ReportFinish(const ITestDetails &testDetails, long long nsTaken) override;
+    virtual void __stdcall ReportAllTestsComplete(size_t testCount, size_t skipped, size_t failureCount, long long nsTotal) override;
+
+private:
+    HistoryReporter &operator =(HistoryReporter) /* = delete; */;
+
+private:
+    TestHistory &history;
+    std::unordered_map<int, bool> failed;
+};
+
+}}
+
+#endif
@@ -0,0 +1,37 @@
+#include "ThreadBudget.h"
+#include <algorithm>
+#include <thread>
+
+namespace xUnitpp { namespace Utilities
+{
+
+ThreadBudget::ThreadBudget(size_t size)
+    : available(size != 0 ? size : std::max(std::thread::hardware_concurrency(), 1U))
+{
+}
+
+void __stdcall ThreadBudget::Acquire()
+{
+    std::unique_lock<std::mutex> guard(lock);
+    released.wait(guard, [&]() { return available != 0; });
+
+    --available;
+}
+
+void __stdcall ThreadBudget::Release()
+{
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        ++available;
+    }
+
+    released.notify_one();
+}
+
+size_t ThreadBudget::Available()
+{
+    std::lock_guard<std::mutex> guard(lock);
+    return available;
+}
+
+}}
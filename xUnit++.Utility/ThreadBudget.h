@@ -0,0 +1,37 @@
+#ifndef THREADBUDGET_H_
+#define THREADBUDGET_H_
+
+#include <condition_variable>
+#include <mutex>
+#include "xUnit++/IThreadBudget.h"
+
+namespace xUnitpp { namespace Utilities
+{
+
+//
+// A fixed number of slots, handed to every test library running at the same time,
+// so that together they run no more than that many tests at once.
+class ThreadBudget : public IThreadBudget
+{
+public:
+    // a size of 0 means as many tests as the machine can actually run at once
+    explicit ThreadBudget(size_t size);
+
+    virtual void __stdcall Acquire() override;
+    virtual void __stdcall Release() override;
+
+    size_t Available();
+
+private:
+    ThreadBudget(const ThreadBudget &) /* = delete */;
+    ThreadBudget &operator =(ThreadBudget) /* = delete */;
+
+private:
+    std::mutex lock;
+    std::condition_variable released;
+    size_t available;
+};
+
+}}
+
+#endif
@@ -1,11 +1,14 @@
 #include "XmlReporter.h"
 #include <algorithm>
-#include <chrono>
-#include <fstream>
-#include <iostream>
+#include <cstdio>
+#include <string>
+#include <unordered_map>
+#include <utility>
 #include <vector>
+#include "xUnit++/IBenchmarkResult.h"
 #include "xUnit++/ITestDetails.h"
 #include "xUnit++/ITestEvent.h"
+#include "xUnit++/ITestMetrics.h"
 #include "xUnit++/LineInfo.h"
 #include "xUnit++/xUnitTime.h"
 
@@ -14,12 +17,13 @@ namespace
     struct TestResult
     {
         TestResult(const xUnitpp::ITestDetails &testDetails)
-            : testDetails(testDetails)
+            : testDetails(&testDetails)
             , status(Success)
+            , time(xUnitpp::Time::Duration::zero())
         {
         }
 
-        const xUnitpp::ITestDetails &testDetails;
+        const xUnitpp::ITestDetails *testDetails;
 
         enum
         {
@@ -30,113 +34,174 @@ namespace
 
         xUnitpp::Time::Duration time;
         std::vector<std::string> messages;
-
-    private:
-        TestResult &operator =(TestResult other) /* = delete */;
+        std::vector<std::pair<std::string, std::string>> properties;
     };
-}
 
-struct xUnitpp::Utilities::XmlReporter::SuiteResult
-{
-    SuiteResult()
+    struct SuiteResult
     {
-    }
+        SuiteResult(const std::string &name)
+            : name(name)
+            , tests(0)
+            , failures(0)
+            , skipped(0)
+            , time(xUnitpp::Time::Duration::zero())
+        {
+        }
 
-    SuiteResult(const std::string &name)
-        : name(name)
-        , tests(0)
-        , failures(0)
-        , skipped(0)
+        std::string name;
+        int tests;
+        int failures;
+        int skipped;
+        xUnitpp::Time::Duration time;
+
+        // where this suite's test cases are in the spill file
+        std::vector<std::pair<long, size_t>> testCases;
+    };
+
+    //
+    // Finished test cases are appended here until ReportAllTestsComplete.
+    // If no temporary file can be created they are kept in memory instead.
+    class SpillFile
     {
-    }
+    public:
+        SpillFile()
+            : file(std::tmpfile())
+            , size(0)
+            , reading(false)
+        {
+        }
 
-    std::string name;
-    int tests;
-    int failures;
-    int skipped;
+        ~SpillFile()
+        {
+            if (file != nullptr)
+            {
+                std::fclose(file);
+            }
+        }
 
-    std::vector<TestResult> testResults;
-};
+        long Append(const std::string &text)
+        {
+            long offset = size;
 
-namespace
-{
-    TestResult &GetTestResult(std::vector<TestResult> &testResults, const std::string &fullName)
-    {
-        // if fullName isn't found it's a bug: go ahead and crash :P
-        return *std::find_if(testResults.begin(), testResults.end(),
-            [&](const TestResult &test)
+            if (file != nullptr)
             {
-                return test.testDetails.GetFullName() == fullName;
-            });
-    }
+                if (reading)
+                {
+                    std::fseek(file, 0, SEEK_END);
+                    reading = false;
+                }
 
-    float SuiteTime(const xUnitpp::Utilities::XmlReporter::SuiteResult &suiteResult)
-    {
-        xUnitpp::Time::Duration timeTaken = xUnitpp::Time::Duration::zero();
+                std::fwrite(text.data(), 1, text.size(), file);
+            }
+            else
+            {
+                memory += text;
+            }
 
-        for (const auto &test : suiteResult.testResults)
-        {
-            timeTaken += test.time;
+            size += (long)text.size();
+            return offset;
         }
 
-        return xUnitpp::Time::ToSeconds(timeTaken).count();
-    }
-
-    void ReplaceChar(std::string &str, char c, const std::string &replacement)
-    {
-        for (size_t pos = str.find(c); pos != std::string::npos; pos = str.find(c, pos + 1))
+        void CopyTo(std::ostream &output, long offset, size_t length)
         {
-            str.replace(pos, 1, replacement);
+            if (file == nullptr)
+            {
+                output.write(memory.data() + offset, length);
+                return;
+            }
+
+            reading = true;
+            std::fseek(file, offset, SEEK_SET);
+
+            char buffer[4096];
+            while (length != 0)
+            {
+                auto read = std::fread(buffer, 1, std::min(length, sizeof(buffer)), file);
+                if (read == 0)
+                {
+                    break;
+                }
+
+                output.write(buffer, read);
+                length -= read;
+            }
         }
-    }
 
-    std::string XmlEscape(const std::string &value)
-    {
-        std::string escaped = value;
+    private:
+        SpillFile(const SpillFile &) /* = delete */;
+        SpillFile &operator =(SpillFile) /* = delete */;
 
-        ReplaceChar(escaped, '&', "&amp;");
-        ReplaceChar(escaped, '<', "&lt;");
-        ReplaceChar(escaped, '>', "&gt;");
-        ReplaceChar(escaped, '\'', "&apos;");
-        ReplaceChar(escaped, '\"', "&quot;");
+    private:
+        std::FILE *file;
+        std::string memory;
+        long size;
+        bool reading;
+    };
 
-        return escaped;
+    void XmlEscape(std::string &xml, const std::string &value)
+    {
+        xml.reserve(xml.size() + value.size());
+
+        for (auto c : value)
+        {
+            switch (c)
+            {
+            case '&':
+                xml += "&amp;";
+                break;
+            case '<':
+                xml += "&lt;";
+                break;
+            case '>':
+                xml += "&gt;";
+                break;
+            case '\'':
+                xml += "&apos;";
+                break;
+            case '\"':
+                xml += "&quot;";
+                break;
+            default:
+                xml += c;
+                break;
+            }
+        }
     }
 
-    std::string XmlAttribute(const std::string &name, const std::string &value)
+    void XmlAttribute(std::string &xml, const char *name, const std::string &value)
     {
-        return " " + name + "=\"" + value + "\"";
+        xml += ' ';
+        xml += name;
+        xml += "=\"";
+        XmlEscape(xml, value);
+        xml += '\"';
     }
 
-    std::string XmlAttribute(const std::string &name, const char *value)
+    void XmlAttribute(std::string &xml, const char *name, const char *value)
     {
-        return XmlAttribute(name, std::string(value));
+        XmlAttribute(xml, name, std::string(value));
     }
 
     template<typename T>
-    std::string XmlAttribute(const std::string &name, T value)
+    void XmlAttribute(std::string &xml, const char *name, T value)
     {
-        return XmlAttribute(name, std::to_string(value));
+        XmlAttribute(xml, name, std::to_string(value));
     }
 
     std::string XmlBeginDoc()
     {
-        return
-            "<?xml" +
-                XmlAttribute("version", "1.0") +
-                XmlAttribute("encoding", "utf-8") +
-            " ?>\n";
+        return "<?xml version=\"1.0\" encoding=\"utf-8\" ?>\n";
     }
 
     std::string XmlBeginResults(size_t tests, size_t failures, long long nsTotal)
     {
-        xUnitpp::Time::Duration totalTime(nsTotal);
-        return
-            "<testsuites" +
-                XmlAttribute("tests", tests) +
-                XmlAttribute("failures", failures) +
-                XmlAttribute("time", xUnitpp::Time::ToSeconds(totalTime).count()) +
-            ">\n";
+        std::string xml = "<testsuites";
+        XmlAttribute(xml, "tests", tests);
+        XmlAttribute(xml, "failures", failures);
+        XmlAttribute(xml, "time", xUnitpp::Time::ToSeconds(xUnitpp::Time::Duration(nsTotal)).count());
+        xml += ">\n";
+
+        return xml;
     }
 
     std::string XmlEndResults()
@@ -144,180 +209,263 @@ namespace
         return "</testsuites>\n";
     }
 
-    std::string XmlBeginSuite(const xUnitpp::Utilities::XmlReporter::SuiteResult &suite)
+    std::string XmlBeginSuite(const SuiteResult &suite)
     {
-        return std::string("   ") +
-            "<testsuite" +
-                XmlAttribute("name", suite.name) +
-                XmlAttribute("tests", suite.tests) +
-                XmlAttribute("failures", suite.failures) +
-                XmlAttribute("skipped", suite.skipped) +
-                XmlAttribute("time", SuiteTime(suite)) +
-            ">\n";
+        std::string xml = "   <testsuite";
+        XmlAttribute(xml, "name", suite.name);
+        XmlAttribute(xml, "tests", suite.tests);
+        XmlAttribute(xml, "failures", suite.failures);
+        XmlAttribute(xml, "skipped", suite.skipped);
+        XmlAttribute(xml, "time", xUnitpp::Time::ToSeconds(suite.time).count());
+        xml += ">\n";
+
+        return xml;
     }
 
     std::string XmlEndSuite()
     {
-        return std::string("   ") +
-            "</testsuite>\n";
+        return "   </testsuite>\n";
     }
 
-    std::string XmlBeginTest(const std::string &testName, const TestResult &test)
+    std::string XmlTestCase(const TestResult &test)
     {
-        return std::string("      ") +
-            "<testcase" +
-                XmlAttribute("name", testName) +
-                XmlAttribute("time", xUnitpp::Time::ToSeconds(test.time).count());
-    }
+        const auto &testDetails = *test.testDetails;
 
-    std::string XmlEndTest(bool singleTag)
-    {
-        if (singleTag)
+        std::string xml = "      <testcase";
+        XmlAttribute(xml, "name", testDetails.GetFullName());
+        XmlAttribute(xml, "time", xUnitpp::Time::ToSeconds(test.time).count());
+
+        if (test.status == TestResult::Success && testDetails.GetAttributeCount() == 0 && test.properties.empty())
         {
-            return " />\n";
+            xml += " />\n";
+            return xml;
         }
 
-        return std::string("      ") +
-            "</testcase>\n";
-    }
+        xml += ">\n";
 
-    std::string XmlTestAttribute(const std::string &name, const std::string &value)
-    {
-        return std::string("         ") +
-            "<property" +
-                XmlAttribute("name", name) +
-                XmlAttribute("value", value) +
-            " />\n";
-    }
+        for (auto i = 0U; i != testDetails.GetAttributeCount(); ++i)
+        {
+            std::string key = testDetails.GetAttributeKey(i);
+            if (key != "Skip")
+            {
+                xml += "         <property";
+                XmlAttribute(xml, "name", key);
+                XmlAttribute(xml, "value", testDetails.GetAttributeValue(i));
+                xml += " />\n";
+            }
+        }
 
-    std::string XmlTestFailed(const std::string &fileAndLine, const std::vector<std::string> &messages)
-    {
-        std::string result;
-        for (const auto &message : messages)
+        // metrics and benchmark results share the property list with the attributes
+        for (const auto &property : test.properties)
         {
-            result += std::string("         ") +
-                "<failure" +
-                    XmlAttribute("message", fileAndLine + ": " + XmlEscape(message)) +
-                " />\n";
+            xml += "         <property";
+            XmlAttribute(xml, "name", property.first);
+            XmlAttribute(xml, "value", property.second);
+            xml += " />\n";
         }
 
-        return result;
-    }
+        if (test.status == TestResult::Failure)
+        {
+            auto fileAndLine = to_string(xUnitpp::LineInfo(testDetails.GetFile(), testDetails.GetLine()));
 
-    std::string XmlTestSkipped(const std::string &message)
-    {
-        return std::string("         ") +
-            "<skipped" +
-                XmlAttribute("message", XmlEscape(message)) +
-            "</skipped>\n";
+            for (const auto &message : test.messages)
+            {
+                xml += "         <failure";
+                XmlAttribute(xml, "message", fileAndLine + ": " + message);
+                xml += " />\n";
+            }
+        }
+        else if (test.status == TestResult::Skipped)
+        {
+            xml += "         <skipped";
+            XmlAttribute(xml, "message", test.messages[0]);
+            xml += " />\n";
+        }
+
+        xml += "      </testcase>\n";
+        return xml;
     }
 }
 
 namespace xUnitpp { namespace Utilities
 {
 
-XmlReporter::XmlReporter(std::ostream &output)
-    : output(output)
+class XmlReporter::ResultCache
 {
-}
+public:
+    void Start(const ITestDetails &testDetails)
+    {
+        runningTests.insert(std::make_pair(testDetails.GetId(), TestResult(testDetails)));
+    }
 
-XmlReporter::~XmlReporter() noexcept(true)
-{
-}
+    TestResult *Find(const ITestDetails &testDetails)
+    {
+        auto it = runningTests.find(testDetails.GetId());
+        return it == runningTests.end() ? nullptr : &it->second;
+    }
 
-void XmlReporter::ReportAllTestsComplete(size_t testCount, size_t, size_t failureCount, long long nsTotal)
-{
-    output << XmlBeginDoc();
-    output << XmlBeginResults(testCount, failureCount, nsTotal);
+    void Finish(const ITestDetails &testDetails)
+    {
+        auto it = runningTests.find(testDetails.GetId());
+        if (it != runningTests.end())
+        {
+            Spill(it->second);
+            runningTests.erase(it);
+        }
+    }
 
-    for (const auto &itSuite : suiteResults)
+    void WriteTo(std::ostream &output, size_t testCount, size_t failureCount, long long nsTotal)
     {
-        output << XmlBeginSuite(itSuite.second);
+        // anything still running by now has been abandoned, but it was still part of the run
+        for (auto &test : runningTests)
+        {
+            Spill(test.second);
+        }
 
-        for (const auto &test : itSuite.second.testResults)
+        runningTests.clear();
+
+        std::vector<SuiteResult *> suites;
+        for (auto &suite : suiteResults)
         {
-            output << XmlBeginTest(test.testDetails.GetFullName(), test);
+            suites.push_back(&suite.second);
+        }
 
-            if (test.status != TestResult::Success || test.testDetails.GetAttributeCount() != 0)
-            {
-                // close <TestCase>
-                output << ">\n";
-            }
+        std::sort(suites.begin(), suites.end(), [](const SuiteResult *a, const SuiteResult *b) { return a->name < b->name; });
 
-            for (auto i = 0U; i != test.testDetails.GetAttributeCount(); ++i)
-            {
-                std::string key = test.testDetails.GetAttributeKey(i);
-                if (key != "Skip")
-                {
-                    std::string value = test.testDetails.GetAttributeValue(i);
+        output << XmlBeginDoc();
+        output << XmlBeginResults(testCount, failureCount, nsTotal);
 
-                    output << XmlTestAttribute(key, value);
-                }
-            }
+        for (auto suite : suites)
+        {
+            output << XmlBeginSuite(*suite);
 
-            if (test.status == TestResult::Failure)
+            for (const auto &testCase : suite->testCases)
             {
-                xUnitpp::LineInfo li(test.testDetails.GetFile(), test.testDetails.GetLine());
-                output << XmlTestFailed(to_string(li), test.messages);
-            }
-            else if (test.status == TestResult::Skipped)
-            {
-                output << XmlTestSkipped(test.messages[0]);
+                spillFile.CopyTo(output, testCase.first, testCase.second);
             }
 
-            output << XmlEndTest(test.status == TestResult::Success && test.testDetails.GetAttributeCount() == 0);
+            output << XmlEndSuite();
         }
 
-        output << XmlEndSuite();
+        output << XmlEndResults();
+        output.flush();
     }
 
-    output << XmlEndResults();
+private:
+    void Spill(const TestResult &test)
+    {
+        std::string suiteName = test.testDetails->GetSuite();
+
+        auto it = suiteResults.find(suiteName);
+        if (it == suiteResults.end())
+        {
+            it = suiteResults.insert(std::make_pair(suiteName, SuiteResult(suiteName))).first;
+        }
+
+        auto &suite = it->second;
+        suite.tests++;
+        suite.time += test.time;
+
+        if (test.status == TestResult::Failure)
+        {
+            suite.failures++;
+        }
+        else if (test.status == TestResult::Skipped)
+        {
+            suite.skipped++;
+        }
+
+        auto xml = XmlTestCase(test);
+        suite.testCases.push_back(std::make_pair(spillFile.Append(xml), xml.size()));
+    }
+
+private:
+    std::unordered_map<int, TestResult> runningTests;
+    std::unordered_map<std::string, SuiteResult> suiteResults;
+    SpillFile spillFile;
+};
+
+XmlReporter::XmlReporter(std::ostream &output)
+    : output(output)
+    , cache(new ResultCache())
+{
 }
 
-void XmlReporter::ReportStart(const ITestDetails &testDetails)
+XmlReporter::~XmlReporter() noexcept(true)
 {
-    std::string suite = testDetails.GetSuite();
-    if (suiteResults.find(suite) == suiteResults.end())
-    {
-        suiteResults.insert(std::make_pair(suite, SuiteResult(suite)));
-    }
+}
 
-    suiteResults[suite].tests++;
-    suiteResults[suite].testResults.push_back(TestResult(testDetails));
+void XmlReporter::ReportAllTestsComplete(size_t testCount, size_t, size_t failureCount, long long nsTotal)
+{
+    cache->WriteTo(output, testCount, failureCount, nsTotal);
+}
+
+void XmlReporter::ReportStart(const ITestDetails &testDetails)
+{
+    cache->Start(testDetails);
 }
 
 void XmlReporter::ReportEvent(const ITestDetails &testDetails, const ITestEvent &evt)
 {
     if (evt.GetIsFailure())
     {
-        std::string suite = testDetails.GetSuite();
-        std::string name = testDetails.GetFullName();
-
-        suiteResults[suite].failures++;
-
-        auto &testResult = GetTestResult(suiteResults[suite].testResults, name);
-        testResult.messages.push_back(evt.GetToString());
-        testResult.status = TestResult::Failure;
+        auto testResult = cache->Find(testDetails);
+        if (testResult != nullptr)
+        {
+            testResult->messages.push_back(evt.GetToString());
+            testResult->status = TestResult::Failure;
+        }
     }
 }
 
 void XmlReporter::ReportSkip(const ITestDetails &testDetails, const char *reason)
 {
-    ReportStart(testDetails);
+    // skipped tests never start or finish
+    cache->Start(testDetails);
 
-    std::string suite = testDetails.GetSuite();
-    std::string name = testDetails.GetFullName();
+    auto testResult = cache->Find(testDetails);
+    testResult->messages.push_back(reason);
+    testResult->status = TestResult::Skipped;
 
-    suiteResults[suite].skipped++;
+    cache->Finish(testDetails);
+}
+
+void XmlReporter::ReportMetrics(const ITestDetails &testDetails, const ITestMetrics &metrics)
+{
+    auto testResult = cache->Find(testDetails);
+    if (testResult != nullptr)
+    {
+        for (size_t i = 0; i != metrics.GetCount(); ++i)
+        {
+            testResult->properties.push_back(std::make_pair(std::string(metrics.GetName(i)), std::to_string(metrics.GetValue(i))));
+        }
+    }
+}
 
-    auto &testResult = GetTestResult(suiteResults[suite].testResults, name);
-    testResult.messages.push_back(reason);
-    testResult.status = TestResult::Skipped;
+void XmlReporter::ReportBenchmark(const ITestDetails &testDetails, const IBenchmarkResult &benchmark)
+{
+    auto testResult = cache->Find(testDetails);
+    if (testResult != nullptr)
+    {
+        // times are in nanoseconds per call of the benchmark body
+        testResult->properties.push_back(std::make_pair(std::string("BenchmarkIterations"), std::to_string(benchmark.GetIterations())));
+        testResult->properties.push_back(std::make_pair(std::string("BenchmarkSamples"), std::to_string(benchmark.GetSampleCount())));
+        testResult->properties.push_back(std::make_pair(std::string("BenchmarkMeanNs"), std::to_string(benchmark.GetMean())));
+        testResult->properties.push_back(std::make_pair(std::string("BenchmarkStdDevNs"), std::to_string(benchmark.GetStandardDeviation())));
+        testResult->properties.push_back(std::make_pair(std::string("BenchmarkMinNs"), std::to_string(benchmark.GetMin())));
+        testResult->properties.push_back(std::make_pair(std::string("BenchmarkMaxNs"), std::to_string(benchmark.GetMax())));
+    }
 }
 
 void XmlReporter::ReportFinish(const ITestDetails &testDetails, long long nsTaken)
 {
-    GetTestResult(suiteResults[testDetails.GetSuite()].testResults, testDetails.GetFullName()).time = Time::Duration(nsTaken);
+    auto testResult = cache->Find(testDetails);
+    if (testResult != nullptr)
+    {
+        testResult->time = Time::Duration(nsTaken);
+    }
+
+    cache->Finish(testDetails);
 }
 
 }}
@@ -8,13 +8,17 @@
 #define noexcept(x)
 #endif
 
-#include <map>
+#include <memory>
 #include <ostream>
 #include "xUnit++/IOutput.h"
 
 namespace xUnitpp { namespace Utilities
 {
 
+//
+// Writes JUnit style xml. Each <testcase> is written out as its test finishes and parked in a temporary file,
+// so memory use doesn't grow with the size of the run: only the tests still running and the suite totals are kept.
+// The document itself is assembled, grouped by suite, once all tests are complete.
 class XmlReporter : public IOutput
 {
 public:
@@ -26,16 +30,17 @@ public:
     virtual void __stdcall ReportSkip(const ITestDetails &testDetails, const char *reason) override;
     virtual void __stdcall ReportFinish(const ITestDetails &testDetails, long long nsTaken) override;
     virtual void __stdcall ReportAllTestsComplete(size_t testCount, size_t skipped, size_t failureCount, long long nsTotal) override;
-
-public:
-    struct SuiteResult;
+    virtual void __stdcall ReportBenchmark(const ITestDetails &testDetails, const IBenchmarkResult &benchmark) override;
+    virtual void __stdcall ReportMetrics(const ITestDetails &testDetails, const ITestMetrics &metrics) override;
 
 private:
     XmlReporter &operator =(XmlReporter) /* = delete; */;
 
 private:
     std::ostream &output;
-    std::map<std::string, SuiteResult> suiteResults;
+
+    class ResultCache;
+    std::unique_ptr<ResultCache> cache;
 };
 
 }}
@@ -0,0 +1,156 @@
+#include "AllocationHooks.h"
+
+#if !defined(WIN32)
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include <malloc.h>
+#include "xUnit++/IAllocationCounter.h"
+
+namespace
+{
+    std::atomic<bool> counting(false);
+
+    // plain old data, so no thread has to allocate to set up its own totals
+    thread_local xUnitpp::AllocationTotals threadTotals;
+
+    void Count(void *p)
+    {
+        auto &totals = threadTotals;
+        auto size = (long long)malloc_usable_size(p);
+
+        ++totals.allocations;
+        totals.allocatedBytes += size;
+
+        auto live = totals.allocatedBytes - totals.freedBytes;
+        if (live > totals.peakLiveBytes)
+        {
+            totals.peakLiveBytes = live;
+        }
+    }
+
+    void Uncount(void *p)
+    {
+        auto &totals = threadTotals;
+
+        ++totals.frees;
+        totals.freedBytes += (long long)malloc_usable_size(p);
+    }
+
+    void *Allocate(size_t size)
+    {
+        for (;;)
+        {
+            if (void *p = std::malloc(size == 0 ? 1 : size))
+            {
+                if (counting.load(std::memory_order_relaxed))
+                {
+                    Count(p);
+                }
+
+                return p;
+            }
+
+            auto handler = std::get_new_handler();
+            if (handler == nullptr)
+            {
+                throw std::bad_alloc();
+            }
+
+            handler();
+        }
+    }
+
+    void Free(void *p)
+    {
+        if (p != nullptr && counting.load(std::memory_order_relaxed))
+        {
+            Uncount(p);
+        }
+
+        std::free(p);
+    }
+
+    class AllocationCounter : public xUnitpp::IAllocationCounter
+    {
+    public:
+        virtual void __stdcall GetThreadTotals(xUnitpp::AllocationTotals &totals) const override
+        {
+            totals = threadTotals;
+        }
+
+        virtual void __stdcall ResetPeak() override
+        {
+            auto &totals = threadTotals;
+            totals.peakLiveBytes = totals.allocatedBytes - totals.freedBytes;
+        }
+    } allocationCounter;
+}
+
+void *operator new(size_t size)
+{
+    return Allocate(size);
+}
+
+void *operator new[](size_t size)
+{
+    return Allocate(size);
+}
+
+void *operator new(size_t size, const std::nothrow_t &) noexcept(true)
+{
+    try
+    {
+        return Allocate(size);
+    }
+    catch (...)
+    {
+        return nullptr;
+    }
+}
+
+void *operator new[](size_t size, const std::nothrow_t &) noexcept(true)
+{
+    try
+    {
+        return Allocate(size);
+    }
+    catch (...)
+    {
+        return nullptr;
+    }
+}
+
+void operator delete(void *p) noexcept(true)
+{
+    Free(p);
+}
+
+void operator delete[](void *p) noexcept(true)
+{
+    Free(p);
+}
+
+void operator delete(void *p, const std::nothrow_t &) noexcept(true)
+{
+    Free(p);
+}
+
+void operator delete[](void *p, const std::nothrow_t &) noexcept(true)
+{
+    Free(p);
+}
+
+namespace xUnitpp { namespace Utilities
+{
+
+IAllocationCounter &EnableAllocationCounting()
+{
+    counting = true;
+    return allocationCounter;
+}
+
+}}
+
+#endif
@@ -0,0 +1,26 @@
+#ifndef ALLOCATIONHOOKS_H_
+#define ALLOCATIONHOOKS_H_
+
+#if !defined(WIN32)
+
+namespace xUnitpp
+{
+    struct IAllocationCounter;
+}
+
+namespace xUnitpp { namespace Utilities
+{
+
+//
+// The console replaces the global operator new and delete, so every test library it loads allocates through it.
+// Nothing is counted until counting is enabled, and then each thread keeps its own totals, which is what lets
+// a test library charge each test for what was allocated on the thread that ran it.
+//
+// Sizes are what the allocator actually handed out (malloc_usable_size), so frees match up with allocations.
+IAllocationCounter &EnableAllocationCounting();
+
+}}
+
+#endif
+
+#endif
@@ -60,8 +60,19 @@ namespace CommandLine
         , timeLimit(0)
         , threadLimit(0)
         , shadowCopy(true)
+        , history(true)
+        , discoveryCache(true)
+        , orderByDuration(false)
+        , isolateProcesses(false)
+        , parallelLibraries(false)
+        , batchSize(1)
+        , shardIndex(0)
+        , shardCount(1)
+        , shardByDuration(false)
         , sort(false)
         , group(false)
+        , benchmarks(false)
+        , allocations(false)
     {
     }
 
@@ -121,6 +132,24 @@ namespace CommandLine
 
                     options.testNames.push_back(TakeFront(arguments));
                 }
+                else if (opt == "--names-from")
+                {
+                    if (arguments.empty())
+                    {
+                        return opt + " expects a following filename." + Usage(exe());
+                    }
+
+                    options.namesFrom = TakeFront(arguments);
+                }
+                else if (opt == "-w" || opt == "--where")
+                {
+                    if (arguments.empty())
+                    {
+                        return opt + " expects a following filter expression." + Usage(exe());
+                    }
+
+                    options.expressions.push_back(TakeFront(arguments));
+                }
                 else if (opt == "-i" || opt == "--include")
                 {
                     auto error = EatKeyValuePairs(opt, arguments, [&](std::pair<std::string, std::string> &&kv) { options.inclusiveAttributes.insert(kv); });
@@ -151,6 +180,24 @@ namespace CommandLine
                         options.xmlOutput = TakeFront(arguments);
                     }
                 }
+                else if (opt == "--json")
+                {
+                    if (arguments.empty() || arguments.front().front() == '-')
+                    {
+                        return opt + " expects a following filename or file descriptor." + Usage(exe());
+                    }
+
+                    options.jsonOutput = TakeFront(arguments);
+                }
+                else if (opt == "--result-log")
+                {
+                    if (arguments.empty() || arguments.front().front() == '-')
+                    {
+                        return opt + " expects a following filename." + Usage(exe());
+                    }
+
+                    options.resultLog = TakeFront(arguments);
+                }
                 else if (opt == "-t" || opt == "--timelimit")
                 {
                     if (arguments.empty() || !GetInt(arguments, options.timeLimit))
@@ -174,10 +221,115 @@ namespace CommandLine
                     options.sort = true;
                     options.group = true;
                 }
+                else if (opt == "--benchmarks")
+                {
+                    options.benchmarks = true;
+                }
+                else if (opt == "--allocations")
+                {
+                    options.allocations = true;
+                }
                 else if (opt == "--no-shadow")
                 {
                     options.shadowCopy = false;
                 }
+                else if (opt == "--shadow-cache")
+                {
+                    if (arguments.empty() || arguments.front().front() == '-')
+                    {
+                        return opt + " expects a following directory." + Usage(exe());
+                    }
+
+                    options.shadowCache = TakeFront(arguments);
+                }
+                else if (opt == "--no-history")
+                {
+                    options.history = false;
+                }
+                else if (opt == "--no-discovery-cache")
+                {
+                    options.discoveryCache = false;
+                }
+                else if (opt == "--order")
+                {
+                    auto order = arguments.empty() ? std::string() : TakeFront(arguments);
+
+                    if (order == "duration")
+                    {
+                        options.orderByDuration = true;
+                    }
+                    else if (order == "random")
+                    {
+                        options.orderByDuration = false;
+                    }
+                    else
+                    {
+                        return opt + " expects a following order of either \"random\" or \"duration\"." + Usage(exe());
+                    }
+                }
+                else if (opt == "--parallel")
+                {
+                    options.parallelLibraries = true;
+                }
+                else if (opt == "--isolate")
+                {
+                    auto isolation = arguments.empty() ? std::string() : TakeFront(arguments);
+
+                    if (isolation == "process")
+                    {
+#if defined(WIN32)
+                        return opt + " process is not supported on this platform." + Usage(exe());
+#else
+                        options.isolateProcesses = true;
+#endif
+                    }
+                    else if (isolation == "thread")
+                    {
+                        options.isolateProcesses = false;
+                    }
+                    else
+                    {
+                        return opt + " expects a following isolation of either \"thread\" or \"process\"." + Usage(exe());
+                    }
+                }
+                else if (opt == "--batch")
+                {
+                    if (arguments.empty() || !GetInt(arguments, options.batchSize) || options.batchSize < 1)
+                    {
+                        return opt + " expects a following number of tests to run in each process." + Usage(exe());
+                    }
+                }
+                else if (opt == "--shard-index")
+                {
+                    if (arguments.empty() || !GetInt(arguments, options.shardIndex) || options.shardIndex < 0)
+                    {
+                        return opt + " expects a following zero-based shard index." + Usage(exe());
+                    }
+                }
+                else if (opt == "--shard-count")
+                {
+                    if (arguments.empty() || !GetInt(arguments, options.shardCount) || options.shardCount < 1)
+                    {
+                        return opt + " expects a following number of shards." + Usage(exe());
+                    }
+                }
+                else if (opt == "--shard-by")
+                {
+                    auto shardBy = arguments.empty() ? std::string() : TakeFront(arguments);
+
+                    if (shardBy == "duration")
+                    {
+                        options.shardByDuration = true;
+                    }
+                    else if (shardBy == "hash")
+                    {
+                        options.shardByDuration = false;
+                    }
+                    else
+                    {
+                        return opt + " expects a following method of either \"hash\" or \"duration\"." + Usage(exe());
+                    }
+                }
                 else
                 {
                     return "Unrecognized option " + opt + "." + Usage(exe());
@@ -199,6 +351,18 @@ namespace CommandLine
             return "At least one testLibrary must be specified." + Usage(exe());
         }
 
+        if (options.shardIndex >= options.shardCount)
+        {
+            return "--shard-index must be less than --shard-count." + Usage(exe());
+        }
+
+        // shards run at the same time would each save only their own tests' timings over the others';
+        // for duration sharding, a shard would also no longer agree with the others on where the tests belong
+        if (options.shardCount > 1)
+        {
+            options.history = false;
+        }
+
         return "";
     }
 
@@ -212,19 +376,63 @@ namespace CommandLine
             "  -l --list                      : Do not run tests, just list the ones that pass the filters\n"
             "  -s --suite <SUITE>+            : Suite(s) of tests to run (regex match)\n"
             "  -n --name <TEST>+              : Test(s) to run (regex match)\n"
+            "     --names-from <FILENAME>     : Run only the tests named in FILENAME, one full name per line\n"
+            "  -w --where <EXPRESSION>        : Run only the tests matching a filter expression (see below)\n"
             "  -i --include <NAME=[VALUE]>+   : Include tests with exactly matching <name=value> attribute(s)\n"
             "  -e --exclude <NAME=[VALUE]>+   : Exclude tests with exactly matching <name=value> attribute(s)\n"
             "  -t --timelimit <milliseconds>  : Set the default test time limit\n"
             "  -x --xml [FILENAME]            : Output Xunit-style XML, to optional file named FILENAME\n"
+            "     --json <FILENAME|FD>        : Stream results as they happen, one JSON object per line, to a file or file descriptor\n"
+            "     --result-log <FILENAME>     : Record the run in a compact binary log, for xUnit++.ResultDiff\n"
             "  -c --concurrent <max tests>    : Set maximum number of concurrent tests\n"
             "  -o --sort                      : Sort tests by suite and then by test name\n"
             "  -g --group                     : Group test output under suite headers (implies --sort)\n"
+            "     --benchmarks                : Run BENCHMARK tests as well (they are left out by default)\n"
+            "     --allocations               : Count the heap allocations made by each test, and report leaks\n"
             "     --no-shadow                 : Disable shadow copying the test binaries\n"
+            "     --shadow-cache <DIRECTORY>  : Keep shadow copies in DIRECTORY, and reuse them while the test binaries are unchanged\n"
+            "     --no-history                : Do not record test timings in <testLibrary>.xuhistory\n"
+            "     --no-discovery-cache        : Do not keep the details of each test in <testLibrary>.xudiscovery\n"
+            "     --order <random|duration>   : Run tests in random order (default), or longest expected first\n"
+            "     --isolate <thread|process>  : Run tests on threads (default), or in separate processes\n"
+            "     --parallel                  : Load and run every test library at once, sharing --concurrent between them\n"
+            "     --batch <tests>             : Number of tests to run in each process when isolating processes\n"
+            "     --shard-index <index>       : Run only the tests in shard <index> (zero-based) of --shard-count\n"
+            "     --shard-count <shards>      : Split the selected tests into this many shards\n"
+            "     --shard-by <hash|duration>  : Assign tests to shards by name (default), or to balance recorded timings\n"
             "\n"
             "Tests are selected with an OR operation for inclusive attributes.\n"
             "Tests are excluded with an AND operation for exclusive attributes.\n"
             "When VALUE is omitted, any attribute with name NAME is matched.\n"
             "\n"
+            "Filter expressions check a test's suite, name and attributes:\n"
+            "    suite ~ REGEX, name ~ REGEX, fullname ~ REGEX  : case insensitive regex search\n"
+            "    suite = TEXT, name = TEXT, fullname = TEXT     : exact match\n"
+            "    [NAME], [NAME = VALUE]                         : has the attribute\n"
+            "with not (!), and (&&), or (||) and parentheses, e.g. -w \"suite ~ ^Net && !([Slow] || name ~ retry)\".\n"
+            "Quote values that contain spaces or punctuation. All filters must pass for a test to run.\n"
+            "\n"
+            "Duration ordering uses the median of the recorded test timings, falling back to a test's\n"
+            "\"Cost\" attribute (in milliseconds) for tests that have no history.\n"
+            "\n"
+            "Shards split the tests left after filtering. Every shard must be given the same filters, and for\n"
+            "duration sharding the same <testLibrary>.xuhistory, to agree on where each test belongs. A shard\n"
+            "only reads the history, as though --no-history were given, so that shards don't overwrite each other's.\n"
+            "\n"
+            "Benchmarks report the time per call of their body, averaged over several samples.\n"
+            "\n"
+            "Allocations are charged to a test when they are made on the thread running it, so memory a test\n"
+            "hands to another thread to free is reported as leaked. Counting is not supported on Windows.\n"
+            "\n"
+            "Process isolation turns a crash into a test failure, and runs up to --concurrent processes at once.\n"
+            "\n"
+            "With --parallel, no more than --concurrent tests run at a time across all libraries, though libraries\n"
+            "built before it was added run as many as they would on their own. It is ignored when isolating processes.\n"
+            "Each library's XML report is written to the one file as its own document, once that library is done.\n"
+            "JSON objects name the library they came from, and the result log keeps each library in a section of its own.\n"
+            "\n"
+            "The discovery cache lets --list run without loading <testLibrary>, for as long as the library is unchanged.\n"
+            "\n"
             "Sorting and grouping test output causes test results to be cached until after all tests have completed.\n"
             "Normally, test results are printed as soon as the test is complete.\n";
 
@@ -19,15 +19,31 @@ namespace CommandLine
         bool list;
         std::vector<std::string> suites;
         std::vector<std::string> testNames;
+        std::string namesFrom;
+        std::vector<std::string> expressions;
         std::multimap<std::string, std::string> inclusiveAttributes;
         std::multimap<std::string, std::string> exclusiveAttributes;
         std::set<std::string> libraries;
         std::string xmlOutput;
+        std::string jsonOutput;
+        std::string resultLog;
         int timeLimit;
         int threadLimit;
         bool shadowCopy;
+        std::string shadowCache;
+        bool history;
+        bool discoveryCache;
+        bool orderByDuration;
+        bool isolateProcesses;
+        bool parallelLibraries;
+        int batchSize;
+        int shardIndex;
+        int shardCount;
+        bool shardByDuration;
         bool sort;
         bool group;
+        bool benchmarks;
+        bool allocations;
     };
 
     std::string Parse(int argc, char **argv, Options &options);
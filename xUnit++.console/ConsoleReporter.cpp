@@ -5,12 +5,16 @@
 #include <iostream>
 #include <memory>
 #include <mutex>
+#include <sstream>
 #include <string>
 #include <unordered_map>
+#include <vector>
 #include "xUnit++/EventLevel.h"
+#include "xUnit++/IBenchmarkResult.h"
 #include "xUnit++/LineInfo.h"
 #include "xUnit++/ITestDetails.h"
 #include "xUnit++/ITestEvent.h"
+#include "xUnit++/ITestMetrics.h"
 
 #if defined (_WIN32)
 #include <Windows.h>
@@ -90,6 +94,9 @@ namespace
         Call = White,
         Expected = Cyan,
         Actual = Cyan,
+        Benchmark = Cyan,
+        Metrics = DarkGray,
+        Leak = Yellow,
 
         // this value is to match the Win32 value
         // there is a special test in to_ansicode
@@ -193,6 +200,14 @@ namespace
     {
         return s == nullptr ? "" : s;
     }
+
+    std::string Nanoseconds(double ns)
+    {
+        std::ostringstream str;
+        str.precision(4);
+        str << ns << " ns";
+        return str.str();
+    }
 }
 
 namespace xUnitpp
@@ -347,6 +362,50 @@ class ConsoleReporter::ReportCache
             return *this;
         }
 
+        TestOutput &operator <<(const xUnitpp::IBenchmarkResult &benchmark)
+        {
+            fragments.emplace_back(Color::FileAndLine, to_string(GetSafeLineInfo(testDetails)));
+            fragments.emplace_back(Color::Separator, ": ");
+            fragments.emplace_back(Color::Benchmark, "[ Benchmark ]");
+            fragments.emplace_back(Color::Separator, ": ");
+            fragments.emplace_back(Color::Default, Nanoseconds(benchmark.GetMean()) + " per call");
+            fragments.emplace_back(Color::TimeSummary, " (standard deviation " + Nanoseconds(benchmark.GetStandardDeviation()) +
+                ", min " + Nanoseconds(benchmark.GetMin()) + ", max " + Nanoseconds(benchmark.GetMax()) + "; " +
+                std::to_string(benchmark.GetSampleCount()) + " samples of " + std::to_string(benchmark.GetIterations()) + " calls)\n");
+
+            return *this;
+        }
+
+        TestOutput &operator <<(const xUnitpp::ITestMetrics &metrics)
+        {
+            std::string summary;
+
+            for (size_t i = 0; i != metrics.GetCount(); ++i)
+            {
+                auto name = safestr(metrics.GetName(i));
+                auto value = metrics.GetValue(i);
+
+                // a leak is worth hearing about even when nothing else is
+                if (name == "LeakedBytes" && value > 0)
+                {
+                    fragments.emplace_back(Color::FileAndLine, to_string(GetSafeLineInfo(testDetails)));
+                    fragments.emplace_back(Color::Separator, ": ");
+                    fragments.emplace_back(Color::Leak, "[ Leak ]");
+                    fragments.emplace_back(Color::Separator, ": ");
+                    fragments.emplace_back(Color::Default, std::to_string(value) + " bytes allocated by the test were not freed.\n");
+                }
+
+                summary += (summary.empty() ? "" : ", ") + name + " = " + std::to_string(value);
+            }
+
+            if (verbose && !summary.empty())
+            {
+                fragments.emplace_back(Color::Metrics, "Metrics: " + summary + ".\n");
+            }
+
+            return *this;
+        }
+
         TestOutput &operator <<(xUnitpp::Time::Duration time)
         {
             if (verbose)
@@ -528,6 +587,16 @@ void ConsoleReporter::ReportFinish(const ITestDetails &testDetails, long long ns
     cache->Finish(testDetails);
 }
 
+void ConsoleReporter::ReportBenchmark(const ITestDetails &testDetails, const IBenchmarkResult &benchmark)
+{
+    cache->Cache(testDetails) << benchmark;
+}
+
+void ConsoleReporter::ReportMetrics(const ITestDetails &testDetails, const ITestMetrics &metrics)
+{
+    cache->Cache(testDetails) << metrics;
+}
+
 void ConsoleReporter::ReportAllTestsComplete(size_t testCount, size_t skipped, size_t failureCount, long long nsTotal)
 {
     auto totalTime = Time::Duration(nsTotal);
@@ -25,6 +25,8 @@ public:
     virtual void __stdcall ReportSkip(const ITestDetails &testDetails, const char *reason) override;
     virtual void __stdcall ReportFinish(const ITestDetails &, long long nsTaken) override;
     virtual void __stdcall ReportAllTestsComplete(size_t testCount, size_t skipped, size_t failureCount, long long nsTotal) override;
+    virtual void __stdcall ReportBenchmark(const ITestDetails &testDetails, const IBenchmarkResult &benchmark) override;
+    virtual void __stdcall ReportMetrics(const ITestDetails &testDetails, const ITestMetrics &metrics) override;
 
 private:
     class ReportCache;
@@ -1,17 +1,50 @@
 #include <algorithm>
+#include <atomic>
+#include <cctype>
 #include <fstream>
 #include <iostream>
-#include <regex>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <sstream>
 #include <string>
+#include <thread>
 #include <tuple>
 #include <vector>
 #include "xUnit++/ExportApi.h"
 #include "xUnit++/ITestDetails.h"
+#include "AllocationHooks.h"
+#include "CatalogTests.h"
 #include "CommandLine.h"
 #include "ConsoleReporter.h"
+#include "DiscoveryCache.h"
+#include "IsolatedRunner.h"
+#include "JsonReporter.h"
+#include "MultiReporter.h"
+#include "ResultLog.h"
+#include "Sharding.h"
 #include "TestAssembly.h"
+#include "TestFilter.h"
+#include "TestHistory.h"
+#include "ThreadBudget.h"
 #include "XmlReporter.h"
 
+namespace
+{
+    // --json accepts a file descriptor, such as a pipe set up by whoever launched us
+    std::string JsonOutputPath(const std::string &output)
+    {
+#if !defined(WIN32)
+        if (std::all_of(output.begin(), output.end(), [](char c) { return std::isdigit((unsigned char)c) != 0; }))
+        {
+            return "/dev/fd/" + output;
+        }
+#endif
+
+        return output;
+    }
+}
+
 int main(int argc, char **argv)
 {
     xUnitpp::Utilities::CommandLine::Options options;
@@ -25,172 +58,311 @@ int main(int argc, char **argv)
         }
     }
 
-    int totalFailures = 0;
-    bool forcedFailure = false;
+    std::atomic<int> totalFailures(0);
+    std::atomic<bool> forcedFailure(false);
+
+    xUnitpp::Utilities::TestFilter filter;
 
-    for (const auto &lib : options.libraries)
     {
-        auto testAssembly = xUnitpp::Utilities::TestAssembly(lib.c_str(), options.shadowCopy);
+        std::string error;
+
+        auto check = [&](const std::string &result)
+            {
+                if (error.empty())
+                {
+                    error = result;
+                }
+            };
 
-        if (!testAssembly)
+        check(filter.IncludeSuites(options.suites));
+        check(filter.IncludeNames(options.testNames));
+
+        for (const auto &expression : options.expressions)
         {
-            std::cerr << "Unable to load " << lib << std::endl;
-            forcedFailure = true;
-            continue;
+            check(filter.Where(expression));
         }
 
-        std::vector<int> activeTestIds;
-        auto onList = [&](const xUnitpp::ITestDetails &td)
+        if (!options.namesFrom.empty())
+        {
+            std::ifstream names(options.namesFrom);
+            check(names ? filter.IncludeNamesFrom(names) : "Unable to read test names from " + options.namesFrom + ".");
+        }
+
+        filter.IncludeAttributes(options.inclusiveAttributes);
+        filter.ExcludeAttributes(options.exclusiveAttributes);
+
+        // benchmarks take a while, so they only run when asked for
+        if (!options.benchmarks)
+        {
+            std::multimap<std::string, std::string> benchmarks;
+            benchmarks.insert(std::make_pair("Benchmark", ""));
+            filter.ExcludeAttributes(benchmarks);
+        }
+
+        if (!error.empty())
+        {
+            std::cerr << error << std::endl;
+            return -1;
+        }
+    }
+
+    std::ofstream jsonFile;
+
+    if (!options.jsonOutput.empty())
+    {
+        jsonFile.open(JsonOutputPath(options.jsonOutput), std::ios::binary);
+
+        if (!jsonFile)
+        {
+            std::cerr << "Unable to open " << options.jsonOutput << " for writing.\n\n";
+            return -1;
+        }
+    }
+
+    std::ofstream resultLogFile;
+    std::unique_ptr<xUnitpp::Utilities::ResultLogWriter> resultLogWriter;
+
+    if (!options.resultLog.empty())
+    {
+        resultLogFile.open(options.resultLog, std::ios::binary);
+
+        if (!resultLogFile)
+        {
+            std::cerr << "Unable to open " << options.resultLog << " for writing.\n\n";
+            return -1;
+        }
+
+        resultLogWriter.reset(new xUnitpp::Utilities::ResultLogWriter(resultLogFile));
+    }
+
+    // forking a process with other libraries still running on their own threads isn't safe
+    bool parallel = options.parallelLibraries && options.libraries.size() > 1 && !options.isolateProcesses;
+
+    // everything written to the console, or to reporters shared between libraries, is written holding this
+    std::mutex outputLock;
+
+    // with libraries running at the same time, each writes its own document into the one file once its run is over
+    std::ofstream xmlFile;
+
+    if (parallel && !options.xmlOutput.empty() && options.xmlOutput != ".")
+    {
+        xmlFile.open(options.xmlOutput, std::ios::binary);
+
+        if (!xmlFile)
+        {
+            std::cerr << "Unable to open " << options.xmlOutput << " for writing.\n\n";
+        }
+    }
+
+    xUnitpp::Utilities::ThreadBudget budget(options.threadLimit);
+
+    auto runLibrary = [&](const std::string &lib)
+    {
+        xUnitpp::Utilities::DiscoveryCache discovery;
+        auto discoveryFile = lib + ".xudiscovery";
+        bool discoveryCurrent = options.discoveryCache && discovery.Load(discoveryFile, lib);
+
+        // every test is read straight from the catalog's tables: the library's own, the cache's, or one made from enumerating them
+        xUnitpp::TestCatalog catalog;
+        xUnitpp::Utilities::CatalogBuilder enumerated;
+        std::unique_ptr<xUnitpp::Utilities::TestAssembly> testAssembly;
+
+        // listing only needs the details of each test, so with a current cache the library is never loaded
+        if (options.list && discoveryCurrent)
+        {
+            catalog = discovery.Catalog();
+        }
+        else
+        {
+            testAssembly.reset(new xUnitpp::Utilities::TestAssembly(lib.c_str(), options.shadowCopy, options.shadowCache));
+
+            if (!*testAssembly)
             {
-                if (options.list)
-                {
-                    std::cout << std::endl;
-                    for (auto i = 0U; i != td.GetAttributeCount(); ++i)
-                    {
-                        std::cout << (std::string("[") + td.GetAttributeKey(i) + " = " + td.GetAttributeValue(i) + "]") << std::endl;
-                    }
+                std::lock_guard<std::mutex> guard(outputLock);
+                std::cerr << "Unable to load " << lib << std::endl;
+                forcedFailure = true;
+                return;
+            }
 
-                    std::cout << (td.GetSuite() + std::string(" :: ") + td.GetName()) << std::endl;
-                }
-                else
+            if (parallel && testAssembly->SetThreadBudget != nullptr)
+            {
+                testAssembly->SetThreadBudget(&budget);
+            }
+
+#if !defined(WIN32)
+            if (options.allocations && testAssembly->SetAllocationCounter != nullptr)
+            {
+                testAssembly->SetAllocationCounter(&xUnitpp::Utilities::EnableAllocationCounting());
+            }
+#endif
+
+            // the whole catalog comes back in one call; older libraries only know how to hand over each test in turn
+            if (testAssembly->GetTestCatalog != nullptr)
+            {
+                catalog = *testAssembly->GetTestCatalog();
+            }
+            else
+            {
+                testAssembly->EnumerateTestDetails([&](const xUnitpp::ITestDetails &td) { enumerated.Add(td); });
+                catalog = enumerated.Catalog();
+            }
+
+            if (options.discoveryCache && !discoveryCurrent)
+            {
+                discovery.Record(catalog);
+
+                if (!discovery.Save(discoveryFile, lib))
                 {
-                    activeTestIds.push_back(td.GetId());
+                    std::lock_guard<std::mutex> guard(outputLock);
+                    std::cerr << "Unable to save test discovery cache to " << discoveryFile << ".\n";
                 }
+            }
+        }
+
+        std::vector<const xUnitpp::TestCatalogEntry *> activeTests;
+        for (size_t i = 0; i != catalog.testCount; ++i)
+        {
+            if (filter.Matches(catalog, catalog.tests[i]))
+            {
+                activeTests.push_back(&catalog.tests[i]);
+            }
+        }
+
+        xUnitpp::Utilities::TestHistory history;
+        auto historyFile = lib + ".xuhistory";
+
+        if (options.history || options.orderByDuration || options.shardByDuration)
+        {
+            history.Load(historyFile);
+        }
+
+        auto expectedDuration = [&](const xUnitpp::ITestDetails &testDetails)
+            {
+                xUnitpp::Utilities::TestHistory::Statistics statistics;
+                return history.Find(testDetails, statistics) ? statistics.median.count() : -1LL;
             };
 
-        testAssembly.EnumerateTestDetails([&](const xUnitpp::ITestDetails &td)
+        if (options.shardCount > 1)
+        {
+            auto catalogDuration = [&](const xUnitpp::TestCatalogEntry &entry)
+                {
+                    xUnitpp::Utilities::TestHistory::Statistics statistics;
+                    return history.Find(catalog.strings + entry.suite, catalog.strings + entry.fullName, catalog.strings + entry.file, entry.line, statistics) ?
+                        statistics.median.count() : -1LL;
+                };
+
+            auto shards = options.shardByDuration ?
+                xUnitpp::Utilities::DurationShards(catalog, activeTests, options.shardCount, catalogDuration) :
+                xUnitpp::Utilities::HashShards(catalog, activeTests, options.shardCount);
+
+            std::vector<const xUnitpp::TestCatalogEntry *> shardTests;
+            for (size_t i = 0; i != activeTests.size(); ++i)
             {
-                // check suites:
-                // if any suites are specified, a test has to belong to one of them to be run
-                if (!options.suites.empty())
+                if (shards[i] == (size_t)options.shardIndex)
                 {
-                    bool included = false;
-                    for (const auto &suite : options.suites)
-                    {
-                        std::regex regex(suite, std::regex_constants::icase);
+                    shardTests.push_back(activeTests[i]);
+                }
+            }
 
-                        std::string testSuite = td.GetSuite() == nullptr ? "" : td.GetSuite();
-                        if (std::regex_search(testSuite, regex))
-                        {
-                            included = true;
-                            break;
-                        }
-                    }
+            activeTests.swap(shardTests);
+        }
 
-                    if (!included)
-                    {
-                        return;
-                    }
+        if (options.list)
+        {
+            // each library's list is printed in one piece
+            std::ostringstream list;
+
+            for (auto test : activeTests)
+            {
+                list << "\n";
+                for (auto i = 0U; i != test->attributeCount; ++i)
+                {
+                    const auto &attribute = catalog.attributes[test->firstAttribute + i];
+                    list << "[" << catalog.strings + attribute.key << " = " << catalog.strings + attribute.value << "]\n";
                 }
 
-                // check names
-                if (!options.testNames.empty())
+                list << catalog.strings + test->suite << " :: " << catalog.strings + test->fullName << "\n";
+            }
+
+            std::lock_guard<std::mutex> guard(outputLock);
+            std::cout << list.str() << std::flush;
+            return;
+        }
+
+        std::vector<int> activeTestIds;
+        for (auto test : activeTests)
+        {
+            activeTestIds.push_back(test->id);
+        }
+
+        if (!activeTestIds.empty())
+        {
+            std::sort(activeTestIds.begin(), activeTestIds.end());
+
+            auto runTests = [&](xUnitpp::IOutput &reporter)
                 {
-                    bool included = false;
-                    for (const auto &name : options.testNames)
-                    {
-                        std::regex regex(name, std::regex_constants::icase);
+                    xUnitpp::Utilities::HistoryReporter historyReporter(history);
 
-                        if (std::regex_search(td.GetName(), regex))
-                        {
-                            included = true;
-                            break;
-                        }
-                    }
+                    // test ids are only unique within a library, so each library's json and result log are told apart
+                    xUnitpp::Utilities::JsonReporter jsonReporter(jsonFile, lib);
+                    std::unique_ptr<xUnitpp::Utilities::ResultLogWriter> resultLogSection;
 
-                    if (!included)
+                    if (resultLogWriter && parallel)
                     {
-                        return;
+                        std::lock_guard<std::mutex> guard(outputLock);
+                        resultLogSection = resultLogWriter->AddSection();
                     }
-                }
 
-                // check inclusive attributes:
-                // a test has to have *any* matching attribute key and value to be run
-                if (!options.inclusiveAttributes.empty())
-                {
-                    bool included = false;
+                    xUnitpp::Utilities::MultiReporter reporters(outputLock);
+                    reporters.Add(reporter);
 
-                    for (auto test = options.inclusiveAttributes.begin(); !included && test != options.inclusiveAttributes.end(); ++test)
+                    if (options.history)
                     {
-                        size_t begin, end;
-                        td.FindAttributeKey(test->first.c_str(), begin, end);
+                        reporters.Add(historyReporter);
+                    }
 
-                        if (begin != end)
-                        {
-                            if (test->second == "")
-                            {
-                                included = true;
-                                break;
-                            }
-
-                            for (auto it = begin; it != end; ++it)
-                            {
-                                if (td.GetAttributeValue(it) == test->second)
-                                {
-                                    included = true;
-                                    break;
-                                }
-                            }
-                        }
+                    if (jsonFile.is_open())
+                    {
+                        reporters.Add(jsonReporter);
                     }
 
-                    if (!included)
+                    if (resultLogWriter)
                     {
-                        return;
+                        reporters.Add(resultLogSection ? *resultLogSection : *resultLogWriter);
                     }
-                }
 
-                // check exclusive attributes:
-                // if a test has *all* matching keys, it is excluded
-                if (!options.exclusiveAttributes.empty())
-                {
-                    bool matchFailed = false;
-                    for (auto test = options.exclusiveAttributes.begin(); !matchFailed && test != options.exclusiveAttributes.end(); ++test)
+                    auto filter = [&](const xUnitpp::ITestDetails &testDetails)
+                        {
+                            return std::binary_search(activeTestIds.begin(), activeTestIds.end(), testDetails.GetId());
+                        };
+
+#if !defined(WIN32)
+                    if (options.isolateProcesses)
                     {
-                        size_t begin, end;
-                        td.FindAttributeKey(test->first.c_str(), begin, end);
+                        // a test whose process dies is reported from here, so it needs to be seen through ITestDetails
+                        std::vector<xUnitpp::Utilities::CatalogTest> isolated;
+                        isolated.reserve(activeTests.size());
 
-                        if (begin != end)
+                        std::vector<const xUnitpp::ITestDetails *> isolatedTests;
+                        for (auto test : activeTests)
                         {
-                            // key matched, and we want to exclude all tests with a specific value
-                            if (test->second != "")
-                            {
-                                for (; begin != end; ++begin)
-                                {
-                                    if (td.GetAttributeValue(begin) == test->second)
-                                    {
-                                        break;
-                                    }
-                                }
-
-                                if (begin == end)
-                                {
-                                    matchFailed = true;
-                                }
-                            }
+                            isolated.push_back(xUnitpp::Utilities::CatalogTest(catalog, *test));
+                            isolatedTests.push_back(&isolated.back());
                         }
-                    }
 
-                    if (!matchFailed)
+                        totalFailures += xUnitpp::Utilities::RunIsolated(testAssembly->FilteredTestsRunner, isolatedTests,
+                            options.timeLimit, options.threadLimit, options.batchSize, reporters);
+                    }
+                    else
+#endif
+                    if (options.orderByDuration && testAssembly->OrderedTestsRunner != nullptr)
                     {
-                        return;
+                        totalFailures += testAssembly->OrderedTestsRunner(options.timeLimit, options.threadLimit, reporters, filter, expectedDuration);
+                    }
+                    else
+                    {
+                        totalFailures += testAssembly->FilteredTestsRunner(options.timeLimit, options.threadLimit, reporters, filter);
                     }
-                }
-
-                onList(td);
-            });
-
-        if (!activeTestIds.empty())
-        {
-            std::sort(activeTestIds.begin(), activeTestIds.end());
-
-            auto runTests = [&](xUnitpp::IOutput &reporter)
-                {
-                    totalFailures += testAssembly.FilteredTestsRunner(options.timeLimit, options.threadLimit, reporter,
-                        [&](const xUnitpp::ITestDetails &testDetails)
-                        {
-                            return std::binary_search(activeTestIds.begin(), activeTestIds.end(), testDetails.GetId());
-                        });
                 };
 
             if (options.xmlOutput.empty())
@@ -203,6 +375,11 @@ int main(int argc, char **argv)
                 xUnitpp::Utilities::XmlReporter reporter(std::cout);
                 runTests(reporter);
             }
+            else if (parallel)
+            {
+                xUnitpp::Utilities::XmlReporter reporter(!xmlFile ? std::cerr : xmlFile);
+                runTests(reporter);
+            }
             else
             {
                 std::ofstream file(options.xmlOutput, std::ios::binary);
@@ -215,6 +392,34 @@ int main(int argc, char **argv)
                 xUnitpp::Utilities::XmlReporter reporter(!file ? std::cerr : file);
                 runTests(reporter);
             }
+
+            if (options.history && !history.Save(historyFile))
+            {
+                std::lock_guard<std::mutex> guard(outputLock);
+                std::cerr << "Unable to save test history to " << historyFile << ".\n";
+            }
+        }
+    };
+
+    if (parallel)
+    {
+        std::vector<std::thread> libraries;
+
+        for (const auto &lib : options.libraries)
+        {
+            libraries.push_back(std::thread(runLibrary, std::cref(lib)));
+        }
+
+        for (auto &library : libraries)
+        {
+            library.join();
+        }
+    }
+    else
+    {
+        for (const auto &lib : options.libraries)
+        {
+            runLibrary(lib);
         }
     }
 
@@ -0,0 +1,68 @@
+#include "CancellationToken.h"
+#include <map>
+#include <mutex>
+#include <thread>
+
+namespace
+{
+    std::mutex &TokenLock()
+    {
+        static std::mutex lock;
+        return lock;
+    }
+
+    std::map<std::thread::id, const xUnitpp::CancellationToken *> &Tokens()
+    {
+        static std::map<std::thread::id, const xUnitpp::CancellationToken *> tokens;
+        return tokens;
+    }
+}
+
+namespace xUnitpp
+{
+
+CancellationToken::CancellationToken()
+    : cancelled(false)
+{
+}
+
+void CancellationToken::Cancel()
+{
+    cancelled = true;
+}
+
+void CancellationToken::Reset()
+{
+    cancelled = false;
+}
+
+bool CancellationToken::IsCancellationRequested() const
+{
+    return cancelled;
+}
+
+const CancellationToken &CancellationToken::Current()
+{
+    static const CancellationToken never;
+
+    std::lock_guard<std::mutex> guard(TokenLock());
+
+    auto it = Tokens().find(std::this_thread::get_id());
+    return it == Tokens().end() ? never : *it->second;
+}
+
+void CancellationToken::Tie() const
+{
+    std::lock_guard<std::mutex> guard(TokenLock());
+
+    // replace, don't insert: threads may be reused for future tests
+    Tokens()[std::this_thread::get_id()] = this;
+}
+
+void CancellationToken::Untie() const
+{
+    std::lock_guard<std::mutex> guard(TokenLock());
+    Tokens().erase(std::this_thread::get_id());
+}
+
+}
@@ -1,51 +1,455 @@
 #include "TestCollection.h"
+#include <atomic>
 #include <cctype>
 #include <chrono>
+#include <iterator>
+#include <map>
 #include <memory>
 #include <string>
 #include <tuple>
 #include <vector>
 #include "ExportApi.h"
 #include "IOutput.h"
+#include "IThreadBudget.h"
+#include "TestDetails.h"
 #include "TestEventRecorder.h"
+#include "TestMetrics.h"
+#include "xUnitCheck.h"
+#include "xUnitLog.h"
 #include "xUnitTestRunner.h"
 #include "xUnitTime.h"
+#include "xUnitWarn.h"
+
+#if defined(__ELF__)
+// the linker defines these around the xunitpp_tests section of whichever library this is linked into
+// they are weak so that a library without any described tests still links
+extern "C" const xUnitpp::TestDescriptor *const __start_xunitpp_tests[] __attribute__((weak, visibility("hidden")));
+extern "C" const xUnitpp::TestDescriptor *const __stop_xunitpp_tests[] __attribute__((weak, visibility("hidden")));
+#endif
 
 namespace
 {
+    std::atomic<xUnitpp::IThreadBudget *> threadBudget(nullptr);
+
     extern "C" __declspec(dllexport) void EnumerateTestDetails(xUnitpp::EnumerateTestDetailsCallback callback)
     {
-        for (const auto &test : xUnitpp::TestCollection::Instance().Tests())
-        {
-            callback(test->TestDetails());
-        }
+        xUnitpp::TestCollection::Instance().EnumerateTestDetails(callback);
     }
 
     extern "C" __declspec(dllexport) int FilteredTestsRunner(int timeLimit, int threadLimit, xUnitpp::IOutput &testReporter, xUnitpp::TestFilterCallback filter)
     {
-        return xUnitpp::RunTests(testReporter, filter, xUnitpp::TestCollection::Instance().Tests(),
-            xUnitpp::Time::ToDuration(xUnitpp::Time::ToMilliseconds(timeLimit)), threadLimit);
+        return xUnitpp::RunTests(testReporter, filter, xUnitpp::TestCollection::Instance().FilteredTests(filter),
+            xUnitpp::Time::ToDuration(xUnitpp::Time::ToMilliseconds(timeLimit)), threadLimit, nullptr, threadBudget);
+    }
+
+    extern "C" __declspec(dllexport) int OrderedTestsRunner(int timeLimit, int threadLimit, xUnitpp::IOutput &testReporter, xUnitpp::TestFilterCallback filter,
+        xUnitpp::TestDurationCallback expectedDuration)
+    {
+        return xUnitpp::RunTests(testReporter, filter, xUnitpp::TestCollection::Instance().FilteredTests(filter),
+            xUnitpp::Time::ToDuration(xUnitpp::Time::ToMilliseconds(timeLimit)), threadLimit, expectedDuration, threadBudget);
+    }
+
+    extern "C" __declspec(dllexport) const xUnitpp::TestCatalog *GetTestCatalog()
+    {
+        return &xUnitpp::TestCollection::Instance().Catalog();
+    }
+
+    extern "C" __declspec(dllexport) void SetAllocationCounter(xUnitpp::IAllocationCounter *counter)
+    {
+        xUnitpp::TestMetrics::SetAllocationCounter(counter);
+    }
+
+    extern "C" __declspec(dllexport) void SetThreadBudget(xUnitpp::IThreadBudget *budget)
+    {
+        threadBudget = budget;
     }
 }
 
 namespace xUnitpp
 {
 
+// these live here, rather than in a file of their own, so that every library with a described test also links in the exports above
+const std::shared_ptr<TestEventRecorder> SharedEventRecorders[3] =
+{
+    /* check */ std::make_shared<TestEventRecorder>(),
+    /* warn  */ std::make_shared<TestEventRecorder>(),
+    /* log   */ std::make_shared<TestEventRecorder>(),
+};
+
+const Check SharedCheck(*SharedEventRecorders[0]);
+const Warn SharedWarn(*SharedEventRecorders[1]);
+const Log SharedLog(*SharedEventRecorders[2]);
+
+// A test described by the macros, and the tests built from it once they're wanted.
+// A fact's details are read straight from its descriptor, so listing and filtering facts builds nothing.
+class TestCollection::DescribedTest : public ITestDetails
+{
+public:
+    DescribedTest()
+        : built(false)
+        , descriptor(nullptr)
+        , id(0)
+    {
+    }
+
+    void Describe(const TestDescriptor &descriptor)
+    {
+        this->descriptor = &descriptor;
+
+        if (!IsTheory())
+        {
+            id = TestDetails::NewId();
+            attributes = descriptor.attributes();
+        }
+    }
+
+    bool IsTheory() const
+    {
+        return descriptor->theory != nullptr;
+    }
+
+    const TestDescriptor &Descriptor() const
+    {
+        return *descriptor;
+    }
+
+    virtual int __stdcall GetId() const override
+    {
+        return id;
+    }
+
+    virtual const char * __stdcall GetName() const override
+    {
+        return descriptor->name;
+    }
+
+    virtual const char * __stdcall GetFullName() const override
+    {
+        return descriptor->name;
+    }
+
+    virtual const char * __stdcall GetSuite() const override
+    {
+        return descriptor->suite().c_str();
+    }
+
+    virtual const char * __stdcall GetParams() const override
+    {
+        return "";
+    }
+
+    virtual int __stdcall GetTestInstance() const override
+    {
+        return 0;
+    }
+
+    virtual size_t __stdcall GetAttributeCount() const override
+    {
+        return attributes.size();
+    }
+
+    virtual const char * __stdcall GetAttributeKey(size_t index) const override
+    {
+        return attributes[index].first.c_str();
+    }
+
+    virtual const char * __stdcall GetAttributeValue(size_t index) const override
+    {
+        return attributes[index].second.c_str();
+    }
+
+    virtual void __stdcall FindAttributeKey(const char *key, size_t &begin, size_t &end) const override
+    {
+        auto range = attributes.find(AttributeCollection::Attribute(key, ""));
+
+        begin = std::distance(attributes.begin(), range.first);
+        end = std::distance(attributes.begin(), range.second);
+    }
+
+    virtual const char * __stdcall GetFile() const override
+    {
+        return descriptor->file;
+    }
+
+    virtual int __stdcall GetLine() const override
+    {
+        return descriptor->line;
+    }
+
+    std::vector<std::shared_ptr<xUnitTest>> tests;
+    bool built;
+
+private:
+    const TestDescriptor *descriptor;
+    int id;
+    AttributeCollection attributes;
+};
+
+// The storage behind a TestCatalog. Every string goes into one block; suites, files and attributes
+// repeat from test to test, so each of those is only stored once.
+class TestCollection::CatalogData
+{
+public:
+    CatalogData()
+        : strings(1, '\0')
+    {
+    }
+
+    void Add(const ITestDetails &testDetails)
+    {
+        TestCatalogEntry entry;
+        entry.id = testDetails.GetId();
+        entry.testInstance = testDetails.GetTestInstance();
+        entry.name = Append(testDetails.GetName());
+        entry.fullName = Same(testDetails.GetFullName(), testDetails.GetName()) ? entry.name : Append(testDetails.GetFullName());
+        entry.suite = Intern(testDetails.GetSuite());
+        entry.params = Append(testDetails.GetParams());
+        entry.file = Intern(testDetails.GetFile());
+        entry.line = testDetails.GetLine();
+        entry.firstAttribute = (unsigned int)attributes.size();
+        entry.attributeCount = (unsigned int)testDetails.GetAttributeCount();
+
+        // the details keep their attributes sorted by key, so the catalog's are as well
+        for (size_t i = 0; i != testDetails.GetAttributeCount(); ++i)
+        {
+            TestCatalogAttribute attribute;
+            attribute.key = Intern(testDetails.GetAttributeKey(i));
+            attribute.value = Intern(testDetails.GetAttributeValue(i));
+            attributes.push_back(attribute);
+        }
+
+        tests.push_back(entry);
+    }
+
+    void Finish()
+    {
+        interned.clear();
+
+        catalog.tests = tests.data();
+        catalog.testCount = tests.size();
+        catalog.attributes = attributes.data();
+        catalog.attributeCount = attributes.size();
+        catalog.strings = strings.data();
+        catalog.stringsSize = strings.size();
+    }
+
+    const TestCatalog &Catalog() const
+    {
+        return catalog;
+    }
+
+private:
+    static bool Same(const char *a, const char *b)
+    {
+        return a == b || (a != nullptr && b != nullptr && std::string(a) == b);
+    }
+
+    unsigned int Append(const char *s)
+    {
+        if (s == nullptr || *s == '\0')
+        {
+            return 0;
+        }
+
+        auto offset = (unsigned int)strings.size();
+        strings.append(s);
+        strings.push_back('\0');
+        return offset;
+    }
+
+    unsigned int Intern(const char *s)
+    {
+        if (s == nullptr || *s == '\0')
+        {
+            return 0;
+        }
+
+        auto it = interned.find(s);
+        if (it != interned.end())
+        {
+            return it->second;
+        }
+
+        auto offset = Append(s);
+        interned.insert(std::make_pair(std::string(s), offset));
+        return offset;
+    }
+
+private:
+    std::vector<TestCatalogEntry> tests;
+    std::vector<TestCatalogAttribute> attributes;
+    std::string strings;
+    std::map<std::string, unsigned int> interned;
+    TestCatalog catalog;
+};
+
+TestCollection::TestCollection()
+    : mDescribedCount(0)
+    , mAllBuilt(false)
+{
+}
+
+TestCollection::~TestCollection()
+{
+}
+
 TestCollection &TestCollection::Instance()
 {
     static TestCollection collection;
+
+#if defined(__ELF__)
+    // nothing is read from the section until the first time the collection is used
+    static std::once_flag described;
+    std::call_once(described, []() { collection.Describe(__start_xunitpp_tests, __stop_xunitpp_tests); });
+#endif
+
     return collection;
 }
 
-TestCollection::Register::Register(TestCollection &collection, std::function<void()> &&fn, std::string &&name, const std::string &suite,
-            AttributeCollection &&attributes, int milliseconds, std::string &&filename, int line, std::vector<std::shared_ptr<TestEventRecorder>> &&testEventRecorders)
+void TestCollection::Describe(const TestDescriptor *const *begin, const TestDescriptor *const *end)
 {
-    collection.mTests.push_back(std::make_shared<xUnitTest>(std::move(fn), std::move(name), 0, "", suite, std::move(attributes), Time::ToDuration(Time::ToMilliseconds(milliseconds)), std::move(filename), line, std::move(testEventRecorders)));
+    std::lock_guard<std::mutex> guard(mBuildLock);
+
+    mDescribed.reset(new DescribedTest[end - begin]);
+    mDescribedCount = 0;
+    mAllBuilt = false;
+    mCatalog.reset();
+
+    for (auto it = begin; it != end; ++it)
+    {
+        if (*it != nullptr)
+        {
+            mDescribed[mDescribedCount++].Describe(**it);
+        }
+    }
+}
+
+void TestCollection::EnumerateTestDetails(const EnumerateTestDetailsCallback &callback)
+{
+    std::lock_guard<std::mutex> guard(mBuildLock);
+
+    Enumerate(callback);
+}
+
+void TestCollection::Enumerate(const EnumerateTestDetailsCallback &callback)
+{
+    for (const auto &test : mTests)
+    {
+        callback(test->TestDetails());
+    }
+
+    for (size_t i = 0; i != mDescribedCount; ++i)
+    {
+        auto &described = mDescribed[i];
+
+        if (described.IsTheory())
+        {
+            for (const auto &test : Build(described))
+            {
+                callback(test->TestDetails());
+            }
+        }
+        else
+        {
+            callback(described);
+        }
+    }
+}
+
+std::vector<std::shared_ptr<xUnitTest>> TestCollection::FilteredTests(const TestFilterCallback &filter)
+{
+    std::lock_guard<std::mutex> guard(mBuildLock);
+
+    std::vector<std::shared_ptr<xUnitTest>> tests(mTests);
+
+    for (size_t i = 0; i != mDescribedCount; ++i)
+    {
+        auto &described = mDescribed[i];
+
+        // a built fact has the same details as its descriptor, so the filter gives the same answer for both
+        if (described.IsTheory() || filter(described))
+        {
+            const auto &built = Build(described);
+            tests.insert(tests.end(), built.begin(), built.end());
+        }
+    }
+
+    return tests;
 }
 
 const std::vector<std::shared_ptr<xUnitTest>> &TestCollection::Tests()
 {
-    return mTests;
+    std::lock_guard<std::mutex> guard(mBuildLock);
+
+    if (mDescribedCount == 0)
+    {
+        return mTests;
+    }
+
+    // built once, and never changed after, since tests may be reading it while others are running
+    if (!mAllBuilt)
+    {
+        mAllTests = mTests;
+
+        for (size_t i = 0; i != mDescribedCount; ++i)
+        {
+            const auto &built = Build(mDescribed[i]);
+            mAllTests.insert(mAllTests.end(), built.begin(), built.end());
+        }
+
+        mAllBuilt = true;
+    }
+
+    return mAllTests;
+}
+
+const TestCatalog &TestCollection::Catalog()
+{
+    std::lock_guard<std::mutex> guard(mBuildLock);
+
+    // like Tests(), never changed once made: the runner holds on to it for as long as the library is loaded
+    if (!mCatalog)
+    {
+        std::unique_ptr<CatalogData> catalog(new CatalogData());
+        Enumerate([&](const ITestDetails &testDetails) { catalog->Add(testDetails); });
+        catalog->Finish();
+
+        mCatalog = std::move(catalog);
+    }
+
+    return mCatalog->Catalog();
+}
+
+const std::vector<std::shared_ptr<xUnitTest>> &TestCollection::Build(DescribedTest &described)
+{
+    if (!described.built)
+    {
+        const auto &descriptor = described.Descriptor();
+
+        if (described.IsTheory())
+        {
+            descriptor.theory(descriptor, described.tests);
+        }
+        else
+        {
+            xUnitpp::TestDetails testDetails(std::string(descriptor.name), 0, std::string(), descriptor.suite(), descriptor.attributes(),
+                Time::ToDuration(Time::ToMilliseconds(descriptor.milliseconds)), std::string(descriptor.file), descriptor.line);
+            testDetails.Id = described.GetId();
+
+            described.tests.push_back(std::make_shared<xUnitTest>(std::function<void()>(descriptor.test), std::move(testDetails),
+                std::vector<std::shared_ptr<TestEventRecorder>>(descriptor.eventRecorders, descriptor.eventRecorders + 3)));
+        }
+
+        described.built = true;
+    }
+
+    return described.tests;
+}
+
+TestCollection::Register::Register(TestCollection &collection, std::function<void()> &&fn, std::string &&name, const std::string &suite,
+            AttributeCollection &&attributes, int milliseconds, std::string &&filename, int line, std::vector<std::shared_ptr<TestEventRecorder>> &&testEventRecorders)
+{
+    collection.mTests.push_back(std::make_shared<xUnitTest>(std::move(fn), std::move(name), 0, "", suite, std::move(attributes), Time::ToDuration(Time::ToMilliseconds(milliseconds)), std::move(filename), line, std::move(testEventRecorders)));
 }
 
 std::deque<std::string> TestCollection::Register::SplitParams(std::string &&params)
@@ -43,6 +43,11 @@ TestDetails::TestDetails(std::string &&name, int testInstance, std::string &&par
 {
 }
 
+int TestDetails::NewId()
+{
+    return NextId();
+}
+
 int __stdcall TestDetails::GetId() const
 {
     return Id;
@@ -93,7 +98,7 @@ void __stdcall TestDetails::FindAttributeKey(const char *key, size_t &begin, siz
     auto range = Attributes.find(AttributeCollection::Attribute(key, ""));
 
     begin = std::distance(Attributes.begin(), range.first);
-    end = std::distance(Attributes.end(), range.second);
+    end = std::distance(Attributes.begin(), range.second);
 }
 
 const char * __stdcall TestDetails::GetFile() const 
@@ -1,5 +1,6 @@
 #include "TestEvent.h"
 #include "EventLevel.h"
+#include "xUnitBenchmark.h"
 #include "xUnitAssert.h"
 
 namespace xUnitpp
@@ -82,6 +83,14 @@ TestEvent::TestEvent(const std::exception &e)
 {
 }
 
+TestEvent::TestEvent(const BenchmarkResult &benchmark)
+    : level(EventLevel::Info)
+    , assert(xUnitAssert::None())
+    , message(to_string(benchmark))
+    , benchmark(std::make_shared<BenchmarkResult>(benchmark))
+{
+}
+
 bool TestEvent::GetIsFailure() const
 {
     return level > EventLevel::Warning;
@@ -142,6 +151,11 @@ const xUnitpp::LineInfo &TestEvent::LineInfo() const
     return lineInfo;
 }
 
+const BenchmarkResult *TestEvent::Benchmark() const
+{
+    return benchmark.get();
+}
+
 const char *TestEvent::GetCall() const 
 {
     return assert.Call().c_str();
@@ -1,9 +1,55 @@
 #include "TestEventRecorder.h"
+#include <utility>
+#include <vector>
 #include "TestEvent.h"
 
+#if !defined(WIN32)
+namespace
+{
+    typedef std::function<void(xUnitpp::TestEvent &&)> Sink;
+
+    // a thread runs one test at a time, so it only ever has a sink for a few recorders
+    thread_local std::vector<std::pair<const xUnitpp::TestEventRecorder *, Sink>> threadSinks;
+}
+#endif
+
 namespace xUnitpp
 {
 
+#if !defined(WIN32)
+
+void TestEventRecorder::Tie(std::function<void(TestEvent &&)> sink)
+{
+    // replace, don't insert: threads may be reused for future tests
+    for (auto &entry : threadSinks)
+    {
+        if (entry.first == this)
+        {
+            entry.second = std::move(sink);
+            return;
+        }
+    }
+
+    threadSinks.push_back(std::make_pair(this, std::move(sink)));
+}
+
+void TestEventRecorder::operator()(TestEvent &&evt) const
+{
+    for (const auto &entry : threadSinks)
+    {
+        if (entry.first == this)
+        {
+            entry.second(std::move(evt));
+            return;
+        }
+    }
+
+    // an event from a thread that isn't running a test
+    throw std::bad_function_call();
+}
+
+#else
+
 void TestEventRecorder::Tie(std::function<void(TestEvent &&)> sink)
 {
     std::lock_guard<std::mutex> guard(lock);
@@ -14,8 +60,17 @@ void TestEventRecorder::Tie(std::function<void(TestEvent &&)> sink)
 
 void TestEventRecorder::operator()(TestEvent &&evt) const
 {
-    std::lock_guard<std::mutex> guard(lock);
-    sinks[std::this_thread::get_id()](std::move(evt));
+    const std::function<void(TestEvent &&)> *sink;
+
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        sink = &sinks[std::this_thread::get_id()];
+    }
+
+    // only this thread ever ties its own sink, so it can't change underneath us
+    (*sink)(std::move(evt));
 }
 
+#endif
+
 }
@@ -0,0 +1,121 @@
+#include "TestMetrics.h"
+#include <atomic>
+#include "IAllocationCounter.h"
+
+#if defined(__linux__)
+#include <sys/resource.h>
+#include <time.h>
+#endif
+
+namespace
+{
+    std::atomic<xUnitpp::IAllocationCounter *> allocationCounter(nullptr);
+}
+
+namespace xUnitpp
+{
+
+ThreadUsage::ThreadUsage()
+    : measured(false)
+    , cpuNs(0)
+    , userNs(0)
+    , systemNs(0)
+    , voluntaryContextSwitches(0)
+    , involuntaryContextSwitches(0)
+    , minorPageFaults(0)
+    , majorPageFaults(0)
+{
+}
+
+ThreadUsage ThreadUsage::Now()
+{
+    ThreadUsage usage;
+
+#if defined(__linux__)
+    rusage ru;
+    timespec cpu;
+
+    if (getrusage(RUSAGE_THREAD, &ru) == 0 && clock_gettime(CLOCK_THREAD_CPUTIME_ID, &cpu) == 0)
+    {
+        usage.measured = true;
+
+        // the rusage times are only as fine as the scheduler's accounting; the thread clock is exact
+        usage.cpuNs = cpu.tv_sec * 1000000000LL + cpu.tv_nsec;
+        usage.userNs = ru.ru_utime.tv_sec * 1000000000LL + ru.ru_utime.tv_usec * 1000LL;
+        usage.systemNs = ru.ru_stime.tv_sec * 1000000000LL + ru.ru_stime.tv_usec * 1000LL;
+        usage.voluntaryContextSwitches = ru.ru_nvcsw;
+        usage.involuntaryContextSwitches = ru.ru_nivcsw;
+        usage.minorPageFaults = ru.ru_minflt;
+        usage.majorPageFaults = ru.ru_majflt;
+    }
+#endif
+
+    return usage;
+}
+
+void TestMetrics::Add(const std::string &name, long long value)
+{
+    metrics.push_back(std::make_pair(name, value));
+}
+
+void TestMetrics::AddAllocations(const AllocationTotals &before, const AllocationTotals &after)
+{
+    auto allocatedBytes = after.allocatedBytes - before.allocatedBytes;
+    auto freedBytes = after.freedBytes - before.freedBytes;
+
+    Add("Allocations", after.allocations - before.allocations);
+    Add("AllocatedBytes", allocatedBytes);
+    Add("Frees", after.frees - before.frees);
+    Add("FreedBytes", freedBytes);
+    // the peak is of everything live on the thread, including what it held before the test started
+    Add("PeakLiveBytes", after.peakLiveBytes - (before.allocatedBytes - before.freedBytes));
+
+    // memory handed to another thread and freed there looks leaked from here
+    Add("LeakedBytes", allocatedBytes > freedBytes ? allocatedBytes - freedBytes : 0);
+}
+
+void TestMetrics::AddThreadUsage(const ThreadUsage &before, const ThreadUsage &after)
+{
+    if (before.measured && after.measured)
+    {
+        Add("CpuTimeNs", after.cpuNs - before.cpuNs);
+        Add("UserTimeNs", after.userNs - before.userNs);
+        Add("SystemTimeNs", after.systemNs - before.systemNs);
+        Add("VoluntaryContextSwitches", after.voluntaryContextSwitches - before.voluntaryContextSwitches);
+        Add("InvoluntaryContextSwitches", after.involuntaryContextSwitches - before.involuntaryContextSwitches);
+        Add("MinorPageFaults", after.minorPageFaults - before.minorPageFaults);
+        Add("MajorPageFaults", after.majorPageFaults - before.majorPageFaults);
+    }
+}
+
+bool TestMetrics::empty() const
+{
+    return metrics.empty();
+}
+
+size_t TestMetrics::GetCount() const
+{
+    return metrics.size();
+}
+
+const char *TestMetrics::GetName(size_t index) const
+{
+    return metrics[index].first.c_str();
+}
+
+long long TestMetrics::GetValue(size_t index) const
+{
+    return metrics[index].second;
+}
+
+void TestMetrics::SetAllocationCounter(IAllocationCounter *counter)
+{
+    allocationCounter = counter;
+}
+
+IAllocationCounter *TestMetrics::GetAllocationCounter()
+{
+    return allocationCounter;
+}
+
+}
@@ -0,0 +1,70 @@
+#include "TimeBudget.h"
+#include <algorithm>
+#include <stdexcept>
+#include "LineInfo.h"
+#include "xUnitAssert.h"
+
+namespace xUnitpp
+{
+
+TimeBudget::TimeBudget(Time::Duration budget, size_t repetitions)
+    : budget(budget)
+    , repetitions(repetitions)
+    , within(0)
+{
+    if (repetitions == 0)
+    {
+        throw std::invalid_argument("A time budget needs at least one repetition.");
+    }
+
+    samples.reserve(repetitions);
+}
+
+bool TimeBudget::NeedsSample() const
+{
+    // the median is the upper middle sample, so it is within budget once more than half of all the runs are
+    auto needed = repetitions / 2 + 1;
+    return samples.size() != repetitions && within < needed && samples.size() - within <= repetitions - needed;
+}
+
+void TimeBudget::Add(Time::Duration sample)
+{
+    samples.push_back(sample);
+
+    if (sample <= budget)
+    {
+        ++within;
+    }
+}
+
+bool TimeBudget::Met() const
+{
+    return within >= repetitions / 2 + 1;
+}
+
+Time::Duration TimeBudget::Median() const
+{
+    auto sorted = samples;
+    std::sort(sorted.begin(), sorted.end());
+
+    return sorted.empty() ? Time::Duration::zero() : sorted[sorted.size() / 2];
+}
+
+xUnitAssert TimeBudget::Failure(std::string &&call, LineInfo &&lineInfo) const
+{
+    auto sorted = samples;
+    std::sort(sorted.begin(), sorted.end());
+
+    std::string distribution;
+    for (auto sample : sorted)
+    {
+        distribution += (distribution.empty() ? "" : ", ") + Time::to_string(sample);
+    }
+
+    return std::move(xUnitAssert(std::move(call), std::move(lineInfo))
+        .CustomMessage("Median of " + ToString(samples.size()) + " runs is over budget.")
+        .Expected("median <= " + Time::to_string(budget))
+        .Actual("median " + Time::to_string(Median()) + " of [ " + distribution + " ]"));
+}
+
+}
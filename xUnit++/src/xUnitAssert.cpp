@@ -12,7 +12,6 @@ xUnitAssert xUnitAssert::None()
 xUnitAssert::xUnitAssert(std::string &&call, xUnitpp::LineInfo &&lineInfo)
     : lineInfo(std::move(lineInfo))
     , call(std::move(call))
-    , userMessage(std::make_shared<std::stringstream>())
 {
 }
 
@@ -41,7 +40,11 @@ const std::string &xUnitAssert::Call() const
 
 const std::string &xUnitAssert::UserMessage() const
 {
-    userMessageString = userMessage->str();
+    if (userMessage)
+    {
+        userMessageString = userMessage->str();
+    }
+
     return userMessageString;
 }
 
@@ -66,16 +69,15 @@ const LineInfo &xUnitAssert::LineInfo() const
 }
 
 xUnitFailure::xUnitFailure()
-    : OnFailureComplete([](const xUnitAssert &){})
-    , assert(xUnitAssert::None())
-    , refCount(*(new int(0)))
+    : assert(xUnitAssert::None())
+    , refCount(nullptr)
 {
 }
 
 xUnitFailure::xUnitFailure(xUnitAssert &&assert, std::function<void(const xUnitAssert &)> onFailureComplete)
     : OnFailureComplete(onFailureComplete)
     , assert(std::move(assert))
-    , refCount(*(new int(1)))
+    , refCount(new int(1))
 {
 }
 
@@ -84,14 +86,25 @@ xUnitFailure::xUnitFailure(const xUnitFailure &other)
     , assert(other.assert)
     , refCount(other.refCount)
 {
-    refCount++;
+    if (refCount != nullptr)
+    {
+        ++*refCount;
+    }
+}
+
+xUnitFailure::xUnitFailure(xUnitFailure &&other)
+    : OnFailureComplete(std::move(other.OnFailureComplete))
+    , assert(std::move(other.assert))
+    , refCount(other.refCount)
+{
+    other.refCount = nullptr;
 }
 
 xUnitFailure::~xUnitFailure() noexcept(false)
 {
-    if (!--refCount)
+    if (refCount != nullptr && !--*refCount)
     {
-        delete &refCount;
+        delete refCount;
 
         // http://cpp-next.com/archive/2012/08/evil-or-just-misunderstood/
         // http://akrzemi1.wordpress.com/2011/09/21/destructors-that-throw/
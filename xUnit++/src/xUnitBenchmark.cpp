@@ -0,0 +1,142 @@
+#include "xUnitBenchmark.h"
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <sstream>
+#include "CancellationToken.h"
+#include "TestEvent.h"
+#include "TestEventRecorder.h"
+#include "xUnitTime.h"
+
+namespace
+{
+    const auto WarmupTime = std::chrono::milliseconds(20);
+    const auto SampleTime = std::chrono::milliseconds(20);
+    const int SampleCount = 10;
+
+    xUnitpp::Time::Duration TimeCalls(const std::function<void()> &body, long long iterations)
+    {
+        auto start = xUnitpp::Time::Clock::now();
+
+        for (long long i = 0; i != iterations; ++i)
+        {
+            body();
+        }
+
+        return xUnitpp::Time::ToDuration(xUnitpp::Time::Clock::now() - start);
+    }
+}
+
+namespace xUnitpp
+{
+
+BenchmarkResult::BenchmarkResult(long long iterations, std::vector<double> &&samples)
+    : iterations(iterations)
+    , samples(std::move(samples))
+    , mean(0)
+    , standardDeviation(0)
+    , min(0)
+    , max(0)
+{
+    if (!this->samples.empty())
+    {
+        auto count = (double)this->samples.size();
+
+        mean = std::accumulate(this->samples.begin(), this->samples.end(), 0.0) / count;
+
+        double variance = 0;
+        for (auto sample : this->samples)
+        {
+            variance += (sample - mean) * (sample - mean);
+        }
+
+        standardDeviation = std::sqrt(variance / count);
+
+        auto range = std::minmax_element(this->samples.begin(), this->samples.end());
+        min = *range.first;
+        max = *range.second;
+    }
+}
+
+long long BenchmarkResult::GetIterations() const
+{
+    return iterations;
+}
+
+size_t BenchmarkResult::GetSampleCount() const
+{
+    return samples.size();
+}
+
+double BenchmarkResult::GetSample(size_t index) const
+{
+    return samples[index];
+}
+
+double BenchmarkResult::GetMean() const
+{
+    return mean;
+}
+
+double BenchmarkResult::GetStandardDeviation() const
+{
+    return standardDeviation;
+}
+
+double BenchmarkResult::GetMin() const
+{
+    return min;
+}
+
+double BenchmarkResult::GetMax() const
+{
+    return max;
+}
+
+std::string to_string(const BenchmarkResult &result)
+{
+    std::ostringstream message;
+    message.precision(4);
+
+    message << result.mean << " ns/op (standard deviation " << result.standardDeviation
+        << ", min " << result.min << ", max " << result.max << "; "
+        << result.samples.size() << " samples of " << result.iterations << " calls)";
+
+    return message.str();
+}
+
+void RunBenchmark(const std::function<void()> &body, const TestEventRecorder &recorder)
+{
+    const auto &cancellation = CancellationToken::Current();
+
+    // keep doubling the calls until they take long enough to time reliably, which also warms up caches and branch predictors
+    long long iterations = 1;
+    auto time = TimeCalls(body, iterations);
+
+    while (time < WarmupTime && !cancellation.IsCancellationRequested())
+    {
+        iterations *= 2;
+        time = TimeCalls(body, iterations);
+    }
+
+    // then scale to fill a sample
+    auto scale = (double)Time::ToDuration(SampleTime).count() / std::max((double)time.count(), 1.0);
+    iterations = std::max(1LL, (long long)(iterations * scale));
+
+    std::vector<double> samples;
+    for (int i = 0; i != SampleCount && !cancellation.IsCancellationRequested(); ++i)
+    {
+        samples.push_back((double)TimeCalls(body, iterations).count() / iterations);
+    }
+
+    recorder(TestEvent(BenchmarkResult(iterations, std::move(samples))));
+}
+
+AttributeCollection BenchmarkAttributes(AttributeCollection &&attributes)
+{
+    attributes.insert(AttributeCollection::Attribute("Benchmark", ""));
+    attributes.sort();
+    return std::move(attributes);
+}
+
+}
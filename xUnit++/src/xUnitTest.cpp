@@ -1,8 +1,35 @@
 #include "xUnitTest.h"
+#include <sstream>
 #include "EventLevel.h"
+#include "IAllocationCounter.h"
 #include "TestEventRecorder.h"
+#include "TimeBudget.h"
 #include "xUnitAssert.h"
 
+namespace
+{
+    // runs of a test that comes in over its TimeBudget, not counting the first one
+    const size_t TimeBudgetRepetitions = 5;
+
+    xUnitpp::Time::Duration TimeBudgetAttribute(const xUnitpp::TestDetails &testDetails)
+    {
+        auto range = testDetails.Attributes.find(xUnitpp::AttributeCollection::Attribute("TimeBudget", ""));
+
+        if (range.first != range.second)
+        {
+            std::istringstream stream(range.first->second);
+
+            double ms;
+            if (stream >> ms && ms > 0)
+            {
+                return xUnitpp::Time::ToDuration(std::chrono::duration<double, std::milli>(ms));
+            }
+        }
+
+        return xUnitpp::Time::Duration::zero();
+    }
+}
+
 namespace xUnitpp
 {
 
@@ -16,11 +43,25 @@ xUnitTest::xUnitTest(std::function<void()> &&test, std::string &&name, int testI
 {
 }
 
+xUnitTest::xUnitTest(std::function<void()> &&test, xUnitpp::TestDetails &&testDetails,
+                     const std::vector<std::shared_ptr<TestEventRecorder>> &testEventRecorders)
+    : test(std::move(test))
+    , testDetails(std::move(testDetails))
+    , testEventRecorders(testEventRecorders)
+    , failureEventLogged(false)
+{
+}
+
 const TestDetails &xUnitTest::TestDetails() const
 {
     return testDetails;
 }
 
+CancellationToken &xUnitTest::Cancellation()
+{
+    return cancellation;
+}
+
 TestResult xUnitTest::Run()
 {
     for (auto &recorder : testEventRecorders)
@@ -28,8 +69,55 @@ TestResult xUnitTest::Run()
         recorder->Tie([&](TestEvent &&evt) { AddEvent(std::move(evt)); });
     }
 
+    cancellation.Tie();
+
+    metrics = TestMetrics();
+
+    auto allocationCounter = TestMetrics::GetAllocationCounter();
+    AllocationTotals allocationsBefore = {};
+
+    if (allocationCounter != nullptr)
+    {
+        allocationCounter->GetThreadTotals(allocationsBefore);
+        allocationCounter->ResetPeak();
+    }
+
+    auto usageBefore = ThreadUsage::Now();
+
     testStart = Time::Clock::now();
+    RunOnce();
+    testStop = Time::Clock::now();
+
+    auto usageAfter = ThreadUsage::Now();
+    AllocationTotals allocationsAfter = {};
+
+    // both snapshots are taken before any metrics are added, since adding them allocates
+    if (allocationCounter != nullptr)
+    {
+        allocationCounter->GetThreadTotals(allocationsAfter);
+    }
 
+    metrics.AddThreadUsage(usageBefore, usageAfter);
+
+    if (allocationCounter != nullptr)
+    {
+        metrics.AddAllocations(allocationsBefore, allocationsAfter);
+    }
+
+    auto budget = TimeBudgetAttribute(testDetails);
+
+    if (budget > Time::Duration::zero() && !failureEventLogged && Duration() > budget)
+    {
+        CheckTimeBudget(budget);
+    }
+
+    cancellation.Untie();
+
+    return failureEventLogged ? TestResult::Failure : TestResult::Success;
+}
+
+void xUnitTest::RunOnce()
+{
     try
     {
         test();
@@ -46,10 +134,37 @@ TestResult xUnitTest::Run()
     {
         AddEvent(TestEvent(EventLevel::Fatal, "Unknown exception caught: test has crashed."));
     }
+}
 
-    testStop = Time::Clock::now();
+void xUnitTest::CheckTimeBudget(Time::Duration budget)
+{
+    // a single slow run is as likely to be a cold cache or a busy machine as a slow test, so the first run
+    // counts as a warm up and the test is run again until the median settles
+    // only failures from the repeat runs are kept: everything else would just repeat the first run's events
+    for (auto &recorder : testEventRecorders)
+    {
+        recorder->Tie([&](TestEvent &&evt)
+            {
+                if (evt.GetIsFailure())
+                {
+                    AddEvent(std::move(evt));
+                }
+            });
+    }
 
-    return failureEventLogged ? TestResult::Failure : TestResult::Success;
+    TimeBudget timeBudget(budget, TimeBudgetRepetitions);
+
+    while (timeBudget.NeedsSample() && !failureEventLogged && !cancellation.IsCancellationRequested())
+    {
+        auto start = Time::Clock::now();
+        RunOnce();
+        timeBudget.Add(Time::ToDuration(Time::Clock::now() - start));
+    }
+
+    if (!failureEventLogged && !timeBudget.NeedsSample() && !timeBudget.Met())
+    {
+        AddEvent(TestEvent(EventLevel::Assert, timeBudget.Failure("TimeBudget", xUnitpp::LineInfo(testDetails.LineInfo))));
+    }
 }
 
 Time::Duration xUnitTest::Duration() const
@@ -74,4 +189,9 @@ const std::vector<TestEvent> &xUnitTest::TestEvents() const
     return testEvents;
 }
 
+const TestMetrics &xUnitTest::Metrics() const
+{
+    return metrics;
+}
+
 }
@@ -1,57 +1,109 @@
 #include "xUnitTestRunner.h"
+#include <algorithm>
 #include <atomic>
 #include <chrono>
-#include <future>
-#include <limits>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <map>
+#include <memory>
 #include <mutex>
+#include <queue>
 #include <random>
+#include <sstream>
 #include <stdexcept>
+#include <string>
+#include <thread>
+#include <utility>
 #include <vector>
 #include "EventLevel.h"
 #include "ExportApi.h"
 #include "IOutput.h"
+#include "IThreadBudget.h"
 #include "TestCollection.h"
 #include "TestDetails.h"
+#include "TestMetrics.h"
+#include "xUnitBenchmark.h"
 #include "xUnitAssert.h"
 #include "xUnitTime.h"
 
 namespace
 {
 
+//
+// Workers hand snapshots of their reports to a single reporter thread through a bounded queue,
+// so a slow reporter (a terminal, say) only holds up the tests once the queue has filled up.
+// Test details are not copied: they belong to tests that outlive the run.
 class SharedOutput
 {
+    typedef std::function<void(xUnitpp::IOutput &)> Report;
+
 public:
+    static const size_t Capacity = 1024;
+
     SharedOutput(xUnitpp::IOutput &testReporter)
         : mOutput(testReporter)
+        , mStopping(false)
+    {
+        mReporter = std::thread([this]() { Drain(); });
+    }
+
+    ~SharedOutput()
     {
+        Stop();
     }
 
     void ReportStart(const xUnitpp::TestDetails &details)
     {
-        std::lock_guard<std::mutex> guard(mLock);
-        mOutput.get().ReportStart(details);
+        Enqueue([&details](xUnitpp::IOutput &output) { output.ReportStart(details); });
     }
 
     void ReportEvent(const xUnitpp::TestDetails &details, const xUnitpp::TestEvent &evt)
     {
-        std::lock_guard<std::mutex> guard(mLock);
-        mOutput.get().ReportEvent(details, evt);
+        Enqueue([&details, evt](xUnitpp::IOutput &output)
+            {
+                if (evt.Benchmark() != nullptr)
+                {
+                    output.ReportBenchmark(details, *evt.Benchmark());
+                }
+                else
+                {
+                    output.ReportEvent(details, evt);
+                }
+            });
+    }
+
+    void ReportMetrics(const xUnitpp::TestDetails &details, const xUnitpp::TestMetrics &metrics)
+    {
+        Enqueue([&details, metrics](xUnitpp::IOutput &output) { output.ReportMetrics(details, metrics); });
     }
 
     void ReportSkip(const xUnitpp::TestDetails &details, const std::string &reason)
     {
-        std::lock_guard<std::mutex> guard(mLock);
-        mOutput.get().ReportSkip(details, reason.c_str());
+        Enqueue([&details, reason](xUnitpp::IOutput &output) { output.ReportSkip(details, reason.c_str()); });
     }
 
     void ReportFinish(const xUnitpp::TestDetails &details, xUnitpp::Time::Duration time)
     {
-        std::lock_guard<std::mutex> guard(mLock);
-        mOutput.get().ReportFinish(details, time.count());
+        Enqueue([&details, time](xUnitpp::IOutput &output) { output.ReportFinish(details, time.count()); });
+    }
+
+    // delivers everything still queued, then rethrows the first exception thrown by the reporter, if any
+    void Flush()
+    {
+        Stop();
+
+        if (mError)
+        {
+            std::rethrow_exception(mError);
+        }
     }
 
     void ReportAllTestsComplete(size_t total, size_t skipped, size_t failed, xUnitpp::Time::Duration totalTime)
     {
+        Flush();
+
         mOutput.get().ReportAllTestsComplete(total, skipped, failed, totalTime.count());
     }
 
@@ -59,9 +111,85 @@ private:
     SharedOutput(const SharedOutput &);
     SharedOutput &operator =(SharedOutput);
 
+    void Enqueue(Report &&report)
+    {
+        {
+            std::unique_lock<std::mutex> guard(mLock);
+            mNotFull.wait(guard, [&]() { return mReports.size() < Capacity; });
+
+            mReports.push_back(std::move(report));
+        }
+
+        mNotEmpty.notify_one();
+    }
+
+    void Stop()
+    {
+        {
+            std::lock_guard<std::mutex> guard(mLock);
+            mStopping = true;
+        }
+
+        mNotEmpty.notify_one();
+
+        if (mReporter.joinable())
+        {
+            mReporter.join();
+        }
+    }
+
+    void Drain()
+    {
+        std::deque<Report> reports;
+
+        for (;;)
+        {
+            {
+                std::unique_lock<std::mutex> guard(mLock);
+                mNotEmpty.wait(guard, [&]() { return mStopping || !mReports.empty(); });
+
+                if (mReports.empty())
+                {
+                    return;
+                }
+
+                // take everything at once: producers only ever wait for the time it takes to swap
+                reports.swap(mReports);
+            }
+
+            mNotFull.notify_all();
+
+            for (auto &report : reports)
+            {
+                // once the reporter has failed, nothing more is sent its way
+                if (!mError)
+                {
+                    try
+                    {
+                        report(mOutput.get());
+                    }
+                    catch (...)
+                    {
+                        mError = std::current_exception();
+                    }
+                }
+            }
+
+            reports.clear();
+        }
+    }
+
 private:
-    std::mutex mLock;
     std::reference_wrapper<xUnitpp::IOutput> mOutput;
+
+    std::mutex mLock;
+    std::condition_variable mNotEmpty;
+    std::condition_variable mNotFull;
+    std::deque<Report> mReports;
+    bool mStopping;
+
+    std::exception_ptr mError;
+    std::thread mReporter;
 };
 
 class AttachedOutput
@@ -69,6 +197,7 @@ class AttachedOutput
 public:
     AttachedOutput(SharedOutput &output)
         : mAttached(true)
+        , mFinished(false)
         , mOutput(std::ref(output))
     {
     }
@@ -99,6 +228,16 @@ public:
         }
     }
 
+    void ReportMetrics(const xUnitpp::TestDetails &details, const xUnitpp::TestMetrics &metrics)
+    {
+        std::lock_guard<std::mutex> guard(mLock);
+
+        if (mAttached)
+        {
+            mOutput.get().ReportMetrics(details, metrics);
+        }
+    }
+
     void ReportSkip(const xUnitpp::TestDetails &details, const std::string &reason)
     {
         std::lock_guard<std::mutex> guard(mLock);
@@ -116,9 +255,16 @@ public:
         if (mAttached)
         {
             mOutput.get().ReportFinish(details, time);
+            mFinished = true;
         }
     }
 
+    bool HasFinished()
+    {
+        std::lock_guard<std::mutex> guard(mLock);
+        return mFinished;
+    }
+
     void ReportAllTestsComplete(size_t, size_t, size_t, xUnitpp::Time::Duration)
     {
         throw std::logic_error("No one holding an AttachedOutput object should be calling ReportAllTestsComplete.");
@@ -131,52 +277,466 @@ private:
 private:
     std::mutex mLock;
     bool mAttached;
+    bool mFinished;
     std::reference_wrapper<SharedOutput> mOutput;
 };
 
-}
+//
+// Each worker owns a deque of tests, usually seeded with whole suites so that tests sharing data tend to share a thread.
+// A worker takes from the front of its own deque, and once that runs dry it steals from the back of someone else's.
+class TestScheduler
+{
+    struct WorkQueue
+    {
+        std::mutex lock;
+        std::deque<std::shared_ptr<xUnitpp::xUnitTest>> tests;
+    };
 
-namespace xUnitpp
+public:
+    TestScheduler(size_t workerCount)
+        : queues(workerCount)
+        , testCount(0)
+    {
+        for (auto &queue : queues)
+        {
+            queue.reset(new WorkQueue);
+        }
+    }
+
+    void SeedBySuite(const std::vector<std::shared_ptr<xUnitpp::xUnitTest>> &tests)
+    {
+        testCount += tests.size();
+
+        // keep the (shuffled) order of suites and of the tests within each suite
+        std::vector<std::string> suiteOrder;
+        std::map<std::string, std::vector<std::shared_ptr<xUnitpp::xUnitTest>>> suites;
+
+        for (const auto &test : tests)
+        {
+            auto &suite = suites[test->TestDetails().Suite];
+
+            if (suite.empty())
+            {
+                suiteOrder.push_back(test->TestDetails().Suite);
+            }
+
+            suite.push_back(test);
+        }
+
+        for (const auto &name : suiteOrder)
+        {
+            auto &queue = *std::min_element(queues.begin(), queues.end(),
+                [](const std::unique_ptr<WorkQueue> &a, const std::unique_ptr<WorkQueue> &b) { return a->tests.size() < b->tests.size(); });
+
+            const auto &suite = suites[name];
+            queue->tests.insert(queue->tests.end(), suite.begin(), suite.end());
+        }
+    }
+
+    // deal the tests out round-robin, so every worker starts on the front of the list and works its way towards the back
+    void SeedInOrder(const std::vector<std::shared_ptr<xUnitpp::xUnitTest>> &tests)
+    {
+        testCount += tests.size();
+
+        for (size_t i = 0; i != tests.size(); ++i)
+        {
+            queues[i % queues.size()]->tests.push_back(tests[i]);
+        }
+    }
+
+    bool Pop(size_t worker, std::shared_ptr<xUnitpp::xUnitTest> &test)
+    {
+        {
+            auto &own = *queues[worker];
+            std::lock_guard<std::mutex> guard(own.lock);
+
+            if (!own.tests.empty())
+            {
+                test = own.tests.front();
+                own.tests.pop_front();
+                return true;
+            }
+        }
+
+        for (size_t i = 1; i != queues.size(); ++i)
+        {
+            auto &victim = *queues[(worker + i) % queues.size()];
+            std::lock_guard<std::mutex> guard(victim.lock);
+
+            if (!victim.tests.empty())
+            {
+                test = victim.tests.back();
+                victim.tests.pop_back();
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    // drops every test not yet started, returning how many there were
+    size_t Clear()
+    {
+        size_t cleared = 0;
+
+        for (auto &queue : queues)
+        {
+            std::lock_guard<std::mutex> guard(queue->lock);
+
+            cleared += queue->tests.size();
+            queue->tests.clear();
+        }
+
+        return cleared;
+    }
+
+    size_t size() const
+    {
+        return testCount;
+    }
+
+private:
+    TestScheduler(const TestScheduler &);
+    TestScheduler &operator =(TestScheduler);
+
+private:
+    std::vector<std::unique_ptr<WorkQueue>> queues;
+    size_t testCount;
+};
+
+//
+// A thread stuck in a timed out test is abandoned, and may still be running long after RunTests has returned.
+// Once a test has started, everything that thread touches lives here, and is kept alive by the thread itself.
+struct RunningTest
 {
+    enum State
+    {
+        Running,
+        Finished,
+        TimedOut
+    };
+
+    RunningTest(const std::shared_ptr<xUnitpp::xUnitTest> &test, SharedOutput &output, xUnitpp::Time::Duration timeLimit, size_t worker)
+        : test(test)
+        , output(output)
+        , timeLimit(timeLimit)
+        , started(xUnitpp::Time::Clock::now())
+        , worker(worker)
+        , state(Running)
+    {
+    }
+
+    // only one of Finish and TimeOut will ever succeed for any given test
+    bool Finish()
+    {
+        int running = Running;
+        return state.compare_exchange_strong(running, Finished);
+    }
+
+    bool TimeOut()
+    {
+        int running = Running;
+        return state.compare_exchange_strong(running, TimedOut);
+    }
+
+    std::shared_ptr<xUnitpp::xUnitTest> test;
+    AttachedOutput output;
+    xUnitpp::Time::Duration timeLimit;
+    xUnitpp::Time::TimeStamp started;
+    size_t worker;
+    std::atomic<int> state;
+
+private:
+    RunningTest(const RunningTest &) /* = delete */;
+    RunningTest &operator =(RunningTest) /* = delete */;
+};
 
-int RunTests(IOutput &output, TestFilterCallback filter, const std::vector<std::shared_ptr<xUnitTest>> &tests, Time::Duration maxTestRunTime, size_t maxConcurrent)
+//
+// A single thread keeps a heap of the deadlines of all running timed tests, rather than parking a second thread next to each one.
+// Tests that finish in time are left in the heap, and simply skipped when their deadline comes up.
+class Watchdog
 {
-    auto timeStart = Time::Clock::now();
+    typedef std::pair<xUnitpp::Time::TimeStamp, std::shared_ptr<RunningTest>> Deadline;
 
-    if (maxConcurrent == 0)
+    struct Later
+    {
+        bool operator ()(const Deadline &a, const Deadline &b) const
+        {
+            return a.first > b.first;
+        }
+    };
+
+public:
+    Watchdog(std::function<void(const std::shared_ptr<RunningTest> &)> onTimeout)
+        : onTimeout(onTimeout)
+        , stopping(false)
+    {
+    }
+
+    ~Watchdog()
+    {
+        Stop();
+    }
+
+    void Watch(const std::shared_ptr<RunningTest> &run)
+    {
+        std::lock_guard<std::mutex> guard(lock);
+
+        // runs without any timed tests never need the extra thread
+        if (!thread.joinable())
+        {
+            thread = std::thread([this]() { Run(); });
+        }
+
+        deadlines.push(std::make_pair(run->started + run->timeLimit, run));
+
+        if (deadlines.top().second == run)
+        {
+            wake.notify_one();
+        }
+    }
+
+    void Stop()
     {
-        maxConcurrent = std::numeric_limits<decltype(maxConcurrent)>::max();
+        {
+            std::lock_guard<std::mutex> guard(lock);
+            stopping = true;
+        }
+
+        wake.notify_one();
+
+        if (thread.joinable())
+        {
+            thread.join();
+        }
     }
 
-    class ThreadCounter
+private:
+    Watchdog(const Watchdog &) /* = delete */;
+    Watchdog &operator =(Watchdog) /* = delete */;
+
+    void Run()
     {
-    public:
-        ThreadCounter(size_t maxThreads)
-            : maxThreads(maxThreads)
-            , activeThreads(0)
+        std::unique_lock<std::mutex> guard(lock);
+
+        while (!stopping)
         {
+            if (deadlines.empty())
+            {
+                wake.wait(guard);
+            }
+            else if (xUnitpp::Time::Clock::now() < deadlines.top().first)
+            {
+                // copied: the heap may change while we wait
+                auto deadline = deadlines.top().first;
+                wake.wait_until(guard, deadline);
+            }
+            else
+            {
+                auto run = deadlines.top().second;
+                deadlines.pop();
+
+                if (run->TimeOut())
+                {
+                    guard.unlock();
+                    onTimeout(run);
+                    guard.lock();
+                }
+            }
         }
+    }
+
+private:
+    std::function<void(const std::shared_ptr<RunningTest> &)> onTimeout;
+    std::priority_queue<Deadline, std::vector<Deadline>, Later> deadlines;
+    std::mutex lock;
+    std::condition_variable wake;
+    bool stopping;
+    std::thread thread;
+};
 
-        void operator++()
+//
+// A test's share of an IThreadBudget, given back when the test is done with it.
+class BudgetSlot
+{
+public:
+    BudgetSlot(xUnitpp::IThreadBudget *budget)
+        : budget(budget)
+    {
+        if (budget != nullptr)
         {
-            std::unique_lock<std::mutex> lock(mtx);
-            condition.wait(lock, [&]() { return activeThreads < maxThreads; });
+            budget->Acquire();
+        }
+    }
 
-            ++activeThreads;
+    ~BudgetSlot()
+    {
+        if (budget != nullptr)
+        {
+            budget->Release();
         }
+    }
+
+    // for when someone else has already given the slot back
+    void Abandon()
+    {
+        budget = nullptr;
+    }
+
+private:
+    BudgetSlot(const BudgetSlot &) /* = delete */;
+    BudgetSlot &operator =(BudgetSlot) /* = delete */;
+
+private:
+    xUnitpp::IThreadBudget *budget;
+};
+
+xUnitpp::Time::Duration TimeLimit(const xUnitpp::xUnitTest &test, xUnitpp::Time::Duration maxTestRunTime)
+{
+    auto testTimeLimit = test.TestDetails().TimeLimit;
+    if (testTimeLimit < xUnitpp::Time::Duration::zero())
+    {
+        testTimeLimit = maxTestRunTime;
+    }
+
+    return testTimeLimit;
+}
+
+//
+// Runs a test on the calling thread. Returns false when the watchdog gave up on the test before it returned:
+// the watchdog has already reported the failure and replaced the calling thread, which must now leave without touching anything else.
+bool RunTest(const std::shared_ptr<RunningTest> &run, Watchdog &watchdog, std::atomic<int> &failedTests)
+{
+    auto &test = *run->test;
+
+    test.Cancellation().Reset();
+    run->output.ReportStart(test.TestDetails());
+
+    //
+    // note that forcing a test to run in under a certain amount of time is inherently fragile
+    // there's no guarantee that a thread, once started, actually gets `maxTestRunTime` nanoseconds of CPU
+    if (run->timeLimit > xUnitpp::Time::Duration::zero())
+    {
+        watchdog.Watch(run);
+    }
+
+    auto result = test.Run();
+
+    if (!run->Finish())
+    {
+        // if the test run is still going, the rest of this test's output is reported after the time limit failure
+        try
+        {
+            for (auto &event : test.TestEvents())
+            {
+                run->output.ReportEvent(test.TestDetails(), event);
+            }
+
+            if (!test.Metrics().empty())
+            {
+                run->output.ReportMetrics(test.TestDetails(), test.Metrics());
+            }
+
+            run->output.ReportFinish(test.TestDetails(), test.Duration());
+        }
+        catch (...)
+        {
+            // nobody is left to hear about it
+        }
+
+        return false;
+    }
+
+    for (auto &event : test.TestEvents())
+    {
+        run->output.ReportEvent(test.TestDetails(), event);
+    }
+
+    if (!test.Metrics().empty())
+    {
+        run->output.ReportMetrics(test.TestDetails(), test.Metrics());
+    }
+
+    run->output.ReportFinish(test.TestDetails(), test.Duration());
+
+    if (result == xUnitpp::TestResult::Failure)
+    {
+        ++failedTests;
+    }
+
+    return true;
+}
+
+long long CostAttribute(const xUnitpp::TestDetails &testDetails)
+{
+    auto range = testDetails.Attributes.find(xUnitpp::AttributeCollection::Attribute("Cost", ""));
+
+    if (range.first != range.second)
+    {
+        std::istringstream stream(range.first->second);
+
+        long long ms;
+        if (stream >> ms && ms >= 0)
+        {
+            return xUnitpp::Time::ToDuration(std::chrono::milliseconds(ms)).count();
+        }
+    }
+
+    return -1;
+}
 
-        void operator--()
+//
+// Longest-processing-time-first: starting the slowest tests first keeps a handful of long tests
+// from being picked up last and dragging out the end of the run.
+void OrderByExpectedDuration(std::vector<std::shared_ptr<xUnitpp::xUnitTest>> &tests, const xUnitpp::TestDurationCallback &expectedDuration)
+{
+    std::vector<std::pair<long long, std::shared_ptr<xUnitpp::xUnitTest>>> costs;
+    costs.reserve(tests.size());
+
+    for (const auto &test : tests)
+    {
+        auto cost = expectedDuration(test->TestDetails());
+
+        if (cost < 0)
         {
-            --activeThreads;
-            condition.notify_one();
+            cost = CostAttribute(test->TestDetails());
         }
 
-    private:
-        size_t maxThreads;
-        std::atomic<size_t> activeThreads;
-        std::mutex mtx;
-        std::condition_variable condition;
-    } threadCounter(maxConcurrent);
+        costs.push_back(std::make_pair(std::max(cost, 0LL), test));
+    }
+
+    std::stable_sort(costs.begin(), costs.end(),
+        [](const std::pair<long long, std::shared_ptr<xUnitpp::xUnitTest>> &a, const std::pair<long long, std::shared_ptr<xUnitpp::xUnitTest>> &b)
+        {
+            return a.first > b.first;
+        });
+
+    for (size_t i = 0; i != tests.size(); ++i)
+    {
+        tests[i] = costs[i].second;
+    }
+}
+
+size_t WorkerCount(size_t maxConcurrent, size_t testCount)
+{
+    // a limit of 0 means "as many as the machine can actually run at once"
+    if (maxConcurrent == 0)
+    {
+        maxConcurrent = std::max(std::thread::hardware_concurrency(), 1U);
+    }
+
+    return std::min(maxConcurrent, testCount);
+}
+
+}
+
+namespace xUnitpp
+{
+
+int RunTests(IOutput &output, TestFilterCallback filter, const std::vector<std::shared_ptr<xUnitTest>> &tests, Time::Duration maxTestRunTime, size_t maxConcurrent,
+             TestDurationCallback expectedDuration, IThreadBudget *budget)
+{
+    auto timeStart = Time::Clock::now();
 
     std::atomic<int> failedTests(0);
     int skippedTests = 0;
@@ -188,121 +748,178 @@ int RunTests(IOutput &output, TestFilterCallback filter, const std::vector<std::
 
     std::random_shuffle(activeTests.begin(), activeTests.end());
 
-    std::vector<std::future<void>> futures;
+    std::vector<std::shared_ptr<xUnitTest>> runnableTests;
     for (auto &test : activeTests)
     {
         if (test->TestDetails().Attributes.Skipped().first)
         {
             skippedTests++;
             sharedOutput.ReportSkip(test->TestDetails(), test->TestDetails().Attributes.Skipped().second);
-            continue;
         }
+        else
+        {
+            runnableTests.push_back(test);
+        }
+    }
+
+    auto workerCount = WorkerCount(maxConcurrent, runnableTests.size());
+    TestScheduler scheduler(workerCount);
 
-        futures.push_back(std::async([&]()
+    if (expectedDuration)
+    {
+        OrderByExpectedDuration(runnableTests, expectedDuration);
+        scheduler.SeedInOrder(runnableTests);
+    }
+    else
+    {
+        scheduler.SeedBySuite(runnableTests);
+    }
+
+    std::mutex errorLock;
+    std::exception_ptr error;
+
+    auto recordError = [&]()
+        {
+            std::lock_guard<std::mutex> guard(errorLock);
+
+            if (!error)
             {
-                struct CounterGuard
-                {
-                    CounterGuard(ThreadCounter &tc)
-                        : tc(tc)
-                    {
-                        ++tc;
-                    }
+                error = std::current_exception();
+            }
+        };
 
-                    ~CounterGuard()
-                    {
-                        --tc;
-                    }
+    std::atomic<size_t> remainingTests(scheduler.size());
+    std::mutex doneLock;
+    std::condition_variable done;
 
-                private:
-                    CounterGuard &operator =(const CounterGuard &) { throw std::logic_error("not supported"); }
-                    ThreadCounter &tc;
-                } counterGuard(threadCounter);
-
-                //
-                // We are deliberately not capturing any values by reference, since the thread running this lambda may be detached
-                // and abandoned by a timed test. If that were to happen, variables on the stack would get destroyed out from underneath us.
-                // Instead, we're going to make copies that are guaranteed to outlive our method, and return the test status.
-                // If the running thread is still valid, it can manage updating the count of failed threads if necessary.
-                auto actualTest = [](std::shared_ptr<xUnitTest> runningTest, std::shared_ptr<AttachedOutput> output) -> TestResult
-                    {
-                        output->ReportStart(runningTest->TestDetails());
+    auto testsDone = [&](size_t count)
+        {
+            if ((remainingTests -= count) == 0)
+            {
+                std::lock_guard<std::mutex> guard(doneLock);
+                done.notify_all();
+            }
+        };
 
-                        auto result = runningTest->Run();
+    //
+    // Tests are pulled from the scheduler by a fixed set of worker threads, and run on those threads whether they are timed or not.
+    // When a test runs out of time, its worker is abandoned to it and a replacement worker takes over its queue.
+    std::mutex workersLock;
+    std::vector<std::thread> workers(workerCount);
+    std::vector<std::shared_ptr<RunningTest>> abandonedTests;
 
-                        for (auto &event : runningTest->TestEvents())
-                        {
-                            output->ReportEvent(runningTest->TestDetails(), event);
-                        }
+    std::function<void(size_t)> work;
 
-                        return result;
-                    };
+    Watchdog watchdog([&](const std::shared_ptr<RunningTest> &run)
+        {
+            ++failedTests;
+            run->test->Cancellation().Cancel();
 
-                auto testTimeLimit = test->TestDetails().TimeLimit;
-                if (testTimeLimit < Time::Duration::zero())
-                {
-                    testTimeLimit = maxTestRunTime;
-                }
+            // the abandoned thread keeps running, but no longer counts against the budget
+            if (budget != nullptr)
+            {
+                budget->Release();
+            }
 
-                if (testTimeLimit > Time::Duration::zero())
-                {
-                    //
-                    // note that forcing a test to run in under a certain amount of time is inherently fragile
-                    // there's no guarantee that a thread, once started, actually gets `maxTestRunTime` nanoseconds of CPU
+            try
+            {
+                run->output.ReportEvent(run->test->TestDetails(), TestEvent(EventLevel::Fatal, "Test failed to complete within " + ToString(Time::ToMilliseconds(run->timeLimit).count()) + " milliseconds."));
+            }
+            catch (...)
+            {
+                recordError();
+            }
 
-                    auto m = std::make_shared<std::mutex>();
-                    std::unique_lock<std::mutex> gate(*m);
+            {
+                std::lock_guard<std::mutex> guard(workersLock);
 
-                    auto attachedOutput = std::make_shared<AttachedOutput>(sharedOutput);
-                    auto threadStarted = std::make_shared<std::condition_variable>();
-                    auto testResult = std::make_shared<TestResult>();
-                    std::thread timedRunner([=]()
-                        {
-                            m->lock();
-                            m->unlock();
+                abandonedTests.push_back(run);
 
-                            *testResult = actualTest(test, attachedOutput);
+                workers[run->worker].detach();
+                workers[run->worker] = std::thread(work, run->worker);
+            }
 
-                            threadStarted->notify_all();
-                        });
-                    timedRunner.detach();
+            testsDone(1);
+        });
 
-                    if (threadStarted->wait_for(gate, std::chrono::duration_cast<std::chrono::nanoseconds>(testTimeLimit)) == std::cv_status::timeout)
-                    {
-                        attachedOutput->Detach();
-                        sharedOutput.ReportEvent(test->TestDetails(), TestEvent(EventLevel::Fatal, "Test failed to complete within " + ToString(Time::ToMilliseconds(testTimeLimit).count()) + " milliseconds."));
-                        sharedOutput.ReportFinish(test->TestDetails(), testTimeLimit);
-                        ++failedTests;
-                    }
-                    else
-                    {
-                        sharedOutput.ReportFinish(test->TestDetails(), test->Duration());
+    work = [&](size_t worker)
+        {
+            std::shared_ptr<xUnitTest> test;
+            while (scheduler.Pop(worker, test))
+            {
+                BudgetSlot slot(budget);
 
-                        if (*testResult == TestResult::Failure)
-                        {
-                            ++failedTests;
-                        }
+                auto run = std::make_shared<RunningTest>(test, sharedOutput, TimeLimit(*test, maxTestRunTime), worker);
+
+                try
+                {
+                    if (!RunTest(run, watchdog, failedTests))
+                    {
+                        // the watchdog gave the slot back when it gave up on the test
+                        slot.Abandon();
+                        return;
                     }
                 }
-                else
+                catch (...)
                 {
-                    auto result = actualTest(test, std::make_shared<AttachedOutput>(sharedOutput));
-
-                    sharedOutput.ReportFinish(test->TestDetails(), test->Duration());
-
-                    if (result == TestResult::Failure)
+                    if (!run->Finish())
                     {
-                        ++failedTests;
+                        // the watchdog already gave up on the test and counted it as done; the run may be over
+                        // by now, so an abandoned thread mustn't touch any of it
+                        slot.Abandon();
+                        return;
                     }
+
+                    // any exception escaping a test run stops the run
+                    // and is handed back to the caller once everything has stopped
+                    recordError();
+                    testsDone(scheduler.Clear());
                 }
-            }));
+
+                testsDone(1);
+            }
+        };
+
+    {
+        std::lock_guard<std::mutex> guard(workersLock);
+
+        for (size_t i = 0; i != workerCount; ++i)
+        {
+            workers[i] = std::thread(work, i);
+        }
+    }
+
+    {
+        std::unique_lock<std::mutex> guard(doneLock);
+        done.wait(guard, [&]() { return remainingTests == 0; });
+    }
+
+    // every test has now either finished or been abandoned, so the workers can no longer be replaced underneath us
+    watchdog.Stop();
+
+    for (auto &worker : workers)
+    {
+        worker.join();
+    }
+
+    for (auto &run : abandonedTests)
+    {
+        run->output.Detach();
+
+        if (!run->output.HasFinished())
+        {
+            sharedOutput.ReportEvent(run->test->TestDetails(), TestEvent(EventLevel::Warning, "Test was still running when the test run completed. Its thread has been abandoned."));
+            sharedOutput.ReportFinish(run->test->TestDetails(), Time::ToDuration(Time::Clock::now() - run->started));
+        }
     }
 
-    for (auto &test : futures)
+    if (error)
     {
-        test.get();
+        std::rethrow_exception(error);
     }
 
-    sharedOutput.ReportAllTestsComplete((int)futures.size(), skippedTests, failedTests, Time::ToDuration(Time::Clock::now() - timeStart));
+    sharedOutput.Flush();
+    sharedOutput.ReportAllTestsComplete(scheduler.size(), skippedTests, failedTests, Time::ToDuration(Time::Clock::now() - timeStart));
 
     return failedTests;
 }
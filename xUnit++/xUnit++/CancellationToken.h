@@ -0,0 +1,38 @@
+#ifndef CANCELLATIONTOKEN_H_
+#define CANCELLATIONTOKEN_H_
+
+#include <atomic>
+
+namespace xUnitpp
+{
+
+//
+// Set by the test runner once a test has run past its time limit.
+// Long running tests can poll it and return early, rather than being left to run unobserved.
+class CancellationToken
+{
+public:
+    CancellationToken();
+
+    void Cancel();
+    void Reset();
+    bool IsCancellationRequested() const;
+
+    // the token of the test running on the calling thread
+    // outside of a running test, this is a token that is never cancelled
+    static const CancellationToken &Current();
+
+    void Tie() const;
+    void Untie() const;
+
+private:
+    CancellationToken(const CancellationToken &) /* = delete */;
+    CancellationToken &operator =(const CancellationToken &) /* = delete */;
+
+private:
+    std::atomic<bool> cancelled;
+};
+
+}
+
+#endif
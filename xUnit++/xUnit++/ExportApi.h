@@ -1,6 +1,7 @@
 #ifndef EXPORTAPI_H_
 #define EXPORTAPI_H_
 
+#include <cstddef>
 #include <functional>
 #include <memory>
 #include <vector>
@@ -11,14 +12,63 @@
 
 namespace xUnitpp
 {
+    struct IAllocationCounter;
     struct IOutput;
     struct ITestDetails;
+    struct IThreadBudget;
 
     typedef std::function<void(const ITestDetails &)> EnumerateTestDetailsCallback;
     typedef void(*EnumerateTestDetails)(EnumerateTestDetailsCallback callback);
 
     typedef std::function<bool(const ITestDetails &)> TestFilterCallback;
     typedef int(*FilteredTestsRunner)(int, int, IOutput &, TestFilterCallback);
+
+    // expected run time of a test in nanoseconds, or a negative value if there is no estimate
+    typedef std::function<long long(const ITestDetails &)> TestDurationCallback;
+    typedef int(*OrderedTestsRunner)(int, int, IOutput &, TestFilterCallback, TestDurationCallback);
+
+    // tests run after this are charged for the allocations made on their thread
+    typedef void(*SetAllocationCounter)(IAllocationCounter *);
+
+    // once set, the runners take a share of the budget for each test they run, on top of their own thread limit
+    typedef void(*SetThreadBudget)(IThreadBudget *);
+
+    //
+    // Every test in a library, as plain tables that can be read without a call per test or per field.
+    // Strings are offsets into one block of nul-terminated strings; offset 0 is always the empty string.
+    // A test's attributes are consecutive in the attribute table, sorted by key.
+    // The catalog belongs to the library, and lives as long as the library stays loaded.
+    struct TestCatalogAttribute
+    {
+        unsigned int key;
+        unsigned int value;
+    };
+
+    struct TestCatalogEntry
+    {
+        int id;
+        int testInstance;
+        unsigned int name;
+        unsigned int fullName;
+        unsigned int suite;
+        unsigned int params;
+        unsigned int file;
+        int line;
+        unsigned int firstAttribute;
+        unsigned int attributeCount;
+    };
+
+    struct TestCatalog
+    {
+        const TestCatalogEntry *tests;
+        size_t testCount;
+        const TestCatalogAttribute *attributes;
+        size_t attributeCount;
+        const char *strings;
+        size_t stringsSize;
+    };
+
+    typedef const TestCatalog *(*GetTestCatalog)();
 }
 
 #endif
@@ -0,0 +1,39 @@
+#ifndef IALLOCATIONCOUNTER_H_
+#define IALLOCATIONCOUNTER_H_
+
+// !!!VS remove the #if/#endif when VS can compile this code
+#if defined(_MSC_VER)
+# define DEFAULT {}
+#else
+# define DEFAULT = default;
+#endif
+
+namespace xUnitpp
+{
+
+// running totals for one thread
+struct AllocationTotals
+{
+    long long allocations;
+    long long allocatedBytes;
+    long long frees;
+    long long freedBytes;
+    long long peakLiveBytes;    // the most allocatedBytes - freedBytes has been since the last call to ResetPeak
+};
+
+//
+// Implemented by whatever hooks the process' allocator (the console, when asked to),
+// and handed to the test library so each test can be charged for the allocations made on its thread.
+struct IAllocationCounter
+{
+protected:
+    virtual ~IAllocationCounter() DEFAULT
+
+public:
+    virtual void __stdcall GetThreadTotals(AllocationTotals &totals) const = 0;
+    virtual void __stdcall ResetPeak() = 0;
+};
+
+}
+
+#endif
@@ -0,0 +1,34 @@
+#ifndef IBENCHMARKRESULT_H_
+#define IBENCHMARKRESULT_H_
+
+// !!!VS remove the #if/#endif when VS can compile this code
+#if defined(_MSC_VER)
+# define DEFAULT {}
+#else
+# define DEFAULT = default;
+#endif
+
+#include <cstddef>
+
+namespace xUnitpp
+{
+
+// all times are in nanoseconds per call of the benchmark body
+struct IBenchmarkResult
+{
+protected:
+    virtual ~IBenchmarkResult() DEFAULT
+
+public:
+    virtual long long __stdcall GetIterations() const = 0;     // calls per sample
+    virtual size_t __stdcall GetSampleCount() const = 0;
+    virtual double __stdcall GetSample(size_t index) const = 0;
+    virtual double __stdcall GetMean() const = 0;
+    virtual double __stdcall GetStandardDeviation() const = 0;
+    virtual double __stdcall GetMin() const = 0;
+    virtual double __stdcall GetMax() const = 0;
+};
+
+}
+
+#endif
@@ -14,8 +14,10 @@
 namespace xUnitpp
 {
 
+struct IBenchmarkResult;
 struct ITestDetails;
 struct ITestEvent;
+struct ITestMetrics;
 
 struct IOutput
 {
@@ -26,6 +28,16 @@ struct IOutput
     virtual void __stdcall ReportSkip(const ITestDetails &testDetails, const char *reason) = 0;
     virtual void __stdcall ReportFinish(const ITestDetails &testDetails, long long ns) = 0;
     virtual void __stdcall ReportAllTestsComplete(size_t testCount, size_t skipped, size_t failed, long long nsTotal) = 0;
+
+    // sent in place of ReportEvent for the result of a BENCHMARK; reporters with no use for them can leave this alone
+    virtual void __stdcall ReportBenchmark(const ITestDetails &, const IBenchmarkResult &)
+    {
+    }
+
+    // sent before ReportFinish when anything was measured while the test ran
+    virtual void __stdcall ReportMetrics(const ITestDetails &, const ITestMetrics &)
+    {
+    }
 };
 
 }
@@ -0,0 +1,31 @@
+#ifndef ITESTMETRICS_H_
+#define ITESTMETRICS_H_
+
+// !!!VS remove the #if/#endif when VS can compile this code
+#if defined(_MSC_VER)
+# define DEFAULT {}
+#else
+# define DEFAULT = default;
+#endif
+
+#include <cstddef>
+
+namespace xUnitpp
+{
+
+//
+// Named measurements taken while a test ran, such as how much it allocated.
+struct ITestMetrics
+{
+protected:
+    virtual ~ITestMetrics() DEFAULT
+
+public:
+    virtual size_t __stdcall GetCount() const = 0;
+    virtual const char * __stdcall GetName(size_t index) const = 0;
+    virtual long long __stdcall GetValue(size_t index) const = 0;
+};
+
+}
+
+#endif
@@ -0,0 +1,30 @@
+#ifndef ITHREADBUDGET_H_
+#define ITHREADBUDGET_H_
+
+// !!!VS remove the #if/#endif when VS can compile this code
+#if defined(_MSC_VER)
+# define DEFAULT {}
+#else
+# define DEFAULT = default;
+#endif
+
+namespace xUnitpp
+{
+
+//
+// Implemented by a runner that has more than one test library going at once, and handed to each of them,
+// so that between them they never run more tests at a time than the budget allows.
+struct IThreadBudget
+{
+protected:
+    virtual ~IThreadBudget() DEFAULT
+
+public:
+    // blocks until a test may start
+    virtual void __stdcall Acquire() = 0;
+    virtual void __stdcall Release() = 0;
+};
+
+}
+
+#endif
@@ -6,7 +6,10 @@
 #include <map>
 #include <memory>
 #include <deque>
+#include <mutex>
 #include <vector>
+#include "ExportApi.h"
+#include "TestDescriptor.h"
 #include "xUnitTest.h"
 #include "xUnitToString.h"
 
@@ -86,20 +89,20 @@ public:
 
         // !!!VS something else that can be simplified once VS understands variadic macros...
         template<typename TArg0>
-        std::string GetTheoryParams(const std::deque<std::string> &params, std::tuple<TArg0> &&t) const
+        static std::string GetTheoryParams(const std::deque<std::string> &params, std::tuple<TArg0> &&t)
         {
             return "(" + params[0] + ": " + ToString(std::get<0>(std::forward<std::tuple<TArg0>>(t))) + ")";
         }
 
         template<typename TArg0, typename TArg1>
-        std::string GetTheoryParams(const std::deque<std::string> &params, std::tuple<TArg0, TArg1> &&t) const
+        static std::string GetTheoryParams(const std::deque<std::string> &params, std::tuple<TArg0, TArg1> &&t)
         {
             return "(" + params[0] + ": " + ToString(std::get<0>(std::forward<std::tuple<TArg0, TArg1>>(t))) + ", " +
                 params[1] + ": " + ToString(std::get<1>(std::forward<std::tuple<TArg0, TArg1>>(t))) + ")";
         }
 
         template<typename TArg0, typename TArg1, typename TArg2>
-        std::string GetTheoryParams(const std::deque<std::string> &params, std::tuple<TArg0, TArg1, TArg2> &&t) const
+        static std::string GetTheoryParams(const std::deque<std::string> &params, std::tuple<TArg0, TArg1, TArg2> &&t)
         {
             return "(" + params[0] + ": " + ToString(std::get<0>(std::forward<std::tuple<TArg0, TArg1, TArg2>>(t))) + ", " +
                 params[1] + ": " + ToString(std::get<1>(std::forward<std::tuple<TArg0, TArg1, TArg2>>(t))) + ", " +
@@ -107,7 +110,7 @@ public:
         }
 
         template<typename TArg0, typename TArg1, typename TArg2, typename TArg3>
-        std::string GetTheoryParams(const std::deque<std::string> &params, std::tuple<TArg0, TArg1, TArg2, TArg3> &&t) const
+        static std::string GetTheoryParams(const std::deque<std::string> &params, std::tuple<TArg0, TArg1, TArg2, TArg3> &&t)
         {
             return "(" + params[0] + ": " + ToString(std::get<0>(std::forward<std::tuple<TArg0, TArg1, TArg2, TArg3>>(t))) + ", " +
                 params[1] + ": " + ToString(std::get<1>(std::forward<std::tuple<TArg0, TArg1, TArg2, TArg3>>(t))) + ", " +
@@ -116,7 +119,7 @@ public:
         }
 
         template<typename TArg0, typename TArg1, typename TArg2, typename TArg3, typename TArg4>
-        std::string GetTheoryParams(const std::deque<std::string> &params, std::tuple<TArg0, TArg1, TArg2, TArg3, TArg4> &&t) const
+        static std::string GetTheoryParams(const std::deque<std::string> &params, std::tuple<TArg0, TArg1, TArg2, TArg3, TArg4> &&t)
         {
             return "(" + params[0] + ": " + ToString(std::get<0>(std::forward<std::tuple<TArg0, TArg1, TArg2, TArg3, TArg4>>(t))) + ", " +
                 params[1] + ": " + ToString(std::get<1>(std::forward<std::tuple<TArg0, TArg1, TArg2, TArg3, TArg4>>(t))) + ", " +
@@ -125,20 +128,17 @@ public:
                 params[4] + ": " + ToString(std::get<4>(std::forward<std::tuple<TArg0, TArg1, TArg2, TArg3, TArg4>>(t))) + ")";
         }
 
-    public:
-        Register(TestCollection &collection, std::function<void()> &&fn, std::string &&name, const std::string &suite,
-            AttributeCollection &&attributes, int milliseconds, std::string &&filename, int line, std::vector<std::shared_ptr<TestEventRecorder>> &&testEventRecorders);
-
         template<typename TTheory, typename TTheoryData>
-        Register(TestCollection &collection, TTheory &&theory, TTheoryData &&theoryData, std::string &&name, const std::string &suite, std::string &&params,
-            const AttributeCollection &attributes, int milliseconds, std::string &&filename, int line, const std::vector<std::shared_ptr<TestEventRecorder>> &testEventRecorders)
+        static void AddTheory(std::vector<std::shared_ptr<xUnitTest>> &tests, TTheory &&theory, TTheoryData &&theoryData, std::string &&name, const std::string &suite,
+            std::string &&params, const AttributeCollection &attributes, int milliseconds, std::string &&filename, int line,
+            const std::vector<std::shared_ptr<TestEventRecorder>> &testEventRecorders)
         {
             int id = 0;
             for (auto t : theoryData())
             {
                 auto fullParams = GetTheoryParams(SplitParams(std::string(params)), std::forward<decltype(t)>(t));
 
-                collection.mTests.push_back(
+                tests.push_back(
                     std::make_shared<xUnitTest>(
                         TheoryHelper(std::forward<TTheory>(theory), std::move(t)),
                         std::string(name),
@@ -153,14 +153,70 @@ public:
                     );
             }
         }
+
+    public:
+        Register(TestCollection &collection, std::function<void()> &&fn, std::string &&name, const std::string &suite,
+            AttributeCollection &&attributes, int milliseconds, std::string &&filename, int line, std::vector<std::shared_ptr<TestEventRecorder>> &&testEventRecorders);
+
+        template<typename TTheory, typename TTheoryData>
+        Register(TestCollection &collection, TTheory &&theory, TTheoryData &&theoryData, std::string &&name, const std::string &suite, std::string &&params,
+            const AttributeCollection &attributes, int milliseconds, std::string &&filename, int line, const std::vector<std::shared_ptr<TestEventRecorder>> &testEventRecorders)
+        {
+            AddTheory(collection.mTests, std::forward<TTheory>(theory), std::forward<TTheoryData>(theoryData), std::move(name), suite, std::move(params),
+                attributes, milliseconds, std::move(filename), line, testEventRecorders);
+        }
+
+        // builds every row of a theory from its descriptor
+        template<typename TTheory, typename TTheoryData>
+        static void Theory(std::vector<std::shared_ptr<xUnitTest>> &tests, TTheory &&theory, TTheoryData &&theoryData, const TestDescriptor &descriptor)
+        {
+            AddTheory(tests, std::forward<TTheory>(theory), std::forward<TTheoryData>(theoryData), std::string(descriptor.name), descriptor.suite(),
+                std::string(descriptor.params), descriptor.attributes(), descriptor.milliseconds, std::string(descriptor.file), descriptor.line,
+                std::vector<std::shared_ptr<TestEventRecorder>>(descriptor.eventRecorders, descriptor.eventRecorders + 3));
+        }
     };
 
+    TestCollection();
+    ~TestCollection();
+
     static TestCollection &Instance();
 
+    // replaces any earlier descriptors; they are kept, not copied, and nothing is built from them until it is needed
+    void Describe(const TestDescriptor *const *begin, const TestDescriptor *const *end);
+
+    // the details of every test, building only theories: the details of a theory's rows depend on its data
+    void EnumerateTestDetails(const EnumerateTestDetailsCallback &callback);
+
+    // every test that might pass the filter, building only those that do
+    std::vector<std::shared_ptr<xUnitTest>> FilteredTests(const TestFilterCallback &filter);
+
+    // every test, building any that haven't been yet
     const std::vector<std::shared_ptr<xUnitTest>> &Tests();
 
+    // the details of every test as flat tables, made once, the first time they are asked for
+    const TestCatalog &Catalog();
+
+private:
+    TestCollection(const TestCollection &) /* = delete */;
+    TestCollection &operator =(TestCollection) /* = delete */;
+
+    class DescribedTest;
+    const std::vector<std::shared_ptr<xUnitTest>> &Build(DescribedTest &described);
+
+    // EnumerateTestDetails, for callers already holding mBuildLock
+    void Enumerate(const EnumerateTestDetailsCallback &callback);
+
 private:
     std::vector<std::shared_ptr<xUnitTest>> mTests;
+
+    std::unique_ptr<DescribedTest[]> mDescribed;
+    size_t mDescribedCount;
+    std::vector<std::shared_ptr<xUnitTest>> mAllTests;
+    bool mAllBuilt;
+    std::mutex mBuildLock;
+
+    class CatalogData;
+    std::unique_ptr<CatalogData> mCatalog;
 };
 
 }
@@ -0,0 +1,51 @@
+#ifndef TESTDESCRIPTOR_H_
+#define TESTDESCRIPTOR_H_
+
+#include <memory>
+#include <string>
+#include <vector>
+#include "Attributes.h"
+
+namespace xUnitpp
+{
+
+class Check;
+class Log;
+class TestEventRecorder;
+class Warn;
+class xUnitTest;
+
+//
+// Everything the test macros know about a test, as constant data: no code runs to create one.
+// Where the toolchain supports it, the macros gather a pointer to each descriptor into the xunitpp_tests section,
+// and TestCollection only builds a test from its descriptor once that test is wanted.
+struct TestDescriptor
+{
+    const char *name;
+    const char *params;                             // theories only
+    const std::string &(*suite)();
+    AttributeCollection (*attributes)();
+    int milliseconds;
+    const char *file;
+    int line;
+
+    // where the test's Check, Warn and Log events go
+    const std::shared_ptr<TestEventRecorder> *eventRecorders;
+
+    // facts and benchmarks have a test to run; theories instead add a test for each row of their data
+    void (*test)();
+    void (*theory)(const TestDescriptor &descriptor, std::vector<std::shared_ptr<xUnitTest>> &tests);
+};
+
+//
+// Check, Warn and Log for tests built from descriptors. A recorder hands each event to the test
+// running on the calling thread, so one set serves every test and nothing is created per test.
+// Pointing a descriptor at these also makes sure the library links in TestCollection's exports.
+extern const std::shared_ptr<TestEventRecorder> SharedEventRecorders[3];
+extern const Check SharedCheck;
+extern const Warn SharedWarn;
+extern const Log SharedLog;
+
+}
+
+#endif
@@ -22,6 +22,9 @@ struct TestDetails : public ITestDetails
         AttributeCollection &&attributes, Time::Duration timeLimit,
         std::string &&filename, int line);
 
+    // the next unused test id, for tests that are described before they are built
+    static int NewId();
+
     // ITestDetails implementation
     virtual int __stdcall GetId() const override;
     virtual const char * __stdcall GetName() const override;
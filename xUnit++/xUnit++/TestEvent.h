@@ -2,6 +2,7 @@
 #define TESTEVENT_H_
 
 #include <exception>
+#include <memory>
 #include <string>
 #include "ITestEvent.h"
 #include "LineInfo.h"
@@ -10,6 +11,7 @@
 namespace xUnitpp
 {
 
+class BenchmarkResult;
 enum class EventLevel;
 
 class TestEvent : public ITestEvent, public ITestAssert
@@ -18,6 +20,7 @@ public:
     TestEvent(EventLevel level, const std::string &message, const LineInfo &lineInfo = xUnitpp::LineInfo());
     TestEvent(EventLevel level, const xUnitAssert &assert);
     TestEvent(const std::exception &e);
+    TestEvent(const BenchmarkResult &benchmark);
 
     // ITestEvent implementation
     virtual bool __stdcall GetIsAssertType() const override;
@@ -41,6 +44,9 @@ public:
 
     const xUnitpp::LineInfo &LineInfo() const;
 
+    // nullptr unless this event carries the result of a benchmark
+    const BenchmarkResult *Benchmark() const;
+
     friend std::string to_string(const TestEvent &event);
 
 private:
@@ -48,6 +54,7 @@ private:
     xUnitAssert assert;
     std::string message;
     xUnitpp::LineInfo lineInfo;
+    std::shared_ptr<const BenchmarkResult> benchmark;
 
     mutable std::string toString;
 };
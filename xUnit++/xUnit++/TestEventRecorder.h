@@ -11,15 +11,21 @@ namespace xUnitpp
 
 class TestEvent;
 
+//
+// Hands each event to the sink tied on the thread that raised it. One recorder can serve every test,
+// so raising an event must not wait on other threads' tests.
 class TestEventRecorder
 {
 public:
     void Tie(std::function<void(TestEvent &&)> sink);
     void operator()(TestEvent &&evt) const;
 
+#if defined(WIN32)
+    // no thread_local before VS2013
 private:
     mutable std::mutex lock;
     mutable std::map<std::thread::id, std::function<void(TestEvent &&)>> sinks;
+#endif
 };
 
 }
@@ -0,0 +1,66 @@
+#ifndef TESTMETRICS_H_
+#define TESTMETRICS_H_
+
+#include <string>
+#include <utility>
+#include <vector>
+#include "ITestMetrics.h"
+
+namespace xUnitpp
+{
+
+struct AllocationTotals;
+struct IAllocationCounter;
+
+//
+// What the calling thread has used so far: CPU time, context switches and page faults.
+// Only Linux can measure a single thread, so elsewhere a snapshot is empty and adds no metrics.
+class ThreadUsage
+{
+public:
+    static ThreadUsage Now();
+
+private:
+    ThreadUsage();
+
+    friend class TestMetrics;
+
+    bool measured;
+    long long cpuNs;
+    long long userNs;
+    long long systemNs;
+    long long voluntaryContextSwitches;
+    long long involuntaryContextSwitches;
+    long long minorPageFaults;
+    long long majorPageFaults;
+};
+
+class TestMetrics : public ITestMetrics
+{
+public:
+    void Add(const std::string &name, long long value);
+
+    // the difference between two snapshots of a thread's allocation totals
+    void AddAllocations(const AllocationTotals &before, const AllocationTotals &after);
+
+    // a test that spent much less CPU time than wall time, or was switched out often, was starved rather than slow
+    void AddThreadUsage(const ThreadUsage &before, const ThreadUsage &after);
+
+    bool empty() const;
+
+    // set once, before any tests run, by a host that counts allocations; nullptr when nobody is counting
+    static void SetAllocationCounter(IAllocationCounter *counter);
+    static IAllocationCounter *GetAllocationCounter();
+
+    // ITestMetrics implementation
+    virtual size_t __stdcall GetCount() const override;
+    virtual const char * __stdcall GetName(size_t index) const override;
+    virtual long long __stdcall GetValue(size_t index) const override;
+
+private:
+    std::vector<std::pair<std::string, long long>> metrics;
+};
+
+}
+
+#endif
@@ -0,0 +1,41 @@
+#ifndef TIMEBUDGET_H_
+#define TIMEBUDGET_H_
+
+#include <string>
+#include <vector>
+#include "xUnitTime.h"
+
+namespace xUnitpp
+{
+
+class xUnitAssert;
+struct LineInfo;
+
+//
+// Collects timings of repeated runs and compares their median against a budget.
+// Sampling stops as soon as the median is settled, so code that is well within its budget is only run
+// as often as it takes to prove it.
+class TimeBudget
+{
+public:
+    TimeBudget(Time::Duration budget, size_t repetitions);
+
+    bool NeedsSample() const;
+    void Add(Time::Duration sample);
+
+    bool Met() const;
+    Time::Duration Median() const;
+
+    // the samples go in Actual, sorted, so a failure shows how spread out the timings were
+    xUnitAssert Failure(std::string &&call, LineInfo &&lineInfo) const;
+
+private:
+    Time::Duration budget;
+    size_t repetitions;
+    size_t within;
+    std::vector<Time::Duration> samples;
+};
+
+}
+
+#endif
@@ -1,6 +1,7 @@
 #ifndef XUNITPP_H_
 #define XUNITPP_H_
 
+#include "CancellationToken.h"
 #include "xUnitAssert.h"
 #include "xUnitMacros.h"
 
@@ -9,6 +9,7 @@
 #endif
 
 #include <algorithm>
+#include <chrono>
 #include <exception>
 #include <functional>
 #include <memory>
@@ -18,6 +19,8 @@
 #include <type_traits>
 #include <vector>
 #include "LineInfo.h"
+#include "TimeBudget.h"
+#include "xUnitTime.h"
 #include "xUnitToString.h"
 
 namespace xUnitpp
@@ -35,6 +38,12 @@ public:
     template<typename T>
     xUnitAssert &AppendUserMessage(T &&value)
     {
+        // created on first use: most asserts never carry a message
+        if (!userMessage)
+        {
+            userMessage = std::make_shared<std::stringstream>();
+        }
+
         *userMessage << ToString(std::forward<T>(value));
         return *this;
     }
@@ -67,26 +76,32 @@ private:
 public:
     xUnitFailure(xUnitAssert &&assert, std::function<void(const xUnitAssert &)> onFailureComplete);
     xUnitFailure(const xUnitFailure &other);
-
-#if !defined(_MSC_VER) // !!!VS remove the #if/#endif when VS can compile this code
-    xUnitFailure(xUnitFailure &&) = default;
-#endif
+    xUnitFailure(xUnitFailure &&other);
 
     ~xUnitFailure() noexcept(false);
 
     static xUnitFailure None();
 
+    // a passing assert throws its message away, so it isn't formatted in the first place
     template<typename T>
     xUnitFailure &operator <<(T &&value)
     {
-        assert.AppendUserMessage(std::forward<T>(value));
+        if (refCount != nullptr)
+        {
+            assert.AppendUserMessage(std::forward<T>(value));
+        }
+
         return *this;
     }
 
     template<typename T>
     xUnitFailure &operator <<(const T &value)
     {
-        assert.AppendUserMessage(value);
+        if (refCount != nullptr)
+        {
+            assert.AppendUserMessage(value);
+        }
+
         return *this;
     }
 
@@ -97,7 +112,7 @@ private:
     std::function<void(const xUnitAssert &)> OnFailureComplete;
 
     xUnitAssert assert;
-    int &refCount;
+    int *refCount;  // nullptr for a success, which holds nothing on the heap
 };
 
 class Assert
@@ -302,6 +317,35 @@ public:
         return OnSuccess();
     }
 
+    // fn is called once to warm up, then timed up to repetitions times; the median run has to fit in the budget
+    template<typename TFunc, typename TRep, typename TPeriod>
+    xUnitFailure CompletesWithin(TFunc &&fn, std::chrono::duration<TRep, TPeriod> budget, size_t repetitions, LineInfo &&lineInfo = LineInfo()) const
+    {
+        TimeBudget timeBudget(Time::ToDuration(budget), repetitions);
+
+        fn();
+
+        while (timeBudget.NeedsSample())
+        {
+            auto start = Time::Clock::now();
+            fn();
+            timeBudget.Add(Time::ToDuration(Time::Clock::now() - start));
+        }
+
+        if (!timeBudget.Met())
+        {
+            return OnFailure(timeBudget.Failure(callPrefix + "CompletesWithin", std::move(lineInfo)));
+        }
+
+        return OnSuccess();
+    }
+
+    template<typename TFunc, typename TRep, typename TPeriod>
+    xUnitFailure CompletesWithin(TFunc &&fn, std::chrono::duration<TRep, TPeriod> budget, LineInfo &&lineInfo = LineInfo()) const
+    {
+        return CompletesWithin(std::forward<TFunc>(fn), budget, 5, std::move(lineInfo));
+    }
+
     xUnitFailure Fail(LineInfo &&lineInfo = LineInfo()) const;
 
     xUnitFailure False(bool b, LineInfo &&lineInfo = LineInfo()) const;
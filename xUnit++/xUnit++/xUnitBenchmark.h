@@ -0,0 +1,50 @@
+#ifndef XUNITBENCHMARK_H_
+#define XUNITBENCHMARK_H_
+
+#include <functional>
+#include <string>
+#include <vector>
+#include "Attributes.h"
+#include "IBenchmarkResult.h"
+
+namespace xUnitpp
+{
+
+class TestEventRecorder;
+
+class BenchmarkResult : public IBenchmarkResult
+{
+public:
+    BenchmarkResult(long long iterations, std::vector<double> &&samples);
+
+    // IBenchmarkResult implementation
+    virtual long long __stdcall GetIterations() const override;
+    virtual size_t __stdcall GetSampleCount() const override;
+    virtual double __stdcall GetSample(size_t index) const override;
+    virtual double __stdcall GetMean() const override;
+    virtual double __stdcall GetStandardDeviation() const override;
+    virtual double __stdcall GetMin() const override;
+    virtual double __stdcall GetMax() const override;
+
+    friend std::string to_string(const BenchmarkResult &result);
+
+private:
+    long long iterations;
+    std::vector<double> samples;
+    double mean;
+    double standardDeviation;
+    double min;
+    double max;
+};
+
+//
+// Calls body over and over: first to warm up and to find how many calls it takes to fill a sample,
+// then for each sample. The result is recorded on recorder as an informational event.
+void RunBenchmark(const std::function<void()> &body, const TestEventRecorder &recorder);
+
+// benchmarks are marked with a "Benchmark" attribute, so runners can leave them out unless asked for them
+AttributeCollection BenchmarkAttributes(AttributeCollection &&attributes);
+
+}
+
+#endif
@@ -9,6 +9,44 @@
 #define XU_UNIQUE_FIXTURE XU_CAT(TestFixture_, __LINE__)
 #define XU_UNIQUE_TEST XU_CAT(TestFn_, __LINE__)
 #define XU_UNIQUE_RUNNER XU_CAT(TestRunner_, __LINE__)
+#define XU_UNIQUE_THEORY XU_CAT(TestTheory_, __LINE__)
+#define XU_UNIQUE_DATA XU_CAT(TestData_, __LINE__)
+#define XU_UNIQUE_ATTRIBUTES XU_CAT(TestAttributes_, __LINE__)
+
+// Where the linker gathers a named section from every object file, each test is a constant TestDescriptor
+// pointed to from the xunitpp_tests section, and nothing of it is built until it is wanted.
+// Elsewhere, or with XU_STATIC_REGISTRATION defined, each test registers itself during static initialization.
+#if defined(__ELF__) && !defined(XU_STATIC_REGISTRATION)
+# define XU_TEST_SECTION
+#endif
+
+#if defined(XU_TEST_SECTION)
+
+#define XU_TEST_EVENTS \
+namespace detail \
+{ \
+    const std::shared_ptr<xUnitpp::TestEventRecorder> *const eventRecorders = xUnitpp::SharedEventRecorders; \
+    const xUnitpp::Check *const pCheck = &xUnitpp::SharedCheck; \
+    const xUnitpp::Warn *const pWarn = &xUnitpp::SharedWarn; \
+    const xUnitpp::Log *const pLog = &xUnitpp::SharedLog; \
+}
+
+#define XU_TEST_DESCRIPTOR(Details, params, AttributesFn, timeout, test, theory) \
+    const xUnitpp::TestDescriptor descriptor = { Details, params, &xUnitSuite::Name, &AttributesFn, timeout, __FILE__, __LINE__, \
+        xUnitpp::SharedEventRecorders, test, theory }; \
+    __attribute__((section("xunitpp_tests"), used)) const xUnitpp::TestDescriptor *const reg = &descriptor;
+
+#define XU_REGISTER_FACT(FactDetails, AttributesFn, timeout) \
+    XU_TEST_DESCRIPTOR(FactDetails, "", AttributesFn, timeout, &XU_UNIQUE_RUNNER, nullptr)
+
+#define XU_REGISTER_THEORY(TheoryDetails, params, DataProvider, timeout) \
+    inline void XU_UNIQUE_THEORY(const xUnitpp::TestDescriptor &descriptor, std::vector<std::shared_ptr<xUnitpp::xUnitTest>> &tests) \
+    { \
+        xUnitpp::TestCollection::Register::Theory(tests, &XU_UNIQUE_TEST, DataProvider, descriptor); \
+    } \
+    XU_TEST_DESCRIPTOR(TheoryDetails, #params, xUnitAttributes::Attributes, timeout, nullptr, &XU_UNIQUE_THEORY)
+
+#else
 
 // !!!VS fix when initializer lists are supported
 #define XU_TEST_EVENTS \
@@ -25,6 +63,18 @@ namespace detail \
 } \
 std::vector<std::shared_ptr<xUnitpp::TestEventRecorder>> eventRecorders(std::begin(detail::eventRecorders), std::end(detail::eventRecorders)); \
 
+#define XU_REGISTER_FACT(FactDetails, AttributesFn, timeout) \
+    xUnitpp::TestCollection::Register reg(xUnitpp::TestCollection::Instance(), \
+        &XU_UNIQUE_RUNNER, std::string(FactDetails), xUnitSuite::Name(), \
+        AttributesFn(), timeout, std::string(__FILE__), __LINE__, std::move(eventRecorders));
+
+#define XU_REGISTER_THEORY(TheoryDetails, params, DataProvider, timeout) \
+    xUnitpp::TestCollection::Register reg(xUnitpp::TestCollection::Instance(), \
+        &XU_UNIQUE_TEST, DataProvider, std::string(TheoryDetails), xUnitSuite::Name(), std::string(#params), \
+        xUnitAttributes::Attributes(), timeout, std::string(__FILE__), __LINE__, eventRecorders);
+
+#endif
+
 // with thanks for various sources, but I got it from
 // http://stackoverflow.com/questions/2308243/macro-returning-the-number-of-arguments-it-is-given-in-c
 
@@ -7,7 +7,9 @@
 #include "Attributes.h"
 #include "LineInfo.h"
 #include "TestCollection.h"
+#include "TestDescriptor.h"
 #include "TestEventRecorder.h"
+#include "xUnitBenchmark.h"
 #include "Suite.h"
 #include "xUnitCheck.h"
 #include "xUnitLog.h"
@@ -77,9 +79,7 @@ namespace xUnitpp { struct NoFixture {}; }
             const xUnitpp::Log &Log; \
         }; \
         void XU_UNIQUE_RUNNER() { XU_UNIQUE_FIXTURE().XU_UNIQUE_TEST(); } \
-        xUnitpp::TestCollection::Register reg(xUnitpp::TestCollection::Instance(), \
-            &XU_UNIQUE_RUNNER, std::string(FactDetails), xUnitSuite::Name(), \
-            xUnitAttributes::Attributes(), timeout, std::string(__FILE__), __LINE__, std::move(eventRecorders)); \
+        XU_REGISTER_FACT(FactDetails, xUnitAttributes::Attributes, timeout) \
     } \
     void XU_UNIQUE_NS :: XU_UNIQUE_FIXTURE :: XU_UNIQUE_TEST()
 
@@ -101,9 +101,7 @@ namespace xUnitpp { struct NoFixture {}; }
         const xUnitpp::Warn &Warn = *detail::pWarn; \
         const xUnitpp::Log &Log = *detail::pLog; \
         void XU_UNIQUE_TEST params; \
-        xUnitpp::TestCollection::Register reg(xUnitpp::TestCollection::Instance(), \
-            &XU_UNIQUE_TEST, DataProvider, std::string(TheoryDetails), xUnitSuite::Name(), std::string(#params), \
-            xUnitAttributes::Attributes(), timeout, std::string(__FILE__), __LINE__, eventRecorders); \
+        XU_REGISTER_THEORY(TheoryDetails, params, DataProvider, timeout) \
     } \
     void XU_UNIQUE_NS :: XU_UNIQUE_TEST params
 
@@ -119,10 +117,12 @@ namespace xUnitpp { struct NoFixture {}; }
         const xUnitpp::Warn &Warn = *detail::pWarn; \
         const xUnitpp::Log &Log = *detail::pLog; \
         void XU_UNIQUE_TEST params; \
-        decltype(CAR(__VA_ARGS__)) args[] = { __VA_ARGS__ }; \
-        xUnitpp::TestCollection::Register reg(xUnitpp::TestCollection::Instance(), \
-            &XU_UNIQUE_TEST, xUnitpp::TheoryData(PP_NARGS(__VA_ARGS__), args), std::string(TheoryDetails), \
-            xUnitSuite::Name(), std::string(#params), xUnitAttributes::Attributes(), timeout, std::string(__FILE__), __LINE__, eventRecorders); \
+        inline std::function<std::vector<decltype(CAR(__VA_ARGS__))>()> XU_UNIQUE_DATA() \
+        { \
+            decltype(CAR(__VA_ARGS__)) args[] = { __VA_ARGS__ }; \
+            return xUnitpp::TheoryData(PP_NARGS(__VA_ARGS__), args); \
+        } \
+        XU_REGISTER_THEORY(TheoryDetails, params, XU_UNIQUE_DATA(), timeout) \
     } \
     void XU_UNIQUE_NS :: XU_UNIQUE_TEST params
 
@@ -130,6 +130,41 @@ namespace xUnitpp { struct NoFixture {}; }
 
 #define THEORY(TheoryDetails, params, ...) TIMED_THEORY(TheoryDetails, params, -1, __VA_ARGS__)
 
+//
+// A benchmark's body is a single operation: it is called over and over, and the time per call is reported.
+// Benchmarks are untimed, and each is given a "Benchmark" attribute so runners can leave them out by default.
+// A fixture is constructed once, before the first call.
+#define BENCHMARK_FIXTURE(BenchmarkDetails, FixtureType) \
+    namespace XU_UNIQUE_NS { \
+        using xUnitpp::Assert; \
+        XU_TEST_EVENTS \
+        class XU_UNIQUE_FIXTURE : public FixtureType \
+        { \
+            /* !!!VS fix when '= delete' is supported */ \
+            XU_UNIQUE_FIXTURE &operator =(XU_UNIQUE_FIXTURE) /* = delete */; \
+        public: \
+            XU_UNIQUE_FIXTURE() \
+                : Check(*detail::pCheck) \
+                , Warn(*detail::pWarn) \
+                , Log(*detail::pLog) \
+                { } \
+            void XU_UNIQUE_TEST(); \
+            const xUnitpp::Check &Check; \
+            const xUnitpp::Warn &Warn; \
+            const xUnitpp::Log &Log; \
+        }; \
+        void XU_UNIQUE_RUNNER() \
+        { \
+            XU_UNIQUE_FIXTURE fixture; \
+            xUnitpp::RunBenchmark([&]() { fixture.XU_UNIQUE_TEST(); }, *detail::eventRecorders[2]); \
+        } \
+        inline xUnitpp::AttributeCollection XU_UNIQUE_ATTRIBUTES() { return xUnitpp::BenchmarkAttributes(xUnitAttributes::Attributes()); } \
+        XU_REGISTER_FACT(BenchmarkDetails, XU_UNIQUE_ATTRIBUTES, 0) \
+    } \
+    void XU_UNIQUE_NS :: XU_UNIQUE_FIXTURE :: XU_UNIQUE_TEST()
+
+#define BENCHMARK(BenchmarkDetails) BENCHMARK_FIXTURE(BenchmarkDetails, xUnitpp::NoFixture)
+
 #define LI xUnitpp::LineInfo(std::string(__FILE__), __LINE__)
 
 #endif
\ No newline at end of file
@@ -6,8 +6,10 @@
 #include <mutex>
 #include <string>
 #include <vector>
+#include "CancellationToken.h"
 #include "TestDetails.h"
 #include "TestEvent.h"
+#include "TestMetrics.h"
 #include "xUnitTime.h"
 
 namespace xUnitpp
@@ -29,16 +31,26 @@ public:
     xUnitTest(std::function<void()> &&test, std::string &&name, int testInstance, std::string &&params,
         const std::string &suite, AttributeCollection &&attributes, Time::Duration timeLimit,
         std::string &&filename, int line, const std::vector<std::shared_ptr<TestEventRecorder>> &testEventRecorders);
+    xUnitTest(std::function<void()> &&test, xUnitpp::TestDetails &&testDetails,
+        const std::vector<std::shared_ptr<TestEventRecorder>> &testEventRecorders);
 
     const xUnitpp::TestDetails &TestDetails() const;
 
     TestResult Run();
     Time::Duration Duration() const;
 
+    CancellationToken &Cancellation();
+
     void AddEvent(TestEvent &&evt);
     const std::vector<TestEvent> &TestEvents() const;
 
+    // empty unless the host is measuring something
+    const TestMetrics &Metrics() const;
+
 private:
+    void RunOnce();
+    void CheckTimeBudget(Time::Duration budget);
+
     xUnitTest(const xUnitTest &other) /* = delete */;
     xUnitTest(xUnitTest &&other) /* = delete */;
     xUnitTest &operator =(xUnitTest other) /* = delete */;
@@ -52,9 +64,13 @@ private:
 
     std::vector<std::shared_ptr<TestEventRecorder>> testEventRecorders;
 
+    CancellationToken cancellation;
+
     std::mutex eventLock;
     std::vector<TestEvent> testEvents;
     bool failureEventLogged;
+
+    TestMetrics metrics;
 };
 
 }
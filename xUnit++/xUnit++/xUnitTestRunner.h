@@ -13,11 +13,16 @@ namespace xUnitpp
 {
 
 struct IOutput;
+struct IThreadBudget;
 struct TestDetails;
 class xUnitTest;
 
+// When expectedDuration is supplied, tests are started longest-expected-first instead of in random suite order.
+// Tests without an estimate fall back to their "Cost" attribute (in milliseconds), and then to zero.
+// When budget is supplied, each test also waits for a share of it before starting.
 int RunTests(IOutput &output, xUnitpp::TestFilterCallback filter, const std::vector<std::shared_ptr<xUnitTest>> &tests,
-             Time::Duration maxTestRunTime, size_t maxConcurrent);
+             Time::Duration maxTestRunTime, size_t maxConcurrent, xUnitpp::TestDurationCallback expectedDuration = nullptr,
+             IThreadBudget *budget = nullptr);
 
 }
 